@@ -14,6 +14,7 @@ extern "C" {
 #include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdio.h>
 
 #define BITMAP_VISIBILITY_DEFAULT   __attribute__((visibility ("default")))
 #define BITMAP_VISIBILITY_HIDDEN    __attribute__((visibility ("hidden")))
@@ -130,6 +131,20 @@ struct bitmap_version
     const char * hash;      /**< Hash of comit */
     const char * date_time; /**< Date and time of build */
     const char * cflags;    /**< Compiler flags of build */
+    const char * simd;      /**< Kernels of the bulk operations, selected at load time */
+    const char * popcount;  /**< Kernels of the cardinality, selected at load time */
+};
+
+/**
+ * @brief Kernels sets of the bulk operations
+ */
+enum bitmap_simd
+{
+    BITMAP_SIMD__AUTO,      /**< The best set, supported by the CPU */
+    BITMAP_SIMD__SCALAR,    /**< Portable scalar code */
+    BITMAP_SIMD__SSE2,      /**< x86 SSE2 */
+    BITMAP_SIMD__AVX2,      /**< x86 AVX2 */
+    BITMAP_SIMD__AVX512     /**< x86 AVX-512F */
 };
 
 /**
@@ -144,6 +159,17 @@ enum bitmap_relation
     BITMAP_RELATION__DIFFERENT          /**< Bitmaps are different */
 };
 
+/**
+ * @brief The binary operations on bitmaps
+ */
+enum bitmap_operation
+{
+    BITMAP_OPERATION__AND,      /**< a & b, intersection */
+    BITMAP_OPERATION__OR,       /**< a | b, union */
+    BITMAP_OPERATION__CLEAR,    /**< a & ~b, subtraction */
+    BITMAP_OPERATION__XOR       /**< a ^ b, symmetric difference */
+};
+
 /** @brief The range */
 struct bitmap_range
 {
@@ -157,6 +183,17 @@ struct bitmap_range
  */
 const struct bitmap_version * bitmap_version0(void) BITMAP_PUBLIC;
 
+/**
+ * @brief Select the kernels of the bulk operations.
+ * @details The best set is selected at load time, so the function is intended for testing and benchmarking.
+ *          Not thread-safe: call it while no other thread processes bitmaps.
+ * @param simd      The requested set
+ * @return The selected set: the requested one, or the best supported set below it.
+ */
+enum bitmap_simd bitmap_simd_select1(
+        enum bitmap_simd simd
+) BITMAP_PUBLIC;
+
 /**
  * @brief Fill entire bitmap by the value 1
  * @param bitmap      The bitmap
@@ -315,6 +352,16 @@ size_t bitmap_bitwise_power2(
         size_t size
 ) BITMAP_PUBLIC;
 
+/**
+ * @brief Power of the range of bitmap (amount of raised bits)
+ * @param bitmap      The bitmap
+ * @param range       The range, inclusive
+ */
+size_t bitmap_bitwise_range_power2(
+        const bitmap_block_t * bitmap,
+        const struct bitmap_range * range
+) BITMAP_PUBLIC;
+
 /**
  * @brief Power of union and intersection of srcA and srcB
  */
@@ -327,6 +374,73 @@ void bitmap_bitwise_power6(
         size_t * BITMAP_RESTRICT power_union
 ) BITMAP_PUBLIC;
 
+/**
+ * @brief Power of the binary operation result, without the result building
+ * @details The bitmaps can have different sizes, like in bitmap_bitwise_power6():
+ *          the missing bits of the short bitmap are considered to be zero.
+ *          The counting stops as soon as the power reaches the threshold,
+ *          so "is |A & B| >= k?" is `bitmap_bitwise_operation_power6(BITMAP_OPERATION__AND, A, sizeA, B, sizeB, k) >= k`.
+ * @param operation   The operation
+ * @param srcA        The first bitmap
+ * @param sizeA       Amount of bits in the first bitmap
+ * @param srcB        The second bitmap
+ * @param sizeB       Amount of bits in the second bitmap
+ * @param threshold   The threshold, SIZE_MAX to count all
+ * @return The power if it is less than the threshold, otherwise a value not less than the threshold
+ */
+size_t bitmap_bitwise_operation_power6(
+        enum bitmap_operation operation,
+        const bitmap_block_t * BITMAP_RESTRICT srcA,
+        size_t sizeA,
+        const bitmap_block_t * BITMAP_RESTRICT srcB,
+        size_t sizeB,
+        size_t threshold
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Power of intersection of srcA and srcB, |A & B|
+ * @note See bitmap_bitwise_operation_power6()
+ */
+size_t bitmap_bitwise_and_power4(
+        const bitmap_block_t * BITMAP_RESTRICT srcA,
+        size_t sizeA,
+        const bitmap_block_t * BITMAP_RESTRICT srcB,
+        size_t sizeB
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Power of union of srcA and srcB, |A | B|
+ * @note See bitmap_bitwise_operation_power6()
+ */
+size_t bitmap_bitwise_or_power4(
+        const bitmap_block_t * BITMAP_RESTRICT srcA,
+        size_t sizeA,
+        const bitmap_block_t * BITMAP_RESTRICT srcB,
+        size_t sizeB
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Power of subtraction of srcB from srcA, |A & ~B|
+ * @note See bitmap_bitwise_operation_power6()
+ */
+size_t bitmap_bitwise_clear_power4(
+        const bitmap_block_t * BITMAP_RESTRICT srcA,
+        size_t sizeA,
+        const bitmap_block_t * BITMAP_RESTRICT srcB,
+        size_t sizeB
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Power of symmetric difference of srcA and srcB, |A ^ B|
+ * @note See bitmap_bitwise_operation_power6()
+ */
+size_t bitmap_bitwise_xor_power4(
+        const bitmap_block_t * BITMAP_RESTRICT srcA,
+        size_t sizeA,
+        const bitmap_block_t * BITMAP_RESTRICT srcB,
+        size_t sizeB
+) BITMAP_PUBLIC;
+
 /**
  * @brief Check, if all bits of bitmap is zero
  * @param bitmap      The bitmap
@@ -337,6 +451,28 @@ bool bitmap_bitwise_check_zero2(
         size_t bits_num
 ) BITMAP_PUBLIC;
 
+/**
+ * @brief Check, if all bits of the range of bitmap is zero
+ * @param bitmap      The bitmap
+ * @param range       The range, inclusive
+ * @return true, if the range is empty
+ */
+bool bitmap_bitwise_range_check_zero2(
+        const bitmap_block_t * bitmap,
+        const struct bitmap_range * range
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Check, if all bits of the range of bitmap is raised
+ * @param bitmap      The bitmap
+ * @param range       The range, inclusive
+ * @return true, if all bits of the range are raised
+ */
+bool bitmap_bitwise_range_check_full2(
+        const bitmap_block_t * bitmap,
+        const struct bitmap_range * range
+) BITMAP_PUBLIC;
+
 /**
  * @brief Check, if bitmaps are equal
  * @param a           The first bitmap
@@ -441,12 +577,177 @@ void bitmap_bit_nearest_forward_raised_get4(
         bitmap_bit_nearest_get_context_t * bit_nearest
 ) BITMAP_PUBLIC;
 
+/**
+ * @brief Find "forward" the nearest bit, which has value FALSE in a bitmap.
+ * @param bitmap            The bitmap.
+ * @param bits_num          Amount of bits in bitmap.
+ * @param bit_index_from    The bit numer, from which start searching.
+ * @param bit_nearest       The nearest current or next cleared bit.
+ */
+void bitmap_bit_nearest_forward_cleared_get4(
+        const bitmap_block_t *bitmap,
+        size_t bits_num,
+        size_t bit_index_from,
+        bitmap_bit_nearest_get_context_t * bit_nearest
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Find "backward" the nearest bit, which has value TRUE in a bitmap.
+ * @param bitmap            The bitmap.
+ * @param bits_num          Amount of bits in bitmap.
+ * @param bit_index_from    The bit numer, from which start searching. If >= bits_num, the search starts from the last bit.
+ * @param bit_nearest       The nearest current or previous set bit.
+ */
+void bitmap_bit_nearest_backward_raised_get4(
+        const bitmap_block_t *bitmap,
+        size_t bits_num,
+        size_t bit_index_from,
+        bitmap_bit_nearest_get_context_t * bit_nearest
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Find "backward" the nearest bit, which has value FALSE in a bitmap.
+ * @param bitmap            The bitmap.
+ * @param bits_num          Amount of bits in bitmap.
+ * @param bit_index_from    The bit numer, from which start searching. If >= bits_num, the search starts from the last bit.
+ * @param bit_nearest       The nearest current or previous cleared bit.
+ */
+void bitmap_bit_nearest_backward_cleared_get4(
+        const bitmap_block_t *bitmap,
+        size_t bits_num,
+        size_t bit_index_from,
+        bitmap_bit_nearest_get_context_t * bit_nearest
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Find the first bit in the range, which has value TRUE in a bitmap.
+ * @param bitmap            The bitmap.
+ * @param range             The range, inclusive.
+ * @param bit_nearest       The first set bit of the range.
+ */
+void bitmap_bit_range_first_raised_get3(
+        const bitmap_block_t *bitmap,
+        const struct bitmap_range * range,
+        bitmap_bit_nearest_get_context_t * bit_nearest
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Find the last bit, which has value TRUE in a bitmap.
+ * @param bitmap            The bitmap.
+ * @param bits_num          Amount of bits in bitmap.
+ * @param bit_last          The last set bit.
+ */
+static inline void bitmap_bit_last_raised_get3(
+        const bitmap_block_t *bitmap,
+        size_t bits_num,
+        bitmap_bit_nearest_get_context_t * bit_last
+)
+{
+    bitmap_bit_nearest_backward_raised_get4(bitmap, bits_num, SIZE_MAX, bit_last);
+}
+
+/**
+ * @brief Iterator by bits, which has value TRUE in a bitmap.
+ * @details Holds the current block with already visited bits cleared,
+ *          so each step costs one count-trailing-zeros and one lowest bit reset.
+ *          Fields are internal, use the bitmap_iterator_*() functions.
+ */
+typedef struct
+{
+    const bitmap_block_t * bitmap; /**< The bitmap */
+    size_t bits_num;               /**< Amount of bits in bitmap */
+    size_t blocks_num;             /**< Amount of blocks in bitmap */
+    size_t iblock;                 /**< Index of the current block */
+    bitmap_block_t block;          /**< The current block, without visited and insignificant bits */
+} bitmap_iterator_t;
+
+/**
+ * @brief Start the iteration
+ * @param iterator          The iterator.
+ * @param bitmap            The bitmap.
+ * @param bits_num          Amount of bits in bitmap.
+ * @param bit_index_from    The bit numer, from which start iteration.
+ */
+void bitmap_iterator_init4(
+        bitmap_iterator_t * BITMAP_RESTRICT iterator,
+        const bitmap_block_t * BITMAP_RESTRICT bitmap,
+        size_t bits_num,
+        size_t bit_index_from
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Internal function of the iterator: load the next non-zero block.
+ * @param iterator          The iterator, the current block is exhausted.
+ * @return Is the next raised bit exist?
+ */
+bool bitmap_iterator_refill1(
+        bitmap_iterator_t * iterator
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Get the next raised bit
+ * @param iterator          The iterator.
+ * @param bit_index         The place to write the bit index.
+ * @return Is the bit exist? If false, the iteration is finished.
+ */
+static inline bool bitmap_iterator_next2(
+        bitmap_iterator_t * BITMAP_RESTRICT iterator,
+        size_t * BITMAP_RESTRICT bit_index
+)
+{
+    if(iterator->block == 0)
+    {
+        if(!bitmap_iterator_refill1(iterator))
+        {
+            return false;
+        }
+    }
+    (*bit_index) = iterator->iblock * BITMAP_BITS_IN_BLOCK() + (size_t)__builtin_ctzll(iterator->block);
+    /* reset the lowest raised bit */
+    iterator->block &= iterator->block - 1;
+    return true;
+}
+
+/**
+ * @brief Write the indexes of the raised bits into the array
+ * @details The call is resumable: fill the array by chunks until the bitmap is finished.
+ * @note The entries after the returned count, up to indices_num, may be overwritten.
+ * @param indices           The array of the indexes.
+ * @param indices_num       Amount of the indexes in the array.
+ * @param bitmap            The bitmap.
+ * @param bits_num          Amount of bits in bitmap.
+ * @param bit_index_from    In: the bit numer, from which start decoding.
+ *                          Out: the first raised bit, which is not written, or bits_num if the bitmap is finished.
+ * @return Amount of the written indexes.
+ */
+size_t bitmap_to_indices5(
+        size_t * BITMAP_RESTRICT indices,
+        size_t indices_num,
+        const bitmap_block_t * BITMAP_RESTRICT bitmap,
+        size_t bits_num,
+        size_t * BITMAP_RESTRICT bit_index_from
+) BITMAP_PUBLIC;
+
+/**
+ * @brief The same as bitmap_to_indices5(), the indexes are 32-bit
+ * @note bits_num <= 2^32
+ * @note The entries after the returned count, up to indices_num, may be overwritten.
+ */
+size_t bitmap_to_indices32_5(
+        uint32_t * BITMAP_RESTRICT indices,
+        size_t indices_num,
+        const bitmap_block_t * BITMAP_RESTRICT bitmap,
+        size_t bits_num,
+        size_t * BITMAP_RESTRICT bit_index_from
+) BITMAP_PUBLIC;
+
 /**
  * @brief Type to use in BITMAP_FOREACH_BIT_IN_BITMAP
  */
 typedef struct
 {
-    bitmap_bit_nearest_get_context_t bit; /**< Context */
+    bitmap_bit_nearest_get_context_t bit; /**< Context: the current bit */
+    bitmap_iterator_t iterator;           /**< The iterator */
 } bitmap_foreach_bit_context_t;
 
 /**
@@ -458,11 +759,109 @@ typedef struct
  */
 #define BITMAP_FOREACH_BIT_IN_BITMAP(xbit_index, xbitmap, xbits_num, xcontext) \
         for( \
-                bitmap_bit_nearest_forward_raised_get4((xbitmap), (xbits_num), 0                    , &(xcontext)->bit), (*xbit_index) = (xcontext)->bit.index, (xcontext)->bit.index += 1; \
-                ((xcontext)->bit.exist); \
-                bitmap_bit_nearest_forward_raised_get4((xbitmap), (xbits_num), (xcontext)->bit.index, &(xcontext)->bit), (*xbit_index) = (xcontext)->bit.index, (xcontext)->bit.index += 1 \
+                bitmap_iterator_init4(&(xcontext)->iterator, (xbitmap), (xbits_num), 0); \
+                ((xcontext)->bit.exist = bitmap_iterator_next2(&(xcontext)->iterator, &(xcontext)->bit.index)) && \
+                ((*(xbit_index)) = (xcontext)->bit.index, true); \
+        )
+
+/**
+ * @brief Iterator by bits, which has value TRUE in a bitmap, from the last bit to the first.
+ * @param xbit_index      Current bit, which has value TRUE (size_t *).
+ * @param xbitmap         The bitmap (const bitmap_block_t *).
+ * @param xbits_num       Amount of bits in xbitmap (size_t).
+ * @param xcontext        Iterator context (bitmap_foreach_bit_context_t *)
+ */
+#define BITMAP_FOREACH_BIT_IN_BITMAP_REVERSE(xbit_index, xbitmap, xbits_num, xcontext) \
+        for( \
+                bitmap_bit_nearest_backward_raised_get4((xbitmap), (xbits_num), SIZE_MAX, &(xcontext)->bit); \
+                (xcontext)->bit.exist && \
+                ((*(xbit_index)) = (xcontext)->bit.index, true); \
+                (xcontext)->bit.index == 0 ? \
+                        (void)((xcontext)->bit.exist = false) : \
+                        bitmap_bit_nearest_backward_raised_get4((xbitmap), (xbits_num), (xcontext)->bit.index - 1, &(xcontext)->bit) \
         )
 
+/**
+ * @brief Iterator by bits, which has value FALSE in a bitmap.
+ * @param xbit_index      Current bit, which has value FALSE (size_t *).
+ * @param xbitmap         The bitmap (const bitmap_block_t *).
+ * @param xbits_num       Amount of bits in xbitmap (size_t).
+ * @param xcontext        Iterator context (bitmap_foreach_bit_context_t *)
+ */
+#define BITMAP_FOREACH_CLEARED_BIT_IN_BITMAP(xbit_index, xbitmap, xbits_num, xcontext) \
+        for( \
+                bitmap_bit_nearest_forward_cleared_get4((xbitmap), (xbits_num), 0, &(xcontext)->bit); \
+                (xcontext)->bit.exist && \
+                ((*(xbit_index)) = (xcontext)->bit.index, true); \
+                bitmap_bit_nearest_forward_cleared_get4((xbitmap), (xbits_num), (xcontext)->bit.index + 1, &(xcontext)->bit) \
+        )
+
+/**
+ * @brief The sink of the streaming output
+ * @param ctx           Context of the sink.
+ * @param data          The chars, not null-terminated.
+ * @param size          Amount of chars.
+ * @return  0       OK
+ * @return -1       Error, the output is stopped
+ */
+typedef int (*bitmap_sink_t)(void * ctx, const char * data, size_t size);
+
+/**
+ * @brief Print the bitmap by the ranges to the sink
+ * @details The output is passed to the sink by the chunks, the length is not limited.
+ * @param sink          The sink. If NULL, nothing is written: the dry run to get the length.
+ * @param ctx           Context of the sink.
+ * @param bitmap        The source bitmap.
+ * @param bits_num      Amount of bits in source bitmap.
+ * @param enum_marker   Marker of the enumeration: ", ".
+ * @param range_marker  Marker of the range: " - ".
+ * @param length        Amount of chars passed to the output, can be NULL.
+ * @return  0       OK
+ * @return -1       The sink has failed
+ */
+int bitmap_print_ranged7(
+        bitmap_sink_t sink,
+        void * ctx,
+        const bitmap_block_t * BITMAP_RESTRICT bitmap,
+        size_t bits_num,
+        const char * BITMAP_RESTRICT enum_marker,
+        const char * BITMAP_RESTRICT range_marker,
+        size_t * BITMAP_RESTRICT length
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Length of the bitmap printed by the ranges, without the output
+ * @param bitmap        The source bitmap.
+ * @param bits_num      Amount of bits in source bitmap.
+ * @param enum_marker   Marker of the enumeration: ", ".
+ * @param range_marker  Marker of the range: " - ".
+ * @return Amount of chars, except '\0'
+ */
+size_t bitmap_print_ranged_length4(
+        const bitmap_block_t * BITMAP_RESTRICT bitmap,
+        size_t bits_num,
+        const char * BITMAP_RESTRICT enum_marker,
+        const char * BITMAP_RESTRICT range_marker
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Print the bitmap by the ranges to the stream
+ * @param stream        The stream.
+ * @param bitmap        The source bitmap.
+ * @param bits_num      Amount of bits in source bitmap.
+ * @param enum_marker   Marker of the enumeration: ", ".
+ * @param range_marker  Marker of the range: " - ".
+ * @return  0       OK
+ * @return -1       Write error
+ */
+int bitmap_fprint_ranged5(
+        FILE * BITMAP_RESTRICT stream,
+        const bitmap_block_t * BITMAP_RESTRICT bitmap,
+        size_t bits_num,
+        const char * BITMAP_RESTRICT enum_marker,
+        const char * BITMAP_RESTRICT range_marker
+) BITMAP_PUBLIC;
+
 /**
  * @brief Print the bitmap by the ranges
  * @param dest          Destination string.
@@ -500,6 +899,32 @@ int bitmap_sscanf_append_ranged5(
         const char * BITMAP_RESTRICT src
 ) BITMAP_PUBLIC;
 
+/**
+ * @brief Parse the ranges and append raised bits to the bitmap, fast
+ * @details The grammar is the same as of bitmap_sscanf_append_ranged5(), the input is not null-terminated:
+ *          the mapped files can be parsed in place. The digits are found by the SIMD kernels, the ranges
+ *          are raised by the blocks. The ranges before the error stay raised.
+ * @param bitmap        The bitmap.
+ * @param bits_num      Amount of bits in bitmap.
+ * @param enum_marker   Marker of the enumeration: ','.
+ * @param range_marker  Marker of the range: '-'.
+ * @param src           Source chars.
+ * @param size          Amount of chars.
+ * @param error_offset  Offset of the token, which can not be parsed, or `<size>` if the input is incomplete.
+ *                      Can be NULL.
+ * @return  0       OK
+ * @return -1       Syntax error, the index is out of the bitmap, or the range is reversed
+ */
+int bitmap_parse_append_ranged7(
+        bitmap_block_t * BITMAP_RESTRICT bitmap,
+        size_t bits_num,
+        char enum_marker,
+        char range_marker,
+        const char * BITMAP_RESTRICT src,
+        size_t size,
+        size_t * BITMAP_RESTRICT error_offset
+) BITMAP_PUBLIC;
+
 #ifdef __cplusplus
 }
 #endif
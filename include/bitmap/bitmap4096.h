@@ -194,6 +194,26 @@ typedef struct
 #define BITMAP4096_FOREACH_BIT_IN_BITMAP(xbit_index, xbitmap, xcontext) \
          BITMAP_FOREACH_BIT_IN_BITMAP(xbit_index, xbitmap, BITMAP4096_BITS_NUM, &((xcontext)->bit_context))
 
+/**
+ * @brief Iterator by bits, which has value TRUE in a bitmap, from the last bit to the first.
+ *
+ * @param xbit_index      Current bit, which has value TRUE (size_t *).
+ * @param xbitmap         The bitmap (const bitmap_block_t *).
+ * @param xcontext        Iterator context (bitmap4096_foreach_bit_context_t *)
+ */
+#define BITMAP4096_FOREACH_BIT_IN_BITMAP_REVERSE(xbit_index, xbitmap, xcontext) \
+         BITMAP_FOREACH_BIT_IN_BITMAP_REVERSE(xbit_index, xbitmap, BITMAP4096_BITS_NUM, &((xcontext)->bit_context))
+
+/**
+ * @brief Iterator by bits, which has value FALSE in a bitmap.
+ *
+ * @param xbit_index      Current bit, which has value FALSE (size_t *).
+ * @param xbitmap         The bitmap (const bitmap_block_t *).
+ * @param xcontext        Iterator context (bitmap4096_foreach_bit_context_t *)
+ */
+#define BITMAP4096_FOREACH_CLEARED_BIT_IN_BITMAP(xbit_index, xbitmap, xcontext) \
+         BITMAP_FOREACH_CLEARED_BIT_IN_BITMAP(xbit_index, xbitmap, BITMAP4096_BITS_NUM, &((xcontext)->bit_context))
+
 #ifdef __cplusplus
 }
 #endif
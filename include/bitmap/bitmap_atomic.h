@@ -0,0 +1,221 @@
+/**
+ * @file bitmap_atomic.h
+ * @brief Atomic operations on the bits and the blocks of a bitmap
+ * @details Each operation is atomic on one block. The bulk operations are atomic block by block,
+ *          not on the whole bitmap.
+ */
+
+#ifndef INCLUDE_BITMAP_ATOMIC_H_
+#define INCLUDE_BITMAP_ATOMIC_H_
+
+#include <bitmap/bitmap.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Memory order of the atomic operation */
+enum bitmap_memory_order
+{
+    BITMAP_MEMORY_ORDER__RELAXED = __ATOMIC_RELAXED, /**< Atomicity only */
+    BITMAP_MEMORY_ORDER__ACQUIRE = __ATOMIC_ACQUIRE, /**< Later accesses are not moved before */
+    BITMAP_MEMORY_ORDER__RELEASE = __ATOMIC_RELEASE, /**< Earlier accesses are not moved after */
+    BITMAP_MEMORY_ORDER__ACQ_REL = __ATOMIC_ACQ_REL, /**< Acquire and release */
+    BITMAP_MEMORY_ORDER__SEQ_CST = __ATOMIC_SEQ_CST, /**< Single total order */
+};
+
+/** @brief Internal use: the block of the bit */
+#define BITMAP_P_ATOMIC_BLOCK(xbitmap, xbit_index) \
+        (&(xbitmap)[(xbit_index) / BITMAP_BITS_IN_BLOCK()])
+
+/** @brief Internal use: the bit in the block */
+#define BITMAP_P_ATOMIC_BIT(xbit_index) \
+        ((bitmap_block_t)1 << ((xbit_index) % BITMAP_BITS_IN_BLOCK()))
+
+/**
+ * @brief Load the block.
+ * @param bitmap      The bitmap.
+ * @param iblock      The block index.
+ * @param order       BITMAP_MEMORY_ORDER__RELAXED, __ACQUIRE or __SEQ_CST.
+ * @return The block
+ */
+static inline bitmap_block_t bitmap_atomic_block_get3(
+        const bitmap_block_t * bitmap,
+        size_t iblock,
+        enum bitmap_memory_order order
+)
+{
+    return __atomic_load_n(&bitmap[iblock], (int)order);
+}
+
+/**
+ * @brief block |= mask.
+ * @param bitmap      The bitmap.
+ * @param iblock      The block index.
+ * @param mask        The bits to raise.
+ * @param order       The memory order.
+ * @return The block before the operation
+ */
+static inline bitmap_block_t bitmap_atomic_block_or4(
+        bitmap_block_t * bitmap,
+        size_t iblock,
+        bitmap_block_t mask,
+        enum bitmap_memory_order order
+)
+{
+    return __atomic_fetch_or(&bitmap[iblock], mask, (int)order);
+}
+
+/**
+ * @brief block &= ~mask.
+ * @param bitmap      The bitmap.
+ * @param iblock      The block index.
+ * @param mask        The bits to clear.
+ * @param order       The memory order.
+ * @return The block before the operation
+ */
+static inline bitmap_block_t bitmap_atomic_block_clear4(
+        bitmap_block_t * bitmap,
+        size_t iblock,
+        bitmap_block_t mask,
+        enum bitmap_memory_order order
+)
+{
+    return __atomic_fetch_and(&bitmap[iblock], ~mask, (int)order);
+}
+
+/**
+ * @brief Replace the block, if it is equal to the expected one.
+ * @param bitmap      The bitmap.
+ * @param iblock      The block index.
+ * @param expected    In: the expected block. Out: the block, if it is not equal.
+ * @param desired     The new block.
+ * @param order       The memory order of the success, the failure is BITMAP_MEMORY_ORDER__RELAXED.
+ * @return Is the block replaced?
+ */
+static inline bool bitmap_atomic_block_compare_exchange5(
+        bitmap_block_t * BITMAP_RESTRICT bitmap,
+        size_t iblock,
+        bitmap_block_t * BITMAP_RESTRICT expected,
+        bitmap_block_t desired,
+        enum bitmap_memory_order order
+)
+{
+    return __atomic_compare_exchange_n(&bitmap[iblock], expected, desired, false, (int)order, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Gets particular bit.
+ * @param bitmap      The bitmap.
+ * @param bit_index   The bit index in bitmap.
+ * @param order       BITMAP_MEMORY_ORDER__RELAXED, __ACQUIRE or __SEQ_CST.
+ * @return The value of bit
+ */
+static inline bool bitmap_atomic_bit_get3(
+        const bitmap_block_t * bitmap,
+        size_t bit_index,
+        enum bitmap_memory_order order
+)
+{
+    return (__atomic_load_n(BITMAP_P_ATOMIC_BLOCK(bitmap, bit_index), (int)order) & BITMAP_P_ATOMIC_BIT(bit_index)) != 0;
+}
+
+/**
+ * @brief Sets particular bit to 1, returns the previous value.
+ * @param bitmap      The bitmap.
+ * @param bit_index   The bit index in bitmap.
+ * @param order       The memory order.
+ * @return The value of bit before the operation
+ */
+static inline bool bitmap_atomic_bit_test_and_raise3(
+        bitmap_block_t * bitmap,
+        size_t bit_index,
+        enum bitmap_memory_order order
+)
+{
+    bitmap_block_t bit = BITMAP_P_ATOMIC_BIT(bit_index);
+    return (__atomic_fetch_or(BITMAP_P_ATOMIC_BLOCK(bitmap, bit_index), bit, (int)order) & bit) != 0;
+}
+
+/**
+ * @brief Sets particular bit to 0, returns the previous value.
+ * @param bitmap      The bitmap.
+ * @param bit_index   The bit index in bitmap.
+ * @param order       The memory order.
+ * @return The value of bit before the operation
+ */
+static inline bool bitmap_atomic_bit_test_and_clear3(
+        bitmap_block_t * bitmap,
+        size_t bit_index,
+        enum bitmap_memory_order order
+)
+{
+    bitmap_block_t bit = BITMAP_P_ATOMIC_BIT(bit_index);
+    return (__atomic_fetch_and(BITMAP_P_ATOMIC_BLOCK(bitmap, bit_index), ~bit, (int)order) & bit) != 0;
+}
+
+/**
+ * @brief Sets particular bit to 1.
+ * @param bitmap      The bitmap.
+ * @param bit_index   The bit index in bitmap.
+ * @param order       The memory order.
+ */
+static inline void bitmap_atomic_bit_raise3(
+        bitmap_block_t * bitmap,
+        size_t bit_index,
+        enum bitmap_memory_order order
+)
+{
+    __atomic_fetch_or(BITMAP_P_ATOMIC_BLOCK(bitmap, bit_index), BITMAP_P_ATOMIC_BIT(bit_index), (int)order);
+}
+
+/**
+ * @brief Sets particular bit to 0.
+ * @param bitmap      The bitmap.
+ * @param bit_index   The bit index in bitmap.
+ * @param order       The memory order.
+ */
+static inline void bitmap_atomic_bit_clear3(
+        bitmap_block_t * bitmap,
+        size_t bit_index,
+        enum bitmap_memory_order order
+)
+{
+    __atomic_fetch_and(BITMAP_P_ATOMIC_BLOCK(bitmap, bit_index), ~BITMAP_P_ATOMIC_BIT(bit_index), (int)order);
+}
+
+/**
+ * @brief dest = dest | src, atomic by each block of dest
+ * @details The tail bits of dest are not changed.
+ * @param dest        The destination bitmap.
+ * @param src         The source bitmap, it is read without atomicity.
+ * @param bits_num    Amount of bits.
+ * @param order       The memory order.
+ */
+void bitmap_atomic_bitwise_or4(
+        bitmap_block_t * BITMAP_RESTRICT dest,
+        const bitmap_block_t * BITMAP_RESTRICT src,
+        size_t bits_num,
+        enum bitmap_memory_order order
+) BITMAP_PUBLIC;
+
+/**
+ * @brief dest = dest & ~src, atomic by each block of dest
+ * @details The tail bits of dest are not changed.
+ * @param dest        The destination bitmap.
+ * @param src         The source bitmap, it is read without atomicity.
+ * @param bits_num    Amount of bits.
+ * @param order       The memory order.
+ */
+void bitmap_atomic_bitwise_clear4(
+        bitmap_block_t * BITMAP_RESTRICT dest,
+        const bitmap_block_t * BITMAP_RESTRICT src,
+        size_t bits_num,
+        enum bitmap_memory_order order
+) BITMAP_PUBLIC;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_BITMAP_ATOMIC_H_ */
@@ -0,0 +1,139 @@
+/**
+ * @file bitmap_dynamic.h
+ * @brief Bitmap of the size known at run time, with the aligned storage
+ * @details The blocks are allocated at BITMAP_DYNAMIC_ALIGNMENT: the SIMD loads of the bulk operations
+ *          do not cross the cache lines. The capacity grows twice, the resize inside the capacity
+ *          does not allocate. The bits after bits_num are cleared by the resize: the grown bits are cleared.
+ */
+
+#ifndef INCLUDE_BITMAP_DYNAMIC_H_
+#define INCLUDE_BITMAP_DYNAMIC_H_
+
+#include <bitmap/bitmap.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Alignment of the blocks, bytes: the cache line and the AVX-512 vector */
+#define BITMAP_DYNAMIC_ALIGNMENT  64
+
+/**
+ * @brief The dynamic bitmap
+ * @details Fields are internal, use the bitmap_dynamic_*() functions.
+ */
+typedef struct
+{
+    bitmap_block_t * blocks;    /**< The aligned blocks, NULL if the capacity is 0 */
+    size_t bits_num;            /**< Amount of bits in bitmap */
+    size_t blocks_capacity;     /**< Amount of the allocated blocks */
+} bitmap_dynamic_t;
+
+/**
+ * @brief Initialize the empty bitmap, nothing is allocated
+ * @param bitmap        The bitmap.
+ */
+static inline void bitmap_dynamic_init1(
+        bitmap_dynamic_t * bitmap
+)
+{
+    bitmap->blocks = NULL;
+    bitmap->bits_num = 0;
+    bitmap->blocks_capacity = 0;
+}
+
+/**
+ * @brief Create the bitmap, all bits are cleared
+ * @param bitmap        The bitmap.
+ * @param bits_num      Amount of bits in bitmap.
+ * @return  0       OK
+ * @return -1       No memory
+ */
+int bitmap_dynamic_create2(
+        bitmap_dynamic_t * bitmap,
+        size_t bits_num
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Free the bitmap, it becomes empty
+ * @param bitmap        The bitmap.
+ */
+void bitmap_dynamic_destroy1(
+        bitmap_dynamic_t * bitmap
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Amount of bits in bitmap
+ * @param bitmap        The bitmap.
+ */
+static inline size_t bitmap_dynamic_bits_num1(
+        const bitmap_dynamic_t * bitmap
+)
+{
+    return bitmap->bits_num;
+}
+
+/**
+ * @brief Amount of bits in bitmap without the allocation
+ * @param bitmap        The bitmap.
+ */
+static inline size_t bitmap_dynamic_capacity1(
+        const bitmap_dynamic_t * bitmap
+)
+{
+    return BITMAP_BLOCKS_TO_BITS_ALIGNED(bitmap->blocks_capacity);
+}
+
+/**
+ * @brief The blocks for the bitmap_*() functions, bitmap_dynamic_bits_num1() bits
+ * @note The pointer is changed by the allocation: by resize, reserve and shrink.
+ * @param bitmap        The bitmap.
+ */
+static inline bitmap_block_t * bitmap_dynamic_blocks1(
+        bitmap_dynamic_t * bitmap
+)
+{
+    return bitmap->blocks;
+}
+
+/**
+ * @brief Allocate the capacity, the bits are not changed
+ * @param bitmap        The bitmap.
+ * @param bits_num      Amount of bits.
+ * @return  0       OK
+ * @return -1       No memory, the bitmap is not changed
+ */
+int bitmap_dynamic_reserve2(
+        bitmap_dynamic_t * bitmap,
+        size_t bits_num
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Change amount of bits
+ * @details The bits before bits_num are kept, the grown bits are cleared. The capacity grows twice.
+ *          The tail bits of the last block, e.g. raised by bitmap_bitwise_not3(), are cleared.
+ * @param bitmap        The bitmap.
+ * @param bits_num      Amount of bits.
+ * @return  0       OK
+ * @return -1       No memory, the bitmap is not changed
+ */
+int bitmap_dynamic_resize2(
+        bitmap_dynamic_t * bitmap,
+        size_t bits_num
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Free the capacity after bits_num
+ * @param bitmap        The bitmap.
+ * @return  0       OK
+ * @return -1       No memory, the bitmap is not changed
+ */
+int bitmap_dynamic_shrink_to_fit1(
+        bitmap_dynamic_t * bitmap
+) BITMAP_PUBLIC;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_BITMAP_DYNAMIC_H_ */
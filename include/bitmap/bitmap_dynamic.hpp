@@ -0,0 +1,311 @@
+/**
+ * @file bitmap_dynamic.hpp
+ * @brief C++: the owner of the bitmap of the size known at run time
+ * @details Header-only, C++14. Up to inline_bits bits are stored in the object: the small sets are not allocated.
+ *          The bigger bitmap is bitmap_dynamic_t, with the aligned blocks. data() can be passed to the bitmap_*()
+ *          functions. No memory throws std::bad_alloc.
+ */
+
+#ifndef INCLUDE_BITMAP_DYNAMIC_HPP_
+#define INCLUDE_BITMAP_DYNAMIC_HPP_
+
+#ifndef __cplusplus
+#   error "bitmap_dynamic.hpp is the C++ header"
+#endif
+
+#include <bitmap/bitmap.h>
+#include <bitmap/bitmap_dynamic.h>
+#include <bitmap/bitmap_inline.h>
+
+#include <new>
+#include <string.h>
+
+namespace bitmap
+{
+
+/**
+ * @brief The bitmap of bits_num() bits
+ * @note The bits after bits_num() are cleared by resize(), as of bitmap_dynamic_resize2().
+ */
+class dynamic
+{
+public:
+    /** @brief Amount of bits stored in the object */
+    static constexpr size_t inline_bits = 256;
+    /** @brief Amount of blocks stored in the object */
+    static constexpr size_t inline_blocks = inline_bits / (sizeof(bitmap_block_t) * BITMAP_BITS_IN_BYTE());
+
+    /** @brief The empty bitmap */
+    dynamic() noexcept
+        : m_inline{}
+        , m_bits_num(0)
+    {
+        bitmap_dynamic_init1(&m_heap);
+    }
+
+    /** @brief All bits are cleared */
+    explicit dynamic(size_t bits_num)
+        : dynamic()
+    {
+        resize(bits_num);
+    }
+
+    dynamic(const dynamic & other)
+        : dynamic()
+    {
+        P_assign(other);
+    }
+
+    /** @brief The storage is taken, other becomes empty */
+    dynamic(dynamic && other) noexcept
+        : dynamic()
+    {
+        P_take(other);
+    }
+
+    ~dynamic()
+    {
+        bitmap_dynamic_destroy1(&m_heap);
+    }
+
+    dynamic & operator=(const dynamic & other)
+    {
+        if(this != &other)
+        {
+            P_assign(other);
+        }
+        return *this;
+    }
+
+    /** @brief The storage is taken, other becomes empty */
+    dynamic & operator=(dynamic && other) noexcept
+    {
+        if(this != &other)
+        {
+            P_release();
+            P_take(other);
+        }
+        return *this;
+    }
+
+    /** @brief Amount of bits in bitmap */
+    size_t bits_num() const noexcept
+    {
+        return is_inline() ? m_bits_num : bitmap_dynamic_bits_num1(&m_heap);
+    }
+
+    /** @brief Amount of bits without the allocation */
+    size_t capacity() const noexcept
+    {
+        return is_inline() ? inline_bits : bitmap_dynamic_capacity1(&m_heap);
+    }
+
+    /** @brief Are the bits stored in the object? */
+    bool is_inline() const noexcept
+    {
+        return m_heap.blocks == nullptr;
+    }
+
+    /**
+     * @brief The blocks, for the bitmap_*() functions
+     * @note The pointer is changed by resize(), reserve(), shrink_to_fit() and by the move.
+     */
+    bitmap_block_t * data() noexcept
+    {
+        return is_inline() ? m_inline : m_heap.blocks;
+    }
+
+    /** @brief The blocks, for the bitmap_*() functions */
+    const bitmap_block_t * data() const noexcept
+    {
+        return is_inline() ? m_inline : m_heap.blocks;
+    }
+
+    /** @brief Change amount of bits, the grown bits are cleared */
+    void resize(size_t bits_num)
+    {
+        if(is_inline())
+        {
+            if(bits_num <= inline_bits)
+            {
+                P_inline_resize(bits_num);
+                return;
+            }
+            P_to_heap(bits_num);
+        }
+        if(bitmap_dynamic_resize2(&m_heap, bits_num) != 0)
+        {
+            throw std::bad_alloc();
+        }
+    }
+
+    /** @brief Allocate the capacity, the bits are not changed */
+    void reserve(size_t bits_num)
+    {
+        if(is_inline())
+        {
+            if(bits_num <= inline_bits)
+            {
+                return;
+            }
+            P_to_heap(bits_num);
+        }
+        if(bitmap_dynamic_reserve2(&m_heap, bits_num) != 0)
+        {
+            throw std::bad_alloc();
+        }
+    }
+
+    /** @brief Free the unused capacity, the small bitmap is moved into the object */
+    void shrink_to_fit() noexcept
+    {
+        if(is_inline())
+        {
+            return;
+        }
+        size_t bits_num = bitmap_dynamic_bits_num1(&m_heap);
+        if(bits_num > inline_bits)
+        {
+            /* the request is not binding, as of std::vector */
+            (void)bitmap_dynamic_shrink_to_fit1(&m_heap);
+            return;
+        }
+        memcpy(m_inline, m_heap.blocks, BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num) * sizeof(bitmap_block_t));
+        bitmap_dynamic_destroy1(&m_heap);
+        m_bits_num = bits_num;
+    }
+
+    /** @brief Value of the bit, index < bits_num() */
+    bool bit_get(size_t index) const noexcept
+    {
+        return bitmap_inline_bit_get2(data(), index);
+    }
+
+    /** @brief Raise the bit, index < bits_num() */
+    void bit_raise(size_t index) noexcept
+    {
+        bitmap_inline_bit_raise2(data(), index);
+    }
+
+    /** @brief Clear the bit, index < bits_num() */
+    void bit_clear(size_t index) noexcept
+    {
+        bitmap_inline_bit_clear2(data(), index);
+    }
+
+    /** @brief Clear all bits */
+    void clear() noexcept
+    {
+        bitmap_inline_bitwise_clear2(data(), bits_num());
+    }
+
+    /** @brief Amount of raised bits */
+    size_t power() const noexcept
+    {
+        return bitmap_bitwise_power2(data(), bits_num());
+    }
+
+    /** @brief Are all bits cleared? */
+    bool check_zero() const noexcept
+    {
+        return bitmap_bitwise_check_zero2(data(), bits_num());
+    }
+
+    /** @brief Are the sizes and the bits equal? */
+    bool check_equal(const dynamic & other) const noexcept
+    {
+        return bits_num() == other.bits_num() && bitmap_bitwise_check_equal3(data(), other.data(), bits_num());
+    }
+
+private:
+    /** @brief The inline resize: the bits between both sizes are cleared, as of bitmap_dynamic_resize2() */
+    void P_inline_resize(size_t bits_num) noexcept
+    {
+        size_t bits_min = (bits_num < m_bits_num) ? bits_num : m_bits_num;
+        size_t bits_max = (bits_num < m_bits_num) ? m_bits_num : bits_num;
+        size_t iblock = bits_min / BITMAP_BITS_IN_BLOCK();
+        size_t blocks_max = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_max);
+        if(BITMAP_BITS_IN_LASTBLOCK(bits_min) != 0)
+        {
+            m_inline[iblock] &= bitmap_inline_tailblock_mask1(bits_min);
+            ++iblock;
+        }
+        for(; iblock < blocks_max; ++iblock)
+        {
+            m_inline[iblock] = 0;
+        }
+        m_bits_num = bits_num;
+    }
+
+    /** @brief Move the inline bits to the heap of the capacity of bits_capacity bits */
+    void P_to_heap(size_t bits_capacity)
+    {
+        bitmap_dynamic_t heap;
+        bitmap_dynamic_init1(&heap);
+        if(bitmap_dynamic_reserve2(&heap, bits_capacity) != 0 || bitmap_dynamic_resize2(&heap, m_bits_num) != 0)
+        {
+            bitmap_dynamic_destroy1(&heap);
+            throw std::bad_alloc();
+        }
+        memcpy(heap.blocks, m_inline, BITMAP_BITS_TO_BLOCKS_ALIGNED(m_bits_num) * sizeof(bitmap_block_t));
+        m_heap = heap;
+        P_inline_resize(0);
+    }
+
+    /** @brief Copy the bits of other */
+    void P_assign(const dynamic & other)
+    {
+        size_t bits_num = other.bits_num();
+        resize(bits_num);
+        memcpy(data(), other.data(), BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num) * sizeof(bitmap_block_t));
+        /* the tail bits of other are not copied */
+        if(BITMAP_BITS_IN_LASTBLOCK(bits_num) != 0)
+        {
+            data()[bits_num / BITMAP_BITS_IN_BLOCK()] &= bitmap_inline_tailblock_mask1(bits_num);
+        }
+    }
+
+    /** @brief Take the storage of other, this is empty */
+    void P_take(dynamic & other) noexcept
+    {
+        if(other.is_inline())
+        {
+            memcpy(m_inline, other.m_inline, sizeof(m_inline));
+            m_bits_num = other.m_bits_num;
+            other.P_inline_resize(0);
+        }
+        else
+        {
+            m_heap = other.m_heap;
+            bitmap_dynamic_init1(&other.m_heap);
+        }
+    }
+
+    /** @brief Free the storage, this becomes empty */
+    void P_release() noexcept
+    {
+        bitmap_dynamic_destroy1(&m_heap);
+        P_inline_resize(0);
+    }
+
+    bitmap_block_t m_inline[inline_blocks];
+    size_t m_bits_num;          /**< Amount of the inline bits */
+    bitmap_dynamic_t m_heap;    /**< The blocks of the big bitmap, the bits are inline if it is empty */
+};
+
+constexpr size_t dynamic::inline_bits;
+constexpr size_t dynamic::inline_blocks;
+
+inline bool operator==(const dynamic & a, const dynamic & b) noexcept
+{
+    return a.check_equal(b);
+}
+
+inline bool operator!=(const dynamic & a, const dynamic & b) noexcept
+{
+    return !a.check_equal(b);
+}
+
+} /* namespace bitmap */
+
+#endif /* INCLUDE_BITMAP_DYNAMIC_HPP_ */
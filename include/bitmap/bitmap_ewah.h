@@ -0,0 +1,173 @@
+/**
+ * @file bitmap_ewah.h
+ * @brief Word-aligned run-length encoded bitmap (EWAH)
+ * @details The stream of the blocks is the sequence of the groups: the marker block and the literal blocks.
+ *          The marker holds the run of the clean blocks (all bits 0 or all bits 1) and the amount of
+ *          the literal blocks after the run. The operations work on the streams and do not decode them.
+ */
+
+#ifndef INCLUDE_BITMAP_EWAH_H_
+#define INCLUDE_BITMAP_EWAH_H_
+
+#include <bitmap/bitmap.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The encoded bitmap
+ * @details Fields are internal, use the bitmap_ewah_*() functions.
+ */
+typedef struct
+{
+    bitmap_block_t * words;     /**< The stream */
+    size_t words_num;           /**< Amount of the blocks in the stream */
+    size_t words_capacity;      /**< Amount of the allocated blocks */
+    size_t marker;              /**< Index of the last marker */
+    size_t bits_num;            /**< Amount of bits in the decoded bitmap */
+} bitmap_ewah_t;
+
+/**
+ * @brief Initialize the empty bitmap
+ * @param bitmap        The bitmap.
+ */
+void bitmap_ewah_init1(
+        bitmap_ewah_t * bitmap
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Free the bitmap, it becomes empty
+ * @param bitmap        The bitmap.
+ */
+void bitmap_ewah_destroy1(
+        bitmap_ewah_t * bitmap
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Amount of bits in the decoded bitmap
+ * @param bitmap        The bitmap.
+ */
+static inline size_t bitmap_ewah_bits_num1(
+        const bitmap_ewah_t * bitmap
+)
+{
+    return bitmap->bits_num;
+}
+
+/**
+ * @brief Size of the stream
+ * @param bitmap        The bitmap.
+ * @return Amount of the blocks
+ */
+static inline size_t bitmap_ewah_blocks_num1(
+        const bitmap_ewah_t * bitmap
+)
+{
+    return bitmap->words_num;
+}
+
+/**
+ * @brief Encode the bitmap
+ * @param dest          The initialized destination, the content is replaced.
+ * @param src           The source bitmap.
+ * @param bits_num      Amount of bits in the source bitmap.
+ * @return  0       OK
+ * @return -1       No memory, dest is not changed
+ */
+int bitmap_ewah_encode3(
+        bitmap_ewah_t * BITMAP_RESTRICT dest,
+        const bitmap_block_t * BITMAP_RESTRICT src,
+        size_t bits_num
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Decode the bitmap
+ * @param dest          The destination bitmap of bitmap_ewah_bits_num1() bits.
+ * @param src           The source.
+ */
+void bitmap_ewah_decode2(
+        bitmap_block_t * BITMAP_RESTRICT dest,
+        const bitmap_ewah_t * BITMAP_RESTRICT src
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Power of bitmap (amount of raised bits)
+ * @param bitmap        The bitmap.
+ */
+size_t bitmap_ewah_power1(
+        const bitmap_ewah_t * bitmap
+) BITMAP_PUBLIC;
+
+/**
+ * @brief dest = operation(a, b)
+ * @details The shorter bitmap is extended by the cleared bits.
+ * @param dest          The initialized destination, the content is replaced. It can be a or b.
+ * @param operation     The operation.
+ * @param a             The first bitmap.
+ * @param b             The second bitmap.
+ * @return  0       OK
+ * @return -1       No memory, dest is not changed
+ */
+int bitmap_ewah_operation4(
+        bitmap_ewah_t * dest,
+        enum bitmap_operation operation,
+        const bitmap_ewah_t * a,
+        const bitmap_ewah_t * b
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Power of operation(a, b), without the result building
+ * @note See bitmap_ewah_operation4()
+ */
+size_t bitmap_ewah_operation_power3(
+        enum bitmap_operation operation,
+        const bitmap_ewah_t * a,
+        const bitmap_ewah_t * b
+) BITMAP_PUBLIC;
+
+/**
+ * @brief dest = a & b
+ * @note See bitmap_ewah_operation4()
+ */
+int bitmap_ewah_and3(
+        bitmap_ewah_t * dest,
+        const bitmap_ewah_t * a,
+        const bitmap_ewah_t * b
+) BITMAP_PUBLIC;
+
+/**
+ * @brief dest = a | b
+ * @note See bitmap_ewah_operation4()
+ */
+int bitmap_ewah_or3(
+        bitmap_ewah_t * dest,
+        const bitmap_ewah_t * a,
+        const bitmap_ewah_t * b
+) BITMAP_PUBLIC;
+
+/**
+ * @brief dest = a & ~b
+ * @note See bitmap_ewah_operation4()
+ */
+int bitmap_ewah_clear3(
+        bitmap_ewah_t * dest,
+        const bitmap_ewah_t * a,
+        const bitmap_ewah_t * b
+) BITMAP_PUBLIC;
+
+/**
+ * @brief dest = a ^ b
+ * @note See bitmap_ewah_operation4()
+ */
+int bitmap_ewah_xor3(
+        bitmap_ewah_t * dest,
+        const bitmap_ewah_t * a,
+        const bitmap_ewah_t * b
+) BITMAP_PUBLIC;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_BITMAP_EWAH_H_ */
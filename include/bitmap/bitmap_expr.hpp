@@ -0,0 +1,254 @@
+/**
+ * @file bitmap_expr.hpp
+ * @brief C++: the expression templates, the compound expression is evaluated in one pass
+ * @details Header-only, C++14. `dest = (a & b) | (c & ~d)` is the tree of types, the tree is evaluated block by block:
+ *          the sources are read once, only the result is stored, no temporary bitmaps.
+ * @code
+ *          using namespace bitmap::expr;
+ *          assign(dest, bits_num, (wrap(a) & wrap(b)) | (wrap(c) & ~wrap(d)));
+ * @endcode
+ */
+
+#ifndef INCLUDE_BITMAP_EXPR_HPP_
+#define INCLUDE_BITMAP_EXPR_HPP_
+
+#ifndef __cplusplus
+#   error "bitmap_expr.hpp is the C++ header"
+#endif
+
+#include <bitmap/bitmap.h>
+#include <bitmap/bitmap_fixed.hpp>
+
+#include <string.h>
+
+namespace bitmap
+{
+namespace expr
+{
+
+/** @brief Amount of blocks evaluated at once: the stores are after the loads, the loop is vectorized */
+static constexpr size_t chunk_blocks = 8;
+
+/**
+ * @brief Base of the nodes of the expression
+ * @note Each node has `bitmap_block_t block(size_t i) const`, the block `<i>` of its value.
+ */
+template<typename Derived>
+struct base
+{
+    constexpr const Derived & self() const noexcept
+    {
+        return static_cast<const Derived &>(*this);
+    }
+};
+
+/** @brief The bitmap, the leaf of the expression */
+class ref : public base<ref>
+{
+public:
+    explicit constexpr ref(const bitmap_block_t * blocks) noexcept
+        : m_blocks(blocks)
+    {
+    }
+
+    constexpr bitmap_block_t block(size_t i) const noexcept
+    {
+        return m_blocks[i];
+    }
+
+private:
+    const bitmap_block_t * m_blocks;
+};
+
+/** @brief ~e */
+template<typename E>
+class negation : public base<negation<E>>
+{
+public:
+    explicit constexpr negation(const E & e) noexcept
+        : m_e(e)
+    {
+    }
+
+    constexpr bitmap_block_t block(size_t i) const noexcept
+    {
+        return ~m_e.block(i);
+    }
+
+private:
+    E m_e;
+};
+
+/** @brief op(l, r) */
+template<typename Op, typename L, typename R>
+class binary : public base<binary<Op, L, R>>
+{
+public:
+    constexpr binary(const L & l, const R & r) noexcept
+        : m_l(l)
+        , m_r(r)
+    {
+    }
+
+    constexpr bitmap_block_t block(size_t i) const noexcept
+    {
+        return Op::apply(m_l.block(i), m_r.block(i));
+    }
+
+private:
+    L m_l;
+    R m_r;
+};
+
+struct op_and
+{
+    static constexpr bitmap_block_t apply(bitmap_block_t a, bitmap_block_t b) noexcept
+    {
+        return a & b;
+    }
+};
+
+struct op_or
+{
+    static constexpr bitmap_block_t apply(bitmap_block_t a, bitmap_block_t b) noexcept
+    {
+        return a | b;
+    }
+};
+
+struct op_xor
+{
+    static constexpr bitmap_block_t apply(bitmap_block_t a, bitmap_block_t b) noexcept
+    {
+        return a ^ b;
+    }
+};
+
+/** @brief The bitmap in the expression */
+inline constexpr ref wrap(const bitmap_block_t * blocks) noexcept
+{
+    return ref(blocks);
+}
+
+/** @brief The bitmap in the expression */
+template<size_t N>
+constexpr ref wrap(const fixed<N> & bitmap) noexcept
+{
+    return ref(bitmap.data());
+}
+
+template<typename L, typename R>
+constexpr binary<op_and, L, R> operator&(const base<L> & l, const base<R> & r) noexcept
+{
+    return binary<op_and, L, R>(l.self(), r.self());
+}
+
+template<typename L, typename R>
+constexpr binary<op_or, L, R> operator|(const base<L> & l, const base<R> & r) noexcept
+{
+    return binary<op_or, L, R>(l.self(), r.self());
+}
+
+template<typename L, typename R>
+constexpr binary<op_xor, L, R> operator^(const base<L> & l, const base<R> & r) noexcept
+{
+    return binary<op_xor, L, R>(l.self(), r.self());
+}
+
+template<typename E>
+constexpr negation<E> operator~(const base<E> & e) noexcept
+{
+    return negation<E>(e.self());
+}
+
+/**
+ * @brief dest = e, in one pass
+ * @details The chunk is evaluated to the registers before the store: dest can be one of the sources.
+ * @param dest          The destination bitmap.
+ * @param bits_num      Amount of bits in bitmaps.
+ * @param e             The expression.
+ */
+template<typename E>
+void assign(bitmap_block_t * dest, size_t bits_num, const base<E> & e)
+{
+    const E & expr = e.self();
+    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
+    size_t i = 0;
+    for(; i + chunk_blocks <= blocks_num; i += chunk_blocks)
+    {
+        bitmap_block_t chunk[chunk_blocks];
+        for(size_t j = 0; j < chunk_blocks; ++j)
+        {
+            chunk[j] = expr.block(i + j);
+        }
+        memcpy(&dest[i], chunk, sizeof(chunk));
+    }
+    for(; i < blocks_num; ++i)
+    {
+        dest[i] = expr.block(i);
+    }
+}
+
+/** @brief dest = e, in one pass, the trip count is constexpr */
+template<size_t N, typename E>
+void assign(fixed<N> & dest, const base<E> & e)
+{
+    assign(dest.data(), N, e);
+}
+
+/**
+ * @brief Amount of raised bits of the expression, nothing is stored
+ * @param bits_num      Amount of bits in bitmaps.
+ * @param e             The expression.
+ */
+template<typename E>
+size_t power(size_t bits_num, const base<E> & e)
+{
+    const E & expr = e.self();
+    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
+    if(blocks_num == 0)
+    {
+        return 0;
+    }
+    size_t power = 0;
+    size_t i;
+    for(i = 0; i < blocks_num - 1; ++i)
+    {
+        power += (size_t)__builtin_popcountll((unsigned long long)expr.block(i));
+    }
+    size_t tail_bits = bits_num % BITMAP_BITS_IN_BLOCK();
+    bitmap_block_t tail_mask = (tail_bits == 0) ? ~bitmap_block_t(0) : ((bitmap_block_t(1) << tail_bits) - 1);
+    return power + (size_t)__builtin_popcountll((unsigned long long)(expr.block(i) & tail_mask));
+}
+
+/**
+ * @brief Are all bits of the expression cleared? Nothing is stored.
+ * @param bits_num      Amount of bits in bitmaps.
+ * @param e             The expression.
+ */
+template<typename E>
+bool check_zero(size_t bits_num, const base<E> & e)
+{
+    const E & expr = e.self();
+    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
+    if(blocks_num == 0)
+    {
+        return true;
+    }
+    size_t i;
+    for(i = 0; i < blocks_num - 1; ++i)
+    {
+        if(expr.block(i) != 0)
+        {
+            return false;
+        }
+    }
+    size_t tail_bits = bits_num % BITMAP_BITS_IN_BLOCK();
+    bitmap_block_t tail_mask = (tail_bits == 0) ? ~bitmap_block_t(0) : ((bitmap_block_t(1) << tail_bits) - 1);
+    return (expr.block(i) & tail_mask) == 0;
+}
+
+} /* namespace expr */
+} /* namespace bitmap */
+
+#endif /* INCLUDE_BITMAP_EXPR_HPP_ */
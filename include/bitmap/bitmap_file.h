@@ -0,0 +1,154 @@
+/**
+ * @file bitmap_file.h
+ * @brief Memory-mapped bitmap files
+ * @details The file is the header of 64 bytes and the blocks in the byte order of the host.
+ *          The blocks are mapped, not read: the bitmap is ready to use by all bitmap_*() functions
+ *          after the header check, the pages are loaded on the first access.
+ */
+
+#ifndef INCLUDE_BITMAP_FILE_H_
+#define INCLUDE_BITMAP_FILE_H_
+
+#include <bitmap/bitmap.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief The magic of the file */
+#define BITMAP_FILE_MAGIC "BITMAP\x1a\n"
+/** @brief The version of the format */
+#define BITMAP_FILE_VERSION (1)
+/** @brief The endianness marker, it is written in the byte order of the host */
+#define BITMAP_FILE_ENDIANNESS (0x01020304)
+
+/**
+ * @brief The header of the file
+ */
+struct bitmap_file_header
+{
+    char magic[8];          /**< BITMAP_FILE_MAGIC, without '\0' */
+    uint32_t version;       /**< BITMAP_FILE_VERSION */
+    uint32_t block_size;    /**< sizeof(bitmap_block_t) */
+    uint64_t bits_num;      /**< Amount of bits in bitmap */
+    uint32_t endianness;    /**< BITMAP_FILE_ENDIANNESS */
+    uint32_t crc32c;        /**< CRC32C of the blocks */
+    uint8_t reserved[32];   /**< Zeros, the blocks are aligned to 64 bytes */
+};
+
+/** @brief Mode of the opened file */
+enum bitmap_file_mode
+{
+    BITMAP_FILE_MODE__READ,     /**< Read-only mapping, the write to the bitmap is a crash */
+    BITMAP_FILE_MODE__WRITE,    /**< Shared read-write mapping, the changes go to the file */
+};
+
+/**
+ * @brief The mapped file
+ * @details Fields are internal, use the bitmap_file_*() functions.
+ */
+typedef struct
+{
+    int fd;                                 /**< The file */
+    enum bitmap_file_mode mode;             /**< The mode */
+    struct bitmap_file_header * header;     /**< The mapping */
+    size_t size;                            /**< Size of the mapping */
+} bitmap_file_t;
+
+/**
+ * @brief CRC32C (Castagnoli) of the bytes
+ * @param crc           0, or CRC32C of the previous bytes to continue it.
+ * @param data          The bytes.
+ * @param size          Amount of the bytes.
+ * @return CRC32C
+ */
+uint32_t bitmap_crc32c3(
+        uint32_t crc,
+        const void * data,
+        size_t size
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Create the file with the cleared bitmap, open it in BITMAP_FILE_MODE__WRITE mode
+ * @param file          The file.
+ * @param path          The path, the existing file is truncated.
+ * @param bits_num      Amount of bits in bitmap.
+ * @return  0       OK
+ * @return -1       Error, see errno
+ */
+int bitmap_file_create3(
+        bitmap_file_t * BITMAP_RESTRICT file,
+        const char * BITMAP_RESTRICT path,
+        size_t bits_num
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Open and map the file, check the header
+ * @details The CRC is not checked, it takes the read of the whole file, see bitmap_file_check_crc1().
+ * @param file          The file.
+ * @param path          The path.
+ * @param mode          The mode.
+ * @return  0       OK
+ * @return -1       Error, see errno. EINVAL: the header is wrong, or it is made by the other block size or byte order.
+ */
+int bitmap_file_open3(
+        bitmap_file_t * BITMAP_RESTRICT file,
+        const char * BITMAP_RESTRICT path,
+        enum bitmap_file_mode mode
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Update the CRC and write the changes of the bitmap to the file
+ * @param file          The file in BITMAP_FILE_MODE__WRITE mode.
+ * @return  0       OK
+ * @return -1       Error, see errno
+ */
+int bitmap_file_sync1(
+        bitmap_file_t * file
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Unmap and close the file, in BITMAP_FILE_MODE__WRITE mode after bitmap_file_sync1()
+ * @param file          The file.
+ * @return  0       OK
+ * @return -1       Error of bitmap_file_sync1(), the file is closed anyway
+ */
+int bitmap_file_close1(
+        bitmap_file_t * file
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Is the CRC of the blocks equal to the CRC in the header?
+ * @param file          The file.
+ */
+bool bitmap_file_check_crc1(
+        const bitmap_file_t * file
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Amount of bits in bitmap
+ * @param file          The file.
+ */
+static inline size_t bitmap_file_bits_num1(
+        const bitmap_file_t * file
+)
+{
+    return (size_t)file->header->bits_num;
+}
+
+/**
+ * @brief The mapped bitmap, aligned to 64 bytes
+ * @param file          The file.
+ */
+static inline bitmap_block_t * bitmap_file_bitmap1(
+        const bitmap_file_t * file
+)
+{
+    return (bitmap_block_t *)(file->header + 1);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_BITMAP_FILE_H_ */
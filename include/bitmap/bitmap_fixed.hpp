@@ -0,0 +1,272 @@
+/**
+ * @file bitmap_fixed.hpp
+ * @brief C++: the bitmap of the size known at compile time
+ * @details Header-only, C++14. The blocks are the same as of BITMAP_VAR(), data() can be passed to the bitmap_*()
+ *          functions. The sizes, the tail mask and the trip counts are constexpr: the loops of the small bitmaps
+ *          are unrolled and vectorized by the compiler, the library is not called.
+ */
+
+#ifndef INCLUDE_BITMAP_FIXED_HPP_
+#define INCLUDE_BITMAP_FIXED_HPP_
+
+#ifndef __cplusplus
+#   error "bitmap_fixed.hpp is the C++ header"
+#endif
+
+#include <bitmap/bitmap.h>
+
+#include <initializer_list>
+#include <stdexcept>
+
+namespace bitmap
+{
+
+/**
+ * @brief The bitmap of N bits
+ * @note The tail bits of the last block are not significant, as of the bitmap_*() functions.
+ */
+template<size_t N>
+class fixed
+{
+    static_assert(N > 0, "the bitmap is empty");
+
+public:
+    /** @brief Amount of bits in bitmap */
+    static constexpr size_t bits_num = N;
+    /** @brief Amount of bits in one block */
+    static constexpr size_t block_bits = sizeof(bitmap_block_t) * BITMAP_BITS_IN_BYTE();
+    /** @brief Amount of blocks in bitmap */
+    static constexpr size_t blocks_num = (N + block_bits - 1) / block_bits;
+    /** @brief Significant bits of the last block */
+    static constexpr bitmap_block_t tail_mask =
+            (N % block_bits == 0) ? ~bitmap_block_t(0) : ((bitmap_block_t(1) << (N % block_bits)) - 1);
+
+    /** @brief All bits are cleared */
+    constexpr fixed() noexcept
+        : m_blocks{}
+    {
+    }
+
+    /**
+     * @brief The bits of the indices are raised
+     * @note The index out of the bitmap throws std::out_of_range, it is the compile error in the constant expression.
+     */
+    constexpr fixed(std::initializer_list<size_t> indices)
+        : m_blocks{}
+    {
+        for(size_t index : indices)
+        {
+            if(index >= N)
+            {
+                throw std::out_of_range("bitmap::fixed: the index is out of the bitmap");
+            }
+            m_blocks[index / block_bits] |= bitmap_block_t(1) << (index % block_bits);
+        }
+    }
+
+    /** @brief The blocks, for the bitmap_*() functions */
+    constexpr bitmap_block_t * data() noexcept
+    {
+        return m_blocks;
+    }
+
+    /** @brief The blocks, for the bitmap_*() functions */
+    constexpr const bitmap_block_t * data() const noexcept
+    {
+        return m_blocks;
+    }
+
+    /** @brief Value of the bit, index < N */
+    constexpr bool bit_get(size_t index) const noexcept
+    {
+        return (m_blocks[index / block_bits] >> (index % block_bits)) & 1;
+    }
+
+    /** @brief Raise the bit, index < N */
+    constexpr void bit_raise(size_t index) noexcept
+    {
+        m_blocks[index / block_bits] |= bitmap_block_t(1) << (index % block_bits);
+    }
+
+    /** @brief Clear the bit, index < N */
+    constexpr void bit_clear(size_t index) noexcept
+    {
+        m_blocks[index / block_bits] &= ~(bitmap_block_t(1) << (index % block_bits));
+    }
+
+    /** @brief Raise all bits */
+    constexpr void raise() noexcept
+    {
+        for(size_t i = 0; i < blocks_num; ++i)
+        {
+            m_blocks[i] = ~bitmap_block_t(0);
+        }
+    }
+
+    /** @brief Clear all bits */
+    constexpr void clear() noexcept
+    {
+        for(size_t i = 0; i < blocks_num; ++i)
+        {
+            m_blocks[i] = 0;
+        }
+    }
+
+    /** @brief Amount of raised bits */
+    constexpr size_t power() const noexcept
+    {
+        size_t power = 0;
+        for(size_t i = 0; i < blocks_num; ++i)
+        {
+            power += (size_t)__builtin_popcountll((unsigned long long)P_block(i));
+        }
+        return power;
+    }
+
+    /** @brief Are all bits cleared? */
+    constexpr bool check_zero() const noexcept
+    {
+        bitmap_block_t any = 0;
+        for(size_t i = 0; i < blocks_num; ++i)
+        {
+            any |= P_block(i);
+        }
+        return any == 0;
+    }
+
+    /** @brief Are the bitmaps equal? */
+    constexpr bool check_equal(const fixed & other) const noexcept
+    {
+        bitmap_block_t diff = 0;
+        for(size_t i = 0; i < blocks_num; ++i)
+        {
+            diff |= P_block(i) ^ other.P_block(i);
+        }
+        return diff == 0;
+    }
+
+    /** @brief Sets inclusion: are all bits of `<other>` inside this bitmap? */
+    constexpr bool check_inclusion(const fixed & other) const noexcept
+    {
+        bitmap_block_t outside = 0;
+        for(size_t i = 0; i < blocks_num; ++i)
+        {
+            outside |= other.P_block(i) & ~m_blocks[i];
+        }
+        return outside == 0;
+    }
+
+    /** @brief this = this | other */
+    constexpr fixed & operator|=(const fixed & other) noexcept
+    {
+        for(size_t i = 0; i < blocks_num; ++i)
+        {
+            m_blocks[i] |= other.m_blocks[i];
+        }
+        return *this;
+    }
+
+    /** @brief this = this & other */
+    constexpr fixed & operator&=(const fixed & other) noexcept
+    {
+        for(size_t i = 0; i < blocks_num; ++i)
+        {
+            m_blocks[i] &= other.m_blocks[i];
+        }
+        return *this;
+    }
+
+    /** @brief this = this ^ other */
+    constexpr fixed & operator^=(const fixed & other) noexcept
+    {
+        for(size_t i = 0; i < blocks_num; ++i)
+        {
+            m_blocks[i] ^= other.m_blocks[i];
+        }
+        return *this;
+    }
+
+    /** @brief this = this & ~other */
+    constexpr fixed & bitwise_clear(const fixed & other) noexcept
+    {
+        for(size_t i = 0; i < blocks_num; ++i)
+        {
+            m_blocks[i] &= ~other.m_blocks[i];
+        }
+        return *this;
+    }
+
+    /** @brief ~this */
+    constexpr fixed operator~() const noexcept
+    {
+        fixed result;
+        for(size_t i = 0; i < blocks_num; ++i)
+        {
+            result.m_blocks[i] = ~m_blocks[i];
+        }
+        return result;
+    }
+
+    /** @brief Call `func(index)` for each raised bit, from the lowest */
+    template<typename Func>
+    void foreach_bit(Func && func) const
+    {
+        for(size_t i = 0; i < blocks_num; ++i)
+        {
+            bitmap_block_t block = P_block(i);
+            while(block != 0)
+            {
+                func(i * block_bits + (size_t)__builtin_ctzll((unsigned long long)block));
+                block &= block - 1;
+            }
+        }
+    }
+
+private:
+    /** @brief The block, without the tail bits */
+    constexpr bitmap_block_t P_block(size_t i) const noexcept
+    {
+        return (i == blocks_num - 1) ? (m_blocks[i] & tail_mask) : m_blocks[i];
+    }
+
+    bitmap_block_t m_blocks[blocks_num];
+};
+
+template<size_t N> constexpr size_t fixed<N>::bits_num;
+template<size_t N> constexpr size_t fixed<N>::block_bits;
+template<size_t N> constexpr size_t fixed<N>::blocks_num;
+template<size_t N> constexpr bitmap_block_t fixed<N>::tail_mask;
+
+template<size_t N>
+constexpr fixed<N> operator|(fixed<N> a, const fixed<N> & b) noexcept
+{
+    return a |= b;
+}
+
+template<size_t N>
+constexpr fixed<N> operator&(fixed<N> a, const fixed<N> & b) noexcept
+{
+    return a &= b;
+}
+
+template<size_t N>
+constexpr fixed<N> operator^(fixed<N> a, const fixed<N> & b) noexcept
+{
+    return a ^= b;
+}
+
+template<size_t N>
+constexpr bool operator==(const fixed<N> & a, const fixed<N> & b) noexcept
+{
+    return a.check_equal(b);
+}
+
+template<size_t N>
+constexpr bool operator!=(const fixed<N> & a, const fixed<N> & b) noexcept
+{
+    return !a.check_equal(b);
+}
+
+} /* namespace bitmap */
+
+#endif /* INCLUDE_BITMAP_FIXED_HPP_ */
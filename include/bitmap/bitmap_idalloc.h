@@ -0,0 +1,106 @@
+/**
+ * @file bitmap_idalloc.h
+ * @brief Lock-free allocator of the integer IDs
+ * @details The raised bit of the bitmap is the allocated ID. The free bit is taken by the compare-exchange
+ *          of its block. Each level of the summary holds one bit per block of the level below: the block is full,
+ *          as of bitmap_layered.h. The top level is one block. The search from the hint goes up to the level
+ *          with the not full block after the hint and down by one block per level, so the full regions are skipped:
+ *          O(log(ids_num) / log(BITMAP_BITS_IN_BLOCK())) blocks are read, when the allocator is nearly full too.
+ *          The summary is a hint: the search does not trust it before it reports that all IDs are allocated,
+ *          so the allocation from the exhausted allocator scans the whole bitmap.
+ */
+
+#ifndef INCLUDE_BITMAP_IDALLOC_H_
+#define INCLUDE_BITMAP_IDALLOC_H_
+
+#include <bitmap/bitmap.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The allocator
+ * @details Fields are internal, use the bitmap_idalloc_*() functions.
+ */
+typedef struct
+{
+    bitmap_block_t * bitmap;    /**< The allocated IDs, the level 0 */
+    size_t ids_num;             /**< Amount of IDs */
+    size_t blocks_num;          /**< Amount of blocks in the bitmap */
+    size_t levels_num;          /**< Amount of the levels, the bitmap is the level 0 */
+    size_t * sizes;             /**< Amount of bits in the level */
+    bitmap_block_t ** levels;   /**< The levels of the full blocks of the level below */
+} bitmap_idalloc_t;
+
+/**
+ * @brief Create the allocator, all IDs are free
+ * @param alloc         The allocator.
+ * @param ids_num       Amount of IDs, they are [0; ids_num).
+ * @return  0       OK
+ * @return -1       No memory
+ */
+int bitmap_idalloc_create2(
+        bitmap_idalloc_t * alloc,
+        size_t ids_num
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Destroy the allocator
+ * @param alloc         The allocator.
+ */
+void bitmap_idalloc_destroy1(
+        bitmap_idalloc_t * alloc
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Amount of IDs
+ * @param alloc         The allocator.
+ */
+static inline size_t bitmap_idalloc_ids_num1(
+        const bitmap_idalloc_t * alloc
+)
+{
+    return alloc->ids_num;
+}
+
+/**
+ * @brief Allocate the ID, thread-safe
+ * @param alloc         The allocator.
+ * @param hint          The start of the search, it is updated. Keep it per thread, and start the threads
+ *                      from the different IDs (e.g. ithread * ids_num / threads_num) to avoid the contention.
+ * @param id            The allocated ID.
+ * @return  0       OK
+ * @return -1       All IDs are allocated
+ */
+int bitmap_idalloc_alloc3(
+        bitmap_idalloc_t * alloc,
+        size_t * BITMAP_RESTRICT hint,
+        size_t * BITMAP_RESTRICT id
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Free the allocated ID, thread-safe
+ * @param alloc         The allocator.
+ * @param id            The ID.
+ */
+void bitmap_idalloc_free2(
+        bitmap_idalloc_t * alloc,
+        size_t id
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Is the ID allocated?
+ * @param alloc         The allocator.
+ * @param id            The ID.
+ */
+bool bitmap_idalloc_check2(
+        const bitmap_idalloc_t * alloc,
+        size_t id
+) BITMAP_PUBLIC;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_BITMAP_IDALLOC_H_ */
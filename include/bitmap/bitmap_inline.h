@@ -0,0 +1,220 @@
+/**
+ * @file bitmap_inline.h
+ * @brief Inline fast path: the single-bit operations and the bulk operations of the small bitmaps
+ * @details The same operations as of bitmap.h, inlined into the caller: no call through the PLT.
+ *          The bulk operations are the plain loops: if bits_num is known at compile time, the loops are unrolled.
+ *          For the big bitmaps use bitmap.h, its bulk operations have the SIMD kernels.
+ */
+
+#ifndef INCLUDE_BITMAP_INLINE_H_
+#define INCLUDE_BITMAP_INLINE_H_
+
+#include <bitmap/bitmap.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Significant bits of the last block
+ * @param bits_num      Amount of bits in bitmap, > 0.
+ */
+static inline bitmap_block_t bitmap_inline_tailblock_mask1(
+        size_t bits_num
+)
+{
+    size_t tail_bits = bits_num % BITMAP_BITS_IN_BLOCK();
+    return (tail_bits == 0) ? ~(bitmap_block_t)0 : (((bitmap_block_t)1 << tail_bits) - 1);
+}
+
+/**
+ * @brief The same as bitmap_bit_get2()
+ */
+static inline bool bitmap_inline_bit_get2(
+        const bitmap_block_t * bitmap,
+        size_t bit_index
+)
+{
+    return (bitmap[bit_index / BITMAP_BITS_IN_BLOCK()] >> (bit_index % BITMAP_BITS_IN_BLOCK())) & 1;
+}
+
+/**
+ * @brief The same as bitmap_bit_raise2()
+ */
+static inline void bitmap_inline_bit_raise2(
+        bitmap_block_t * bitmap,
+        size_t bit_index
+)
+{
+    bitmap[bit_index / BITMAP_BITS_IN_BLOCK()] |= (bitmap_block_t)1 << (bit_index % BITMAP_BITS_IN_BLOCK());
+}
+
+/**
+ * @brief The same as bitmap_bit_clear2()
+ */
+static inline void bitmap_inline_bit_clear2(
+        bitmap_block_t * bitmap,
+        size_t bit_index
+)
+{
+    bitmap[bit_index / BITMAP_BITS_IN_BLOCK()] &= ~((bitmap_block_t)1 << (bit_index % BITMAP_BITS_IN_BLOCK()));
+}
+
+/**
+ * @brief The same as bitmap_bitwise_clear2()
+ */
+static inline void bitmap_inline_bitwise_clear2(
+        bitmap_block_t * bitmap,
+        size_t bits_num
+)
+{
+    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
+    size_t iblock;
+    for(iblock = 0; iblock < blocks_num; ++iblock)
+    {
+        bitmap[iblock] = 0;
+    }
+}
+
+/**
+ * @brief The same as bitmap_bitwise_copy3()
+ */
+static inline void bitmap_inline_bitwise_copy3(
+        bitmap_block_t * BITMAP_RESTRICT dest,
+        const bitmap_block_t * BITMAP_RESTRICT src,
+        size_t bits_num
+)
+{
+    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
+    size_t iblock;
+    for(iblock = 0; iblock < blocks_num; ++iblock)
+    {
+        dest[iblock] = src[iblock];
+    }
+}
+
+/**
+ * @brief The same as bitmap_bitwise_or3(): dest = dest | src
+ */
+static inline void bitmap_inline_bitwise_or3(
+        bitmap_block_t * BITMAP_RESTRICT dest,
+        const bitmap_block_t * BITMAP_RESTRICT src,
+        size_t bits_num
+)
+{
+    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
+    size_t iblock;
+    for(iblock = 0; iblock < blocks_num; ++iblock)
+    {
+        dest[iblock] |= src[iblock];
+    }
+}
+
+/**
+ * @brief The same as bitmap_bitwise_and3(): dest = dest & src
+ */
+static inline void bitmap_inline_bitwise_and3(
+        bitmap_block_t * BITMAP_RESTRICT dest,
+        const bitmap_block_t * BITMAP_RESTRICT src,
+        size_t bits_num
+)
+{
+    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
+    size_t iblock;
+    for(iblock = 0; iblock < blocks_num; ++iblock)
+    {
+        dest[iblock] &= src[iblock];
+    }
+}
+
+/**
+ * @brief The same as bitmap_bitwise_clear3(): dest = dest & ~src
+ */
+static inline void bitmap_inline_bitwise_clear3(
+        bitmap_block_t * BITMAP_RESTRICT dest,
+        const bitmap_block_t * BITMAP_RESTRICT src,
+        size_t bits_num
+)
+{
+    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
+    size_t iblock;
+    for(iblock = 0; iblock < blocks_num; ++iblock)
+    {
+        dest[iblock] &= ~src[iblock];
+    }
+}
+
+/**
+ * @brief The same as bitmap_bitwise_check_zero2()
+ */
+static inline bool bitmap_inline_bitwise_check_zero2(
+        const bitmap_block_t * bitmap,
+        size_t bits_num
+)
+{
+    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
+    if(blocks_num == 0)
+    {
+        return true;
+    }
+    bitmap_block_t any = bitmap[blocks_num - 1] & bitmap_inline_tailblock_mask1(bits_num);
+    size_t iblock;
+    for(iblock = 0; iblock < blocks_num - 1; ++iblock)
+    {
+        any |= bitmap[iblock];
+    }
+    return any == 0;
+}
+
+/**
+ * @brief The same as bitmap_bitwise_check_equal3()
+ */
+static inline bool bitmap_inline_bitwise_check_equal3(
+        const bitmap_block_t * BITMAP_RESTRICT a,
+        const bitmap_block_t * BITMAP_RESTRICT b,
+        size_t bits_num
+)
+{
+    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
+    if(blocks_num == 0)
+    {
+        return true;
+    }
+    bitmap_block_t diff = (a[blocks_num - 1] ^ b[blocks_num - 1]) & bitmap_inline_tailblock_mask1(bits_num);
+    size_t iblock;
+    for(iblock = 0; iblock < blocks_num - 1; ++iblock)
+    {
+        diff |= a[iblock] ^ b[iblock];
+    }
+    return diff == 0;
+}
+
+/**
+ * @brief The same as bitmap_bitwise_power2()
+ */
+static inline size_t bitmap_inline_bitwise_power2(
+        const bitmap_block_t * bitmap,
+        size_t bits_num
+)
+{
+    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
+    if(blocks_num == 0)
+    {
+        return 0;
+    }
+    size_t power = (size_t)__builtin_popcountll(
+            (unsigned long long)(bitmap[blocks_num - 1] & bitmap_inline_tailblock_mask1(bits_num))
+    );
+    size_t iblock;
+    for(iblock = 0; iblock < blocks_num - 1; ++iblock)
+    {
+        power += (size_t)__builtin_popcountll((unsigned long long)bitmap[iblock]);
+    }
+    return power;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_BITMAP_INLINE_H_ */
@@ -0,0 +1,96 @@
+/**
+ * @file bitmap_kernel.h
+ * @brief The bitmap formats of the Linux kernel
+ * @details The formats of /proc and /sys, the same as "%*pbl" and "%*pb" of the kernel:
+ *          - cpulist: "0-3,8,16-31:2/4", the regions are "a", "a-b" and "a-b:used/group": the first `<used>`
+ *            bits of each group of `<group>` bits from a to b. "N" is the last bit;
+ *          - cpumask: "ff,ffffffff", the 32-bit chunks in hex, the highest chunk first.
+ */
+
+#ifndef INCLUDE_BITMAP_KERNEL_H_
+#define INCLUDE_BITMAP_KERNEL_H_
+
+#include <bitmap/bitmap.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Print the bitmap as the cpulist: "0-3,8"
+ * @details Like snprintf(), the output is cropped and null-terminated, the full length is returned.
+ * @param dest          Destination string. Can be NULL if size is 0.
+ * @param size          Size of destination string.
+ * @param bitmap        The bitmap.
+ * @param bits_num      Amount of bits in bitmap.
+ * @return Length of the cpulist, except '\0'
+ */
+size_t bitmap_cpulist_format4(
+        char * BITMAP_RESTRICT dest,
+        size_t size,
+        const bitmap_block_t * BITMAP_RESTRICT bitmap,
+        size_t bits_num
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Parse the cpulist to the bitmap
+ * @details The bitmap is cleared first. The regions are separated by the commas and the white spaces,
+ *          the input is not null-terminated, '\0' is the end.
+ * @param bitmap        The bitmap.
+ * @param bits_num      Amount of bits in bitmap.
+ * @param src           Source chars.
+ * @param size          Amount of chars.
+ * @param error_offset  Offset of the region, which can not be parsed. Can be NULL.
+ * @return  0       OK
+ * @return -1       Syntax error, the bit is out of the bitmap, or the region is wrong
+ */
+int bitmap_cpulist_parse5(
+        bitmap_block_t * BITMAP_RESTRICT bitmap,
+        size_t bits_num,
+        const char * BITMAP_RESTRICT src,
+        size_t size,
+        size_t * BITMAP_RESTRICT error_offset
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Print the bitmap as the hex mask: "ff,ffffffff"
+ * @details Like snprintf(), the output is cropped and null-terminated, the full length is returned.
+ *          The highest chunk has the digits of the bits it has, the other ones have 8 digits.
+ * @param dest          Destination string. Can be NULL if size is 0.
+ * @param size          Size of destination string.
+ * @param bitmap        The bitmap.
+ * @param bits_num      Amount of bits in bitmap.
+ * @return Length of the mask, except '\0'
+ */
+size_t bitmap_cpumask_format4(
+        char * BITMAP_RESTRICT dest,
+        size_t size,
+        const bitmap_block_t * BITMAP_RESTRICT bitmap,
+        size_t bits_num
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Parse the hex mask to the bitmap
+ * @details The bitmap is cleared first. The chunks have 1 to 8 digits, the white spaces around the mask
+ *          are skipped, the input is not null-terminated, '\0' is the end.
+ * @param bitmap        The bitmap.
+ * @param bits_num      Amount of bits in bitmap.
+ * @param src           Source chars.
+ * @param size          Amount of chars.
+ * @param error_offset  Offset of the chunk, which can not be parsed. Can be NULL.
+ * @return  0       OK
+ * @return -1       Syntax error, or the raised bit is out of the bitmap
+ */
+int bitmap_cpumask_parse5(
+        bitmap_block_t * BITMAP_RESTRICT bitmap,
+        size_t bits_num,
+        const char * BITMAP_RESTRICT src,
+        size_t size,
+        size_t * BITMAP_RESTRICT error_offset
+) BITMAP_PUBLIC;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_BITMAP_KERNEL_H_ */
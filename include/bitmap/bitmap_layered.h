@@ -0,0 +1,175 @@
+/**
+ * @file bitmap_layered.h
+ * @brief Bitmap with the hierarchical summaries
+ * @details Each level of the summary holds one bit per block of the level below: the block is not zero,
+ *          or the block is full. The top level is one block. The search of the nearest raised or cleared bit
+ *          goes up to the level with the found bit and down by one block per level,
+ *          so it reads O(log(bits_num) / log(BITMAP_BITS_IN_BLOCK())) blocks. The changes of the bits update
+ *          the levels up to the first level, where the summary bit does not change.
+ */
+
+#ifndef INCLUDE_BITMAP_LAYERED_H_
+#define INCLUDE_BITMAP_LAYERED_H_
+
+#include <bitmap/bitmap.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The layered bitmap
+ * @details Fields are internal, use the bitmap_layered_*() functions.
+ */
+typedef struct
+{
+    size_t bits_num;            /**< Amount of bits in bitmap */
+    size_t levels_num;          /**< Amount of the levels, the bitmap is the level 0 */
+    size_t * sizes;             /**< Amount of bits in the level */
+    bitmap_block_t ** nonzero;  /**< The levels of the not zero blocks */
+    bitmap_block_t ** full;     /**< The levels of the full blocks */
+} bitmap_layered_t;
+
+/**
+ * @brief Create the bitmap, all bits are cleared
+ * @param layered       The bitmap.
+ * @param bits_num      Amount of bits in bitmap.
+ * @return  0       OK
+ * @return -1       No memory
+ */
+int bitmap_layered_create2(
+        bitmap_layered_t * layered,
+        size_t bits_num
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Destroy the bitmap
+ * @param layered       The bitmap.
+ */
+void bitmap_layered_destroy1(
+        bitmap_layered_t * layered
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Amount of bits in bitmap
+ * @param layered       The bitmap.
+ */
+static inline size_t bitmap_layered_bits_num1(
+        const bitmap_layered_t * layered
+)
+{
+    return layered->bits_num;
+}
+
+/**
+ * @brief The plain bitmap for the reading by the bitmap_*() functions
+ * @param layered       The bitmap.
+ */
+static inline const bitmap_block_t * bitmap_layered_bitmap1(
+        const bitmap_layered_t * layered
+)
+{
+    return layered->nonzero[0];
+}
+
+/**
+ * @brief Copy the plain bitmap of bitmap_layered_bits_num1() bits and rebuild the summaries
+ * @param layered       The bitmap.
+ * @param src           The source bitmap.
+ */
+void bitmap_layered_assign2(
+        bitmap_layered_t * BITMAP_RESTRICT layered,
+        const bitmap_block_t * BITMAP_RESTRICT src
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Gets particular bit.
+ * @param layered       The bitmap.
+ * @param bit_index     The bit index in bitmap.
+ * @return The value of bit
+ */
+static inline bool bitmap_layered_bit_get2(
+        const bitmap_layered_t * layered,
+        size_t bit_index
+)
+{
+    return bitmap_bit_get2(layered->nonzero[0], bit_index);
+}
+
+/**
+ * @brief Sets particular bit to 1.
+ * @param layered       The bitmap.
+ * @param bit_index     The bit index in bitmap.
+ */
+void bitmap_layered_bit_raise2(
+        bitmap_layered_t * layered,
+        size_t bit_index
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Sets particular bit to 0.
+ * @param layered       The bitmap.
+ * @param bit_index     The bit index in bitmap.
+ */
+void bitmap_layered_bit_clear2(
+        bitmap_layered_t * layered,
+        size_t bit_index
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Find "forward" the nearest bit, which has value TRUE.
+ * @param layered           The bitmap.
+ * @param bit_index_from    The bit numer, from which start searching.
+ * @param bit_nearest       The nearest current or next set bit.
+ */
+void bitmap_layered_nearest_forward_raised_get3(
+        const bitmap_layered_t * layered,
+        size_t bit_index_from,
+        bitmap_bit_nearest_get_context_t * bit_nearest
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Find "forward" the nearest bit, which has value FALSE.
+ * @param layered           The bitmap.
+ * @param bit_index_from    The bit numer, from which start searching.
+ * @param bit_nearest       The nearest current or next cleared bit.
+ */
+void bitmap_layered_nearest_forward_cleared_get3(
+        const bitmap_layered_t * layered,
+        size_t bit_index_from,
+        bitmap_bit_nearest_get_context_t * bit_nearest
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Iterator by bits, which has value TRUE in a bitmap.
+ * @param xbit_index      Current bit, which has value TRUE (size_t *).
+ * @param xlayered        The bitmap (const bitmap_layered_t *).
+ * @param xbit_nearest    Iterator context (bitmap_bit_nearest_get_context_t *)
+ */
+#define BITMAP_LAYERED_FOREACH_BIT_IN_BITMAP(xbit_index, xlayered, xbit_nearest) \
+        for( \
+                bitmap_layered_nearest_forward_raised_get3((xlayered), 0, (xbit_nearest)); \
+                (xbit_nearest)->exist && \
+                ((*(xbit_index)) = (xbit_nearest)->index, true); \
+                bitmap_layered_nearest_forward_raised_get3((xlayered), (xbit_nearest)->index + 1, (xbit_nearest)) \
+        )
+
+/**
+ * @brief Iterator by bits, which has value FALSE in a bitmap.
+ * @param xbit_index      Current bit, which has value FALSE (size_t *).
+ * @param xlayered        The bitmap (const bitmap_layered_t *).
+ * @param xbit_nearest    Iterator context (bitmap_bit_nearest_get_context_t *)
+ */
+#define BITMAP_LAYERED_FOREACH_CLEARED_BIT_IN_BITMAP(xbit_index, xlayered, xbit_nearest) \
+        for( \
+                bitmap_layered_nearest_forward_cleared_get3((xlayered), 0, (xbit_nearest)); \
+                (xbit_nearest)->exist && \
+                ((*(xbit_index)) = (xbit_nearest)->index, true); \
+                bitmap_layered_nearest_forward_cleared_get3((xlayered), (xbit_nearest)->index + 1, (xbit_nearest)) \
+        )
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_BITMAP_LAYERED_H_ */
@@ -0,0 +1,129 @@
+/**
+ * @file bitmap_parallel.h
+ * @brief Multi-threaded bulk operations on the big bitmaps
+ * @details The blocks are split to the parts by the executor threads. The borders of the parts are aligned
+ *          to the cache lines of the destination, so the threads do not write to the same line.
+ *          The bitmaps less than bitmap_parallel_executor_t::bits_min are processed by the calling thread.
+ */
+
+#ifndef INCLUDE_BITMAP_PARALLEL_H_
+#define INCLUDE_BITMAP_PARALLEL_H_
+
+#include <bitmap/bitmap.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief The default amount of bits, from which the operations are parallel: 2 MiB */
+#define BITMAP_PARALLEL_BITS_MIN ((size_t)1 << 24)
+
+/** @brief Size of the cache line, the parts are aligned to it */
+#define BITMAP_PARALLEL_CACHE_LINE (64)
+
+/**
+ * @brief The part of the operation
+ * @param arg           The argument of the operation.
+ * @param ipart         The part index.
+ */
+typedef void (*bitmap_parallel_task_t)(void * arg, size_t ipart);
+
+/**
+ * @brief The executor of the parts
+ */
+typedef struct
+{
+    /**
+     * @brief Run task(arg, ipart) for each ipart in [0; parts_num), return after all of them are done
+     * @param ctx           The executor context.
+     */
+    void (*run)(void * ctx, bitmap_parallel_task_t task, void * arg, size_t parts_num);
+    void * ctx;             /**< The executor context */
+    size_t threads_num;     /**< Amount of threads, the operation is split to at most this amount of parts */
+    size_t bits_min;        /**< Amount of bits, from which the operations are parallel */
+} bitmap_parallel_executor_t;
+
+/**
+ * @brief Create the built-in thread pool
+ * @details The calling thread runs the parts too, the pool starts threads_num - 1 threads.
+ *          The operations from the different threads with the same pool are serialized.
+ * @param executor      The executor, bits_min is BITMAP_PARALLEL_BITS_MIN.
+ * @param threads_num   Amount of threads, 0 is the amount of the online CPUs.
+ * @return  0       OK
+ * @return -1       No memory, or the thread is not started
+ */
+int bitmap_parallel_pool_create2(
+        bitmap_parallel_executor_t * executor,
+        size_t threads_num
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Stop the threads and destroy the pool
+ * @param executor      The executor of the pool.
+ */
+void bitmap_parallel_pool_destroy1(
+        bitmap_parallel_executor_t * executor
+) BITMAP_PUBLIC;
+
+/**
+ * @brief dest = ~src, see bitmap_bitwise_not3()
+ * @param executor      The executor, NULL to run in the calling thread.
+ */
+void bitmap_parallel_bitwise_not4(
+        const bitmap_parallel_executor_t * executor,
+        bitmap_block_t * BITMAP_RESTRICT dest,
+        const bitmap_block_t * BITMAP_RESTRICT src,
+        size_t bits_num
+) BITMAP_PUBLIC;
+
+/**
+ * @brief dest = a | b, see bitmap_bitwise_or4()
+ * @param executor      The executor, NULL to run in the calling thread.
+ */
+void bitmap_parallel_bitwise_or5(
+        const bitmap_parallel_executor_t * executor,
+        bitmap_block_t * BITMAP_RESTRICT dest,
+        const bitmap_block_t * BITMAP_RESTRICT a,
+        const bitmap_block_t * BITMAP_RESTRICT b,
+        size_t bits_num
+) BITMAP_PUBLIC;
+
+/**
+ * @brief dest = a & b, see bitmap_bitwise_and4()
+ * @param executor      The executor, NULL to run in the calling thread.
+ */
+void bitmap_parallel_bitwise_and5(
+        const bitmap_parallel_executor_t * executor,
+        bitmap_block_t * BITMAP_RESTRICT dest,
+        const bitmap_block_t * BITMAP_RESTRICT a,
+        const bitmap_block_t * BITMAP_RESTRICT b,
+        size_t bits_num
+) BITMAP_PUBLIC;
+
+/**
+ * @brief dest = a & ~b, see bitmap_bitwise_clear4()
+ * @param executor      The executor, NULL to run in the calling thread.
+ */
+void bitmap_parallel_bitwise_clear5(
+        const bitmap_parallel_executor_t * executor,
+        bitmap_block_t * BITMAP_RESTRICT dest,
+        const bitmap_block_t * BITMAP_RESTRICT a,
+        const bitmap_block_t * BITMAP_RESTRICT b,
+        size_t bits_num
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Power of bitmap (amount of raised bits), see bitmap_bitwise_power2()
+ * @param executor      The executor, NULL to run in the calling thread.
+ */
+size_t bitmap_parallel_bitwise_power3(
+        const bitmap_parallel_executor_t * executor,
+        const bitmap_block_t * BITMAP_RESTRICT src,
+        size_t bits_num
+) BITMAP_PUBLIC;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_BITMAP_PARALLEL_H_ */
@@ -0,0 +1,221 @@
+/**
+ * @file bitmap_roaring.h
+ * @brief Compressed bitmap of the 32-bit indexes
+ * @details The index space is split by the chunks of BITMAP4096_BITS_NUM bits.
+ *          Only the chunks with the raised bits are stored, each chunk is the smallest of:
+ *          the sorted array of the indexes, the dense bitmap4096_t or the array of the runs.
+ *          The operations work chunk by chunk and do not expand the bitmap.
+ */
+
+#ifndef INCLUDE_BITMAP_ROARING_H_
+#define INCLUDE_BITMAP_ROARING_H_
+
+#include <bitmap/bitmap.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Internal use: the chunk */
+struct bitmap_P_roaring_chunk;
+
+/**
+ * @brief The compressed bitmap
+ * @details Fields are internal, use the bitmap_roaring_*() functions.
+ */
+typedef struct
+{
+    struct bitmap_P_roaring_chunk * chunks; /**< The chunks, sorted by the key */
+    size_t chunks_num;                      /**< Amount of the chunks */
+    size_t chunks_capacity;                 /**< Amount of the allocated chunks */
+} bitmap_roaring_t;
+
+/**
+ * @brief Initialize the empty bitmap
+ * @param bitmap        The bitmap.
+ */
+void bitmap_roaring_init1(
+        bitmap_roaring_t * bitmap
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Free the bitmap, it becomes empty
+ * @param bitmap        The bitmap.
+ */
+void bitmap_roaring_destroy1(
+        bitmap_roaring_t * bitmap
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Copy the bitmap
+ * @param dest          The initialized destination bitmap, the content is replaced.
+ * @param src           The source bitmap.
+ * @return  0       OK
+ * @return -1       No memory, dest is not changed
+ */
+int bitmap_roaring_copy2(
+        bitmap_roaring_t * BITMAP_RESTRICT dest,
+        const bitmap_roaring_t * BITMAP_RESTRICT src
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Convert each chunk to its smallest container, including the runs
+ * @param bitmap        The bitmap.
+ * @return  0       OK
+ * @return -1       No memory, the bitmap is valid
+ */
+int bitmap_roaring_optimize1(
+        bitmap_roaring_t * bitmap
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Sets particular bit to 1.
+ * @param bitmap        The bitmap.
+ * @param bit_index     The bit index.
+ * @return  0       OK
+ * @return -1       No memory, the bitmap is not changed
+ */
+int bitmap_roaring_bit_raise2(
+        bitmap_roaring_t * bitmap,
+        uint32_t bit_index
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Sets particular bit to 0.
+ * @param bitmap        The bitmap.
+ * @param bit_index     The bit index.
+ * @return  0       OK
+ * @return -1       No memory, the bitmap is not changed
+ */
+int bitmap_roaring_bit_clear2(
+        bitmap_roaring_t * bitmap,
+        uint32_t bit_index
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Gets particular bit.
+ * @param bitmap        The bitmap.
+ * @param bit_index     The bit index.
+ * @return The value of bit
+ */
+bool bitmap_roaring_bit_get2(
+        const bitmap_roaring_t * bitmap,
+        uint32_t bit_index
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Power of bitmap (amount of raised bits)
+ * @param bitmap        The bitmap.
+ */
+size_t bitmap_roaring_power1(
+        const bitmap_roaring_t * bitmap
+) BITMAP_PUBLIC;
+
+/**
+ * @brief dest = operation(a, b)
+ * @param dest          The initialized destination bitmap, the content is replaced. It can be a or b.
+ * @param operation     The operation.
+ * @param a             The first bitmap.
+ * @param b             The second bitmap.
+ * @return  0       OK
+ * @return -1       No memory, dest is not changed
+ */
+int bitmap_roaring_operation4(
+        bitmap_roaring_t * dest,
+        enum bitmap_operation operation,
+        const bitmap_roaring_t * a,
+        const bitmap_roaring_t * b
+) BITMAP_PUBLIC;
+
+/**
+ * @brief dest = a & b
+ * @note See bitmap_roaring_operation4()
+ */
+int bitmap_roaring_and3(
+        bitmap_roaring_t * dest,
+        const bitmap_roaring_t * a,
+        const bitmap_roaring_t * b
+) BITMAP_PUBLIC;
+
+/**
+ * @brief dest = a | b
+ * @note See bitmap_roaring_operation4()
+ */
+int bitmap_roaring_or3(
+        bitmap_roaring_t * dest,
+        const bitmap_roaring_t * a,
+        const bitmap_roaring_t * b
+) BITMAP_PUBLIC;
+
+/**
+ * @brief dest = a & ~b
+ * @note See bitmap_roaring_operation4()
+ */
+int bitmap_roaring_clear3(
+        bitmap_roaring_t * dest,
+        const bitmap_roaring_t * a,
+        const bitmap_roaring_t * b
+) BITMAP_PUBLIC;
+
+/**
+ * @brief dest = a ^ b
+ * @note See bitmap_roaring_operation4()
+ */
+int bitmap_roaring_xor3(
+        bitmap_roaring_t * dest,
+        const bitmap_roaring_t * a,
+        const bitmap_roaring_t * b
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Iterator by bits, which has value TRUE in a compressed bitmap.
+ * @details Fields are internal, use the bitmap_roaring_iterator_*() functions.
+ *          The bitmap must not be changed while the iteration.
+ */
+typedef struct
+{
+    const bitmap_roaring_t * bitmap; /**< The bitmap */
+    size_t ichunk;                   /**< The current chunk */
+    size_t iitem;                    /**< The current index or run of the chunk, the next block of the dense chunk */
+    size_t ibit;                     /**< The next bit of the run */
+    bitmap_block_t block;            /**< The current block of the dense chunk, without the visited bits */
+} bitmap_roaring_iterator_t;
+
+/**
+ * @brief Start the iteration
+ * @param iterator      The iterator.
+ * @param bitmap        The bitmap.
+ */
+void bitmap_roaring_iterator_init2(
+        bitmap_roaring_iterator_t * BITMAP_RESTRICT iterator,
+        const bitmap_roaring_t * BITMAP_RESTRICT bitmap
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Get the next raised bit
+ * @param iterator      The iterator.
+ * @param bit_index     The place to write the bit index.
+ * @return Is the bit exist? If false, the iteration is finished.
+ */
+bool bitmap_roaring_iterator_next2(
+        bitmap_roaring_iterator_t * BITMAP_RESTRICT iterator,
+        uint32_t * BITMAP_RESTRICT bit_index
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Iterator by bits, which has value TRUE in a compressed bitmap.
+ * @param xbit_index      Current bit, which has value TRUE (uint32_t *).
+ * @param xbitmap         The bitmap (const bitmap_roaring_t *).
+ * @param xiterator       Iterator context (bitmap_roaring_iterator_t *)
+ */
+#define BITMAP_ROARING_FOREACH_BIT_IN_BITMAP(xbit_index, xbitmap, xiterator) \
+        for( \
+                bitmap_roaring_iterator_init2((xiterator), (xbitmap)); \
+                bitmap_roaring_iterator_next2((xiterator), (xbit_index)); \
+        )
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_BITMAP_ROARING_H_ */
@@ -0,0 +1,105 @@
+/**
+ * @file bitmap_serialize.h
+ * @brief Binary serialization of the bitmap
+ * @details The serialized bitmap does not depend on the host: all fields are little-endian,
+ *          the bits are the stream of 64-bit words, the bit i is the bit (i % 64) of the word (i / 64).
+ *          Layout: the header of 32 bytes, then the payload:
+ *          - BITMAP_SERIALIZE_FORMAT__DENSE: all words;
+ *          - BITMAP_SERIALIZE_FORMAT__SPARSE: the index of the present words (one bit per word, padded to
+ *            the word), then the present words, the missing words are zero.
+ *          On the little-endian hosts the dense payload is the bitmap itself, it can be used in place.
+ */
+
+#ifndef INCLUDE_BITMAP_SERIALIZE_H_
+#define INCLUDE_BITMAP_SERIALIZE_H_
+
+#include <bitmap/bitmap.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Size of the header */
+#define BITMAP_SERIALIZE_HEADER_SIZE (32)
+
+/** @brief Format of the payload */
+enum bitmap_serialize_format
+{
+    BITMAP_SERIALIZE_FORMAT__DENSE,     /**< All words */
+    BITMAP_SERIALIZE_FORMAT__SPARSE,    /**< The index and the not zero words */
+};
+
+/**
+ * @brief Serialize the bitmap
+ * @details Like snprintf(), the size is returned even if the buffer is too small.
+ * @param dest          The buffer, any alignment. Can be NULL if dest_size is 0.
+ * @param dest_size     Size of the buffer.
+ * @param bitmap        The bitmap.
+ * @param bits_num      Amount of bits in bitmap.
+ * @param format        The format of the payload.
+ * @return Size of the serialized bitmap. If it is greater than dest_size, nothing is written.
+ */
+size_t bitmap_serialize5(
+        void * BITMAP_RESTRICT dest,
+        size_t dest_size,
+        const bitmap_block_t * BITMAP_RESTRICT bitmap,
+        size_t bits_num,
+        enum bitmap_serialize_format format
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Read the header of the serialized bitmap
+ * @param src           The serialized bitmap, at least BITMAP_SERIALIZE_HEADER_SIZE bytes.
+ * @param src_size      Size of the buffer.
+ * @param bits_num      Amount of bits in bitmap.
+ * @param size          Size of the serialized bitmap, the rest of the buffer is not used.
+ * @return  0       OK
+ * @return -1       The header is wrong or incomplete
+ */
+int bitmap_deserialize_info4(
+        const void * BITMAP_RESTRICT src,
+        size_t src_size,
+        size_t * BITMAP_RESTRICT bits_num,
+        size_t * BITMAP_RESTRICT size
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Deserialize the bitmap to the blocks, check the CRC
+ * @param dest          The destination bitmap. The blocks of the serialized bits are written,
+ *                      the tail bits of the last one are cleared.
+ * @param dest_bits_num Amount of bits in the destination bitmap, not less than the serialized bits.
+ * @param src           The serialized bitmap, any alignment.
+ * @param src_size      Size of the buffer.
+ * @return  0       OK
+ * @return -1       The data are wrong or incomplete, or dest is too small
+ */
+int bitmap_deserialize4(
+        bitmap_block_t * BITMAP_RESTRICT dest,
+        size_t dest_bits_num,
+        const void * BITMAP_RESTRICT src,
+        size_t src_size
+) BITMAP_PUBLIC;
+
+/**
+ * @brief Use the dense payload as the bitmap, without the copy
+ * @details It is possible on the little-endian hosts, for BITMAP_SERIALIZE_FORMAT__DENSE, if the payload
+ *          is aligned for bitmap_block_t. The CRC is not checked, the view is ready in O(1).
+ * @param view          The bitmap in the buffer, it lives while the buffer lives.
+ * @param bits_num      Amount of bits in bitmap.
+ * @param src           The serialized bitmap.
+ * @param src_size      Size of the buffer.
+ * @return  0       OK
+ * @return -1       The header is wrong or incomplete, or the view is not possible: use bitmap_deserialize4()
+ */
+int bitmap_deserialize_view4(
+        const bitmap_block_t ** BITMAP_RESTRICT view,
+        size_t * BITMAP_RESTRICT bits_num,
+        const void * BITMAP_RESTRICT src,
+        size_t src_size
+) BITMAP_PUBLIC;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_BITMAP_SERIALIZE_H_ */
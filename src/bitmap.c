@@ -4,8 +4,10 @@
  */
 
 #include <bitmap/bitmap.h>
+#include <bitmap/bitmap_inline.h>
 
 #include "bitmap_common.h"
+#include "bitmap_simd.h"
 
 #include <string.h>
 
@@ -25,16 +27,49 @@ void bitmap_bitwise_clear2(
     memset(bitmap, 0, BITMAP_BITS_TO_BYTES_ALIGNED(bits_num));
 }
 
-void bitmap_bitwise_range_raise2(
+/**
+ * @brief Raise or clear bits in range by whole blocks
+ * @param bitmap      The bitmap
+ * @param range       The range
+ * @param raise       Raise (true) or clear (false)
+ */
+static void P_bitwise_range_fill3(
         bitmap_block_t * bitmap,
-        const struct bitmap_range * range
+        const struct bitmap_range * range,
+        bool raise
 )
 {
-    size_t i;
-    for(i = range->begin; i <= range->end; ++i)
+    struct bitmap_P_range_blocks range_blocks;
+    if(!bitmap_P_range_blocks_get2(&range_blocks, range))
     {
-        bitmap_bit_raise2(bitmap, i);
+        return;
     }
+
+    /* whole blocks between the edge blocks */
+    memset(
+            &bitmap[range_blocks.iblock_begin + 1],
+            raise ? -1 : 0,
+            range_blocks.middle_blocks_num * BITMAP_BYTES_IN_BLOCK()
+    );
+
+    if(raise)
+    {
+        bitmap[range_blocks.iblock_begin] |= range_blocks.mask_begin;
+        bitmap[range_blocks.iblock_end] |= range_blocks.mask_end;
+    }
+    else
+    {
+        bitmap[range_blocks.iblock_begin] &= ~range_blocks.mask_begin;
+        bitmap[range_blocks.iblock_end] &= ~range_blocks.mask_end;
+    }
+}
+
+void bitmap_bitwise_range_raise2(
+        bitmap_block_t * bitmap,
+        const struct bitmap_range * range
+)
+{
+    P_bitwise_range_fill3(bitmap, range, true);
 }
 
 void bitmap_bitwise_range_clear2(
@@ -42,11 +77,7 @@ void bitmap_bitwise_range_clear2(
         const struct bitmap_range * range
 )
 {
-    size_t i;
-    for(i = range->begin; i <= range->end; ++i)
-    {
-        bitmap_bit_clear2(bitmap, i);
-    }
+    P_bitwise_range_fill3(bitmap, range, false);
 }
 
 void bitmap_bitwise_copy3(
@@ -64,12 +95,7 @@ void bitmap_bitwise_not3(
         size_t bits_num
 )
 {
-    size_t iblock;
-    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
-    BITMAP_FOREACH_BLOCK(iblock, blocks_num)
-    {
-        dest[iblock] = ~src[iblock];
-    }
+    bitmap_P_simd->not3(dest, src, BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num));
 }
 
 void bitmap_bitwise_or3(
@@ -78,12 +104,7 @@ void bitmap_bitwise_or3(
         size_t bits_num
 )
 {
-    size_t iblock;
-    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
-    BITMAP_FOREACH_BLOCK(iblock, blocks_num)
-    {
-        dest[iblock] |= src[iblock];
-    }
+    bitmap_P_simd->or3(dest, src, BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num));
 }
 
 void bitmap_bitwise_or4(
@@ -93,12 +114,7 @@ void bitmap_bitwise_or4(
         size_t bits_num
 )
 {
-    size_t iblock;
-    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
-    BITMAP_FOREACH_BLOCK(iblock, blocks_num)
-    {
-        dest[iblock] = a[iblock] | b[iblock];
-    }
+    bitmap_P_simd->or4(dest, a, b, BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num));
 }
 
 void bitmap_bitwise_and3(
@@ -107,12 +123,7 @@ void bitmap_bitwise_and3(
         size_t bits_num
 )
 {
-    size_t iblock;
-    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
-    BITMAP_FOREACH_BLOCK(iblock, blocks_num)
-    {
-        dest[iblock] &= src[iblock];
-    }
+    bitmap_P_simd->and3(dest, src, BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num));
 }
 
 void bitmap_bitwise_and4(
@@ -122,12 +133,7 @@ void bitmap_bitwise_and4(
         size_t bits_num
 )
 {
-    size_t iblock;
-    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
-    BITMAP_FOREACH_BLOCK(iblock, blocks_num)
-    {
-        dest[iblock] = a[iblock] & b[iblock];
-    }
+    bitmap_P_simd->and4(dest, a, b, BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num));
 }
 
 void bitmap_bitwise_clear3(
@@ -136,12 +142,7 @@ void bitmap_bitwise_clear3(
         size_t bits_num
 )
 {
-    size_t iblock;
-    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
-    BITMAP_FOREACH_BLOCK(iblock, blocks_num)
-    {
-        dest[iblock] &= ~src[iblock];
-    }
+    bitmap_P_simd->clear3(dest, src, BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num));
 }
 
 void bitmap_bitwise_clear4(
@@ -151,12 +152,7 @@ void bitmap_bitwise_clear4(
         size_t bits_num
 )
 {
-    size_t iblock;
-    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
-    BITMAP_FOREACH_BLOCK(iblock, blocks_num)
-    {
-        dest[iblock] = a[iblock] & ~b[iblock];
-    }
+    bitmap_P_simd->clear4(dest, a, b, BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num));
 }
 
 void bitmap_bit_raise2(
@@ -164,10 +160,7 @@ void bitmap_bit_raise2(
         size_t bit_index
 )
 {
-
-    bitmap_block_t *block = &bitmap[bit_index / BITMAP_BITS_IN_BLOCK()];
-    bitmap_block_t bit = BITMAP_RAISED_BIT(bit_index % BITMAP_BITS_IN_BLOCK());
-    *block |= bit;
+    bitmap_inline_bit_raise2(bitmap, bit_index);
 }
 
 void bitmap_bit_clear2(
@@ -175,9 +168,7 @@ void bitmap_bit_clear2(
         size_t bit_index
 )
 {
-    bitmap_block_t *block = &bitmap[bit_index / BITMAP_BITS_IN_BLOCK()];
-    bitmap_block_t bit = BITMAP_RAISED_BIT(bit_index % BITMAP_BITS_IN_BLOCK());
-    *block &= ~bit;
+    bitmap_inline_bit_clear2(bitmap, bit_index);
 }
 
 bool bitmap_bit_get2(
@@ -185,7 +176,5 @@ bool bitmap_bit_get2(
         size_t bit_index
 )
 {
-    bitmap_block_t block = bitmap[bit_index / BITMAP_BITS_IN_BLOCK()];
-    bitmap_block_t bit = BITMAP_RAISED_BIT(bit_index % BITMAP_BITS_IN_BLOCK());
-    return ((block & bit) != 0);
+    return bitmap_inline_bit_get2(bitmap, bit_index);
 }
@@ -0,0 +1,65 @@
+/**
+ * @file bitmap_atomic.c
+ * @brief Atomic bulk operations
+ */
+
+#include <bitmap/bitmap_atomic.h>
+
+#include "bitmap_common.h"
+
+void bitmap_atomic_bitwise_or4(
+        bitmap_block_t * BITMAP_RESTRICT dest,
+        const bitmap_block_t * BITMAP_RESTRICT src,
+        size_t bits_num,
+        enum bitmap_memory_order order
+)
+{
+    size_t iblock;
+    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
+
+    BITMAP_FOREACH_BLOCK_EXTENDED_BEGIN(iblock, blocks_num)
+    {
+        /* the cleared blocks are not written: no cache line is taken from other threads */
+        if(src[iblock] != 0)
+        {
+            bitmap_atomic_block_or4(dest, iblock, src[iblock], order);
+        }
+    }
+    BITMAP_FOREACH_BLOCK_EXTENDED_LASTBLOCK(iblock, blocks_num)
+    {
+        bitmap_block_t mask = src[iblock] & bitmap_P_tailblock_mask(bits_num);
+        if(mask != 0)
+        {
+            bitmap_atomic_block_or4(dest, iblock, mask, order);
+        }
+    }
+    BITMAP_FOREACH_BLOCK_EXTENDED_END();
+}
+
+void bitmap_atomic_bitwise_clear4(
+        bitmap_block_t * BITMAP_RESTRICT dest,
+        const bitmap_block_t * BITMAP_RESTRICT src,
+        size_t bits_num,
+        enum bitmap_memory_order order
+)
+{
+    size_t iblock;
+    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
+
+    BITMAP_FOREACH_BLOCK_EXTENDED_BEGIN(iblock, blocks_num)
+    {
+        if(src[iblock] != 0)
+        {
+            bitmap_atomic_block_clear4(dest, iblock, src[iblock], order);
+        }
+    }
+    BITMAP_FOREACH_BLOCK_EXTENDED_LASTBLOCK(iblock, blocks_num)
+    {
+        bitmap_block_t mask = src[iblock] & bitmap_P_tailblock_mask(bits_num);
+        if(mask != 0)
+        {
+            bitmap_atomic_block_clear4(dest, iblock, mask, order);
+        }
+    }
+    BITMAP_FOREACH_BLOCK_EXTENDED_END();
+}
@@ -5,6 +5,7 @@
 #include <bitmap/bitmap.h>
 
 #include "bitmap_common.h"
+#include "bitmap_simd.h"
 
 bool bitmap_bitwise_check_zero2(
         const bitmap_block_t *bitmap,
@@ -39,6 +40,46 @@ bool bitmap_bitwise_check_zero2(
     return true;
 }
 
+bool bitmap_bitwise_range_check_zero2(
+        const bitmap_block_t * bitmap,
+        const struct bitmap_range * range
+)
+{
+    struct bitmap_P_range_blocks range_blocks;
+    if(!bitmap_P_range_blocks_get2(&range_blocks, range))
+    {
+        return true;
+    }
+
+    return
+            (bitmap[range_blocks.iblock_begin] & range_blocks.mask_begin) == 0 &&
+            (bitmap[range_blocks.iblock_end] & range_blocks.mask_end) == 0 &&
+            bitmap_P_simd->find_nonzero(
+                    &bitmap[range_blocks.iblock_begin + 1],
+                    range_blocks.middle_blocks_num
+            ) == range_blocks.middle_blocks_num;
+}
+
+bool bitmap_bitwise_range_check_full2(
+        const bitmap_block_t * bitmap,
+        const struct bitmap_range * range
+)
+{
+    struct bitmap_P_range_blocks range_blocks;
+    if(!bitmap_P_range_blocks_get2(&range_blocks, range))
+    {
+        return true;
+    }
+
+    return
+            (bitmap[range_blocks.iblock_begin] & range_blocks.mask_begin) == range_blocks.mask_begin &&
+            (bitmap[range_blocks.iblock_end] & range_blocks.mask_end) == range_blocks.mask_end &&
+            bitmap_P_simd->find_notfull(
+                    &bitmap[range_blocks.iblock_begin + 1],
+                    range_blocks.middle_blocks_num
+            ) == range_blocks.middle_blocks_num;
+}
+
 bool bitmap_bitwise_check_equal3(
         const bitmap_block_t * BITMAP_RESTRICT a,
         const bitmap_block_t * BITMAP_RESTRICT b,
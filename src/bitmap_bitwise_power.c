@@ -6,6 +6,7 @@
 #include <bitmap/bitmap.h>
 
 #include "bitmap_common.h"
+#include "bitmap_simd.h"
 
 #include <assert.h>
 #include <stdio.h>
@@ -13,48 +14,46 @@
 #include <string.h>
 #include <math.h>
 
-/**
- * @brief Выбор наиболее оптимальной функции
- */
-#if BITMAP_BLOCK_SIZEOF() == __SIZEOF_SHORT__
-#   define POPCOUNT(x)  __builtin_popcount(/* unsigned int */ x)
-#elif BITMAP_BLOCK_SIZEOF() == __SIZEOF_INT__
-#   define POPCOUNT(x)  __builtin_popcount(/* unsigned int */ x)
-#elif BITMAP_BLOCK_SIZEOF() == __SIZEOF_LONG__
-#   define POPCOUNT(x)  __builtin_popcountl(/* unsigned long */ x)
-#elif BITMAP_BLOCK_SIZEOF() == __SIZEOF_LONG_LONG__
-#   define POPCOUNT(x)  __builtin_popcountll(/* unsigned long long */ x)
-#else /* BITMAP_BLOCK_SIZEOF() == 1 byte */
-#   define POPCOUNT(x)  __builtin_popcount(/* unsigned int */ x)
-#endif
-
 size_t bitmap_bitwise_power2(
         const bitmap_block_t * BITMAP_RESTRICT src,
         size_t size
 )
 {
     size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(size);
-    size_t iblock;
     size_t power = 0;
-    bitmap_block_t block;
 
-    BITMAP_FOREACH_BLOCK_EXTENDED_BEGIN(iblock, blocks_num)
+    if(blocks_num > 0)
     {
-        block = src[iblock];
-        power += POPCOUNT(block);
-    }
-    BITMAP_FOREACH_BLOCK_EXTENDED_LASTBLOCK(iblock, blocks_num)
-    {
-        block = src[iblock];
+        size_t iblock = blocks_num - 1;
+        power += bitmap_P_simd_power->power(src, iblock);
+
+        /* tail block */
+        bitmap_block_t block = src[iblock];
         bitmap_block_t mask = bitmap_P_tailblock_mask(size);
         block &= mask;
         power += POPCOUNT(block);
     }
-    BITMAP_FOREACH_BLOCK_EXTENDED_END();
 
     return power;
 }
 
+size_t bitmap_bitwise_range_power2(
+        const bitmap_block_t * bitmap,
+        const struct bitmap_range * range
+)
+{
+    struct bitmap_P_range_blocks range_blocks;
+    if(!bitmap_P_range_blocks_get2(&range_blocks, range))
+    {
+        return 0;
+    }
+
+    return
+            POPCOUNT(bitmap[range_blocks.iblock_begin] & range_blocks.mask_begin) +
+            bitmap_P_simd_power->power(&bitmap[range_blocks.iblock_begin + 1], range_blocks.middle_blocks_num) +
+            POPCOUNT(bitmap[range_blocks.iblock_end] & range_blocks.mask_end);
+}
+
 void bitmap_bitwise_power6(
         const bitmap_block_t * BITMAP_RESTRICT srcA,
         size_t sizeA,
@@ -107,17 +106,8 @@ void bitmap_bitwise_power6(
     if(mapS.size_blocks > 0)
     {
         size_t S_size_blocks = mapS.size_blocks - 1;
-        for(; iblock < S_size_blocks; ++iblock)
-        {
-            blockS = mapS.bitmap[iblock];
-            blockL = mapL.bitmap[iblock];
-
-            bisect = blockS & blockL;
-            bunion = blockS | blockL;
-
-            power_isect_tmp += POPCOUNT(bisect);
-            power_union_tmp += POPCOUNT(bunion);
-        }
+        bitmap_P_simd_power->power_and_or(mapS.bitmap, mapL.bitmap, S_size_blocks, &power_isect_tmp, &power_union_tmp);
+        iblock = S_size_blocks;
 
         /* tail blocks of S and L */
         if(iblock < mapS.size_blocks)
@@ -150,13 +140,10 @@ void bitmap_bitwise_power6(
     if(mapL.size_blocks > 0)
     {
         size_t L_size_blocks = mapL.size_blocks - 1;
-        for(; iblock < L_size_blocks; ++iblock)
+        if(iblock < L_size_blocks)
         {
-            blockL = mapL.bitmap[iblock];
-
-            bunion = blockL;
-
-            power_union_tmp += POPCOUNT(bunion);
+            power_union_tmp += bitmap_P_simd_power->power(&mapL.bitmap[iblock], L_size_blocks - iblock);
+            iblock = L_size_blocks;
         }
 
         /* tail block of L */
@@ -177,3 +164,237 @@ void bitmap_bitwise_power6(
     (*power_intersection) = power_isect_tmp;
     (*power_union) = power_union_tmp;
 }
+
+/**
+ * @brief Amount of blocks, counted between the threshold checks
+ */
+#define P_POWER_CHUNK_BLOCKS  (1024)
+
+/**
+ * @brief The cardinality kernel of the binary operation
+ */
+typedef size_t (*P_power_kernel_t)(
+        const bitmap_block_t * a,
+        const bitmap_block_t * b,
+        size_t blocks_num
+);
+
+/**
+ * @brief The binary operation on blocks
+ * @param operation     The operation
+ * @param a             The first block
+ * @param b             The second block
+ * @return The result block
+ */
+static inline bitmap_block_t P_block_operation(
+        enum bitmap_operation operation,
+        bitmap_block_t a,
+        bitmap_block_t b
+)
+{
+    switch(operation)
+    {
+        case BITMAP_OPERATION__AND  : return a & b;
+        case BITMAP_OPERATION__OR   : return a | b;
+        case BITMAP_OPERATION__CLEAR: return a & ~b;
+        case BITMAP_OPERATION__XOR  : return a ^ b;
+    }
+    return 0;
+}
+
+/**
+ * @brief Count the power of the binary operation by chunks, until the threshold is reached
+ * @param kernel        The cardinality kernel
+ * @param a             The first bitmap
+ * @param b             The second bitmap
+ * @param blocks_num    Amount of blocks
+ * @param power         Already counted power
+ * @param threshold     The threshold
+ * @return The power
+ */
+static size_t P_power_chunked_operation(
+        P_power_kernel_t kernel,
+        const bitmap_block_t * BITMAP_RESTRICT a,
+        const bitmap_block_t * BITMAP_RESTRICT b,
+        size_t blocks_num,
+        size_t power,
+        size_t threshold
+)
+{
+    size_t iblock = 0;
+    while(iblock < blocks_num && power < threshold)
+    {
+        size_t chunk_blocks_num = blocks_num - iblock;
+        if(chunk_blocks_num > P_POWER_CHUNK_BLOCKS)
+        {
+            chunk_blocks_num = P_POWER_CHUNK_BLOCKS;
+        }
+        power += kernel(&a[iblock], &b[iblock], chunk_blocks_num);
+        iblock += chunk_blocks_num;
+    }
+    return power;
+}
+
+/**
+ * @brief Count the power of the bitmap by chunks, until the threshold is reached
+ * @param src           The bitmap
+ * @param blocks_num    Amount of blocks
+ * @param power         Already counted power
+ * @param threshold     The threshold
+ * @return The power
+ */
+static size_t P_power_chunked(
+        const bitmap_block_t * src,
+        size_t blocks_num,
+        size_t power,
+        size_t threshold
+)
+{
+    size_t iblock = 0;
+    while(iblock < blocks_num && power < threshold)
+    {
+        size_t chunk_blocks_num = blocks_num - iblock;
+        if(chunk_blocks_num > P_POWER_CHUNK_BLOCKS)
+        {
+            chunk_blocks_num = P_POWER_CHUNK_BLOCKS;
+        }
+        power += bitmap_P_simd_power->power(&src[iblock], chunk_blocks_num);
+        iblock += chunk_blocks_num;
+    }
+    return power;
+}
+
+size_t bitmap_bitwise_operation_power6(
+        enum bitmap_operation operation,
+        const bitmap_block_t * BITMAP_RESTRICT srcA,
+        size_t sizeA,
+        const bitmap_block_t * BITMAP_RESTRICT srcB,
+        size_t sizeB,
+        size_t threshold
+)
+{
+    P_power_kernel_t kernel = NULL;
+    switch(operation)
+    {
+        case BITMAP_OPERATION__AND  : kernel = bitmap_P_simd_power->power_and  ; break;
+        case BITMAP_OPERATION__OR   : kernel = bitmap_P_simd_power->power_or   ; break;
+        case BITMAP_OPERATION__CLEAR: kernel = bitmap_P_simd_power->power_clear; break;
+        case BITMAP_OPERATION__XOR  : kernel = bitmap_P_simd_power->power_xor  ; break;
+    }
+    if(kernel == NULL)
+    {
+        return 0;
+    }
+
+    size_t blocks_numA = BITMAP_BITS_TO_BLOCKS_ALIGNED(sizeA);
+    size_t blocks_numB = BITMAP_BITS_TO_BLOCKS_ALIGNED(sizeB);
+    size_t blocks_common = (blocks_numA < blocks_numB) ? blocks_numA : blocks_numB;
+    size_t power = 0;
+
+    /* common part of A and B */
+    if(blocks_common > 0)
+    {
+        size_t iblock = blocks_common - 1;
+        power = P_power_chunked_operation(kernel, srcA, srcB, iblock, power, threshold);
+        if(power >= threshold)
+        {
+            return power;
+        }
+
+        /* the last common block can be the tail block of A and/or B */
+        bitmap_block_t blockA = srcA[iblock];
+        bitmap_block_t blockB = srcB[iblock];
+        if(blocks_numA == blocks_common)
+        {
+            blockA &= bitmap_P_tailblock_mask(sizeA);
+        }
+        if(blocks_numB == blocks_common)
+        {
+            blockB &= bitmap_P_tailblock_mask(sizeB);
+        }
+        power += POPCOUNT(P_block_operation(operation, blockA, blockB));
+    }
+
+    /* rest of the long bitmap, the bits of the short bitmap are zero there */
+    const bitmap_block_t * rest;
+    size_t rest_size;
+    size_t rest_blocks_num;
+    if(blocks_numA > blocks_common)
+    {
+        if(operation == BITMAP_OPERATION__AND)
+        {
+            return power;
+        }
+        rest = srcA;
+        rest_size = sizeA;
+        rest_blocks_num = blocks_numA;
+    }
+    else if(blocks_numB > blocks_common)
+    {
+        if(operation == BITMAP_OPERATION__AND || operation == BITMAP_OPERATION__CLEAR)
+        {
+            return power;
+        }
+        rest = srcB;
+        rest_size = sizeB;
+        rest_blocks_num = blocks_numB;
+    }
+    else
+    {
+        return power;
+    }
+
+    size_t iblock = rest_blocks_num - 1;
+    power = P_power_chunked(&rest[blocks_common], iblock - blocks_common, power, threshold);
+    if(power >= threshold)
+    {
+        return power;
+    }
+
+    /* tail block of the long bitmap */
+    bitmap_block_t block = rest[iblock];
+    block &= bitmap_P_tailblock_mask(rest_size);
+    power += POPCOUNT(block);
+
+    return power;
+}
+
+size_t bitmap_bitwise_and_power4(
+        const bitmap_block_t * BITMAP_RESTRICT srcA,
+        size_t sizeA,
+        const bitmap_block_t * BITMAP_RESTRICT srcB,
+        size_t sizeB
+)
+{
+    return bitmap_bitwise_operation_power6(BITMAP_OPERATION__AND, srcA, sizeA, srcB, sizeB, SIZE_MAX);
+}
+
+size_t bitmap_bitwise_or_power4(
+        const bitmap_block_t * BITMAP_RESTRICT srcA,
+        size_t sizeA,
+        const bitmap_block_t * BITMAP_RESTRICT srcB,
+        size_t sizeB
+)
+{
+    return bitmap_bitwise_operation_power6(BITMAP_OPERATION__OR, srcA, sizeA, srcB, sizeB, SIZE_MAX);
+}
+
+size_t bitmap_bitwise_clear_power4(
+        const bitmap_block_t * BITMAP_RESTRICT srcA,
+        size_t sizeA,
+        const bitmap_block_t * BITMAP_RESTRICT srcB,
+        size_t sizeB
+)
+{
+    return bitmap_bitwise_operation_power6(BITMAP_OPERATION__CLEAR, srcA, sizeA, srcB, sizeB, SIZE_MAX);
+}
+
+size_t bitmap_bitwise_xor_power4(
+        const bitmap_block_t * BITMAP_RESTRICT srcA,
+        size_t sizeA,
+        const bitmap_block_t * BITMAP_RESTRICT srcB,
+        size_t sizeB
+)
+{
+    return bitmap_bitwise_operation_power6(BITMAP_OPERATION__XOR, srcA, sizeA, srcB, sizeB, SIZE_MAX);
+}
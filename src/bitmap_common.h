@@ -68,6 +68,47 @@
             goto bitmap_foreach_block_extended_exit; \
         } while(0)
 
+/**
+ * @brief Выбор наиболее оптимальной функции
+ */
+#if BITMAP_BLOCK_SIZEOF() == __SIZEOF_SHORT__
+#   define POPCOUNT(x)  __builtin_popcount(/* unsigned int */ x)
+#elif BITMAP_BLOCK_SIZEOF() == __SIZEOF_INT__
+#   define POPCOUNT(x)  __builtin_popcount(/* unsigned int */ x)
+#elif BITMAP_BLOCK_SIZEOF() == __SIZEOF_LONG__
+#   define POPCOUNT(x)  __builtin_popcountl(/* unsigned long */ x)
+#elif BITMAP_BLOCK_SIZEOF() == __SIZEOF_LONG_LONG__
+#   define POPCOUNT(x)  __builtin_popcountll(/* unsigned long long */ x)
+#else /* BITMAP_BLOCK_SIZEOF() == 1 byte */
+#   define POPCOUNT(x)  __builtin_popcount(/* unsigned int */ x)
+#endif
+
+/**
+ * @brief Index of the lowest raised bit of the block, the block must be non-zero
+ */
+#if BITMAP_BLOCK_SIZEOF() == __SIZEOF_INT__
+#   define CTZ(x)  __builtin_ctz(/* unsigned int */ x)
+#elif BITMAP_BLOCK_SIZEOF() == __SIZEOF_LONG__
+#   define CTZ(x)  __builtin_ctzl(/* unsigned long */ x)
+#elif BITMAP_BLOCK_SIZEOF() == __SIZEOF_LONG_LONG__
+#   define CTZ(x)  __builtin_ctzll(/* unsigned long long */ x)
+#else /* BITMAP_BLOCK_SIZEOF() < sizeof(int) */
+#   define CTZ(x)  __builtin_ctz(/* unsigned int */ x)
+#endif
+
+/**
+ * @brief Amount of the leading zero bits of the block, the block must be non-zero
+ */
+#if BITMAP_BLOCK_SIZEOF() == __SIZEOF_INT__
+#   define CLZ(x)  __builtin_clz(/* unsigned int */ x)
+#elif BITMAP_BLOCK_SIZEOF() == __SIZEOF_LONG__
+#   define CLZ(x)  __builtin_clzl(/* unsigned long */ x)
+#elif BITMAP_BLOCK_SIZEOF() == __SIZEOF_LONG_LONG__
+#   define CLZ(x)  __builtin_clzll(/* unsigned long long */ x)
+#else /* BITMAP_BLOCK_SIZEOF() < sizeof(int) */
+#   define CLZ(x)  (__builtin_clz(/* unsigned int */ x) - (int)((__SIZEOF_INT__ - BITMAP_BLOCK_SIZEOF()) * 8))
+#endif
+
 /**
  * @brief Get bit, raised in position `<xibit>`
  * @param xibit     Bit position in block
@@ -75,6 +116,66 @@
 #define BITMAP_RAISED_BIT(xibit) \
         ((bitmap_block_t)1 << (xibit))
 
+/**
+ * @brief Get mask of the bits in range [ibit_begin; ibit_end] of the block
+ * @param ibit_begin      First bit of the range
+ * @param ibit_end        Last bit of the range
+ * @note 0 <= ibit_begin <= ibit_end < BITMAP_BITS_IN_BLOCK()
+ * @return Bitmap block mask
+ */
+static inline bitmap_block_t bitmap_P_block_range_mask(size_t ibit_begin, size_t ibit_end)
+{
+    return
+            ( ~(bitmap_block_t)0 << ibit_begin ) &
+            ( ~(bitmap_block_t)0 >> (BITMAP_BITS_IN_BLOCK() - 1 - ibit_end) );
+}
+
+/** @brief The range, split by the blocks */
+struct bitmap_P_range_blocks
+{
+    size_t iblock_begin;        /**< The first block */
+    size_t iblock_end;          /**< The last block, can be the first block */
+    bitmap_block_t mask_begin;  /**< Bits of the range in the first block */
+    bitmap_block_t mask_end;    /**< Bits of the range in the last block, 0 if it is the first block */
+    size_t middle_blocks_num;   /**< Amount of the whole blocks between the first and the last blocks */
+};
+
+/**
+ * @brief Split the range by the blocks
+ * @param range_blocks    The split range
+ * @param range           The range
+ * @return false, if the range is empty
+ */
+static inline bool bitmap_P_range_blocks_get2(
+        struct bitmap_P_range_blocks * range_blocks,
+        const struct bitmap_range * range
+)
+{
+    if(range->begin > range->end)
+    {
+        return false;
+    }
+
+    size_t ibit_begin = range->begin % BITMAP_BITS_IN_BLOCK();
+    size_t ibit_end = range->end % BITMAP_BITS_IN_BLOCK();
+    range_blocks->iblock_begin = range->begin / BITMAP_BITS_IN_BLOCK();
+    range_blocks->iblock_end = range->end / BITMAP_BITS_IN_BLOCK();
+
+    if(range_blocks->iblock_begin == range_blocks->iblock_end)
+    {
+        range_blocks->mask_begin = bitmap_P_block_range_mask(ibit_begin, ibit_end);
+        range_blocks->mask_end = 0;
+        range_blocks->middle_blocks_num = 0;
+    }
+    else
+    {
+        range_blocks->mask_begin = bitmap_P_block_range_mask(ibit_begin, BITMAP_BITS_IN_BLOCK() - 1);
+        range_blocks->mask_end = bitmap_P_block_range_mask(0, ibit_end);
+        range_blocks->middle_blocks_num = range_blocks->iblock_end - range_blocks->iblock_begin - 1;
+    }
+    return true;
+}
+
 /**
  * @brief Get significant bits mask of tail block
  * @param bits_num        Amount of bits in bitmap
@@ -89,4 +190,68 @@ static inline bitmap_block_t bitmap_P_tailblock_mask(size_t bits_num)
             ( ((bitmap_block_t)1 << significant_bits) - 1 );
 }
 
+/**
+ * @brief Is the char the white space, as isspace() of the "C" locale
+ */
+static inline bool bitmap_P_is_space1(char ch)
+{
+    return ch == ' ' || (ch >= '\t' && ch <= '\r');
+}
+
+/** @brief Maximum amount of the decimal digits of size_t */
+#define BITMAP_P_SIZE_DIGITS_MAX (sizeof(size_t) * 3)
+
+/**
+ * @brief Format the decimal value, without snprintf()
+ * @param digits        The buffer of BITMAP_P_SIZE_DIGITS_MAX chars, the digits are placed at its end.
+ * @param value         The value.
+ * @return Offset of the first digit in the buffer
+ */
+static inline size_t bitmap_P_size_format2(
+        char * digits,
+        size_t value
+)
+{
+    size_t offset = BITMAP_P_SIZE_DIGITS_MAX;
+    do
+    {
+        digits[--offset] = (char)('0' + value % 10);
+        value /= 10;
+    } while(value > 0);
+    return offset;
+}
+
+/**
+ * @brief The same as bitmap_print_ranged7()
+ * @param pairs_ranged  Print two bits run by the range marker: "1-2" instead of "1,2".
+ */
+int bitmap_P_print_ranged8(
+        bitmap_sink_t sink,
+        void * ctx,
+        const bitmap_block_t * BITMAP_RESTRICT bitmap,
+        size_t bits_num,
+        const char * BITMAP_RESTRICT enum_marker,
+        const char * BITMAP_RESTRICT range_marker,
+        bool pairs_ranged,
+        size_t * BITMAP_RESTRICT length
+) BITMAP_VISIBILITY_HIDDEN;
+
+/**
+ * @brief Parse the decimal index of the bit, move the offset after it
+ * @param src           Source chars.
+ * @param size          Amount of chars.
+ * @param offset        Offset of the index.
+ * @param bits_num      Amount of bits in bitmap.
+ * @param index         The index.
+ * @return  0       OK
+ * @return -1       No digits, or the index is out of the bitmap
+ */
+int bitmap_P_index_parse5(
+        const char * BITMAP_RESTRICT src,
+        size_t size,
+        size_t * BITMAP_RESTRICT offset,
+        size_t bits_num,
+        size_t * BITMAP_RESTRICT index
+) BITMAP_VISIBILITY_HIDDEN;
+
 #endif /* SRC_BITMAP_COMMON_H_ */
@@ -0,0 +1,144 @@
+/**
+ * @file bitmap_dynamic.c
+ * @brief Bitmap of the size known at run time, with the aligned storage
+ */
+
+#include <bitmap/bitmap_dynamic.h>
+
+#include "bitmap_common.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** @brief Amount of blocks in the alignment, the capacity is the multiple of it */
+#define P_ALIGNMENT_BLOCKS  (BITMAP_DYNAMIC_ALIGNMENT / BITMAP_BYTES_IN_BLOCK())
+
+/** @brief Round amount of blocks up to the alignment: the size of aligned_alloc() is the multiple of it */
+static size_t P_blocks_aligned1(
+        size_t blocks_num
+)
+{
+    return (blocks_num + P_ALIGNMENT_BLOCKS - 1) / P_ALIGNMENT_BLOCKS * P_ALIGNMENT_BLOCKS;
+}
+
+/**
+ * @brief Move the blocks to the new allocation
+ * @details The blocks after bits_num are cleared: the resize inside the capacity does not clear them.
+ * @param blocks_capacity       Amount of blocks, > 0, aligned by P_blocks_aligned1().
+ */
+static int P_dynamic_realloc2(
+        bitmap_dynamic_t * bitmap,
+        size_t blocks_capacity
+)
+{
+    if(blocks_capacity > SIZE_MAX / BITMAP_BYTES_IN_BLOCK())
+    {
+        return -1;
+    }
+    bitmap_block_t * blocks = aligned_alloc(BITMAP_DYNAMIC_ALIGNMENT, blocks_capacity * BITMAP_BYTES_IN_BLOCK());
+    if(blocks == NULL)
+    {
+        return -1;
+    }
+
+    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bitmap->bits_num);
+    if(blocks_num > 0)
+    {
+        memcpy(blocks, bitmap->blocks, blocks_num * BITMAP_BYTES_IN_BLOCK());
+    }
+    memset(&blocks[blocks_num], 0, (blocks_capacity - blocks_num) * BITMAP_BYTES_IN_BLOCK());
+
+    free(bitmap->blocks);
+    bitmap->blocks = blocks;
+    bitmap->blocks_capacity = blocks_capacity;
+    return 0;
+}
+
+int bitmap_dynamic_create2(
+        bitmap_dynamic_t * bitmap,
+        size_t bits_num
+)
+{
+    bitmap_dynamic_init1(bitmap);
+    return bitmap_dynamic_resize2(bitmap, bits_num);
+}
+
+void bitmap_dynamic_destroy1(
+        bitmap_dynamic_t * bitmap
+)
+{
+    free(bitmap->blocks);
+    bitmap_dynamic_init1(bitmap);
+}
+
+int bitmap_dynamic_reserve2(
+        bitmap_dynamic_t * bitmap,
+        size_t bits_num
+)
+{
+    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
+    if(blocks_num <= bitmap->blocks_capacity)
+    {
+        return 0;
+    }
+    return P_dynamic_realloc2(bitmap, P_blocks_aligned1(blocks_num));
+}
+
+int bitmap_dynamic_resize2(
+        bitmap_dynamic_t * bitmap,
+        size_t bits_num
+)
+{
+    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
+    if(blocks_num > bitmap->blocks_capacity)
+    {
+        /* the capacity is allocated once per the twice size */
+        size_t blocks_capacity = bitmap->blocks_capacity * 2;
+        if(blocks_capacity < blocks_num)
+        {
+            blocks_capacity = blocks_num;
+        }
+        if(P_dynamic_realloc2(bitmap, P_blocks_aligned1(blocks_capacity)) != 0)
+        {
+            return -1;
+        }
+    }
+
+    /* clear the bits between both sizes: the tail of the shorter size, the blocks up to the longer size */
+    size_t bits_min = (bits_num < bitmap->bits_num) ? bits_num : bitmap->bits_num;
+    size_t bits_max = (bits_num < bitmap->bits_num) ? bitmap->bits_num : bits_num;
+    size_t iblock = bits_min / BITMAP_BITS_IN_BLOCK();
+    size_t blocks_max = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_max);
+    if(BITMAP_BITS_IN_LASTBLOCK(bits_min) != 0)
+    {
+        bitmap->blocks[iblock] &= bitmap_P_tailblock_mask(bits_min);
+        ++iblock;
+    }
+    if(iblock < blocks_max)
+    {
+        memset(&bitmap->blocks[iblock], 0, (blocks_max - iblock) * BITMAP_BYTES_IN_BLOCK());
+    }
+
+    bitmap->bits_num = bits_num;
+    return 0;
+}
+
+int bitmap_dynamic_shrink_to_fit1(
+        bitmap_dynamic_t * bitmap
+)
+{
+    size_t blocks_capacity = P_blocks_aligned1(BITMAP_BITS_TO_BLOCKS_ALIGNED(bitmap->bits_num));
+    if(blocks_capacity == bitmap->blocks_capacity)
+    {
+        return 0;
+    }
+    if(blocks_capacity == 0)
+    {
+        free(bitmap->blocks);
+        bitmap->blocks = NULL;
+        bitmap->blocks_capacity = 0;
+        return 0;
+    }
+    return P_dynamic_realloc2(bitmap, blocks_capacity);
+}
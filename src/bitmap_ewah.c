@@ -0,0 +1,562 @@
+/**
+ * @file bitmap_ewah.c
+ * @brief Word-aligned run-length encoded bitmap (EWAH)
+ */
+
+#include <bitmap/bitmap_ewah.h>
+
+#include "bitmap_common.h"
+#include "bitmap_simd.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * The marker:
+ *  bit  0        the bit of the run;
+ *  bits 1 .. 32  amount of the clean blocks of the run;
+ *  bits 33 .. 63 amount of the literal blocks after the run.
+ */
+#define P_MARKER_RUN_BIT(xmarker)       ((bool)((xmarker) & 1))
+#define P_MARKER_RUN_NUM(xmarker)       ((size_t)(((xmarker) >> 1) & P_MARKER_RUN_MAX))
+#define P_MARKER_LITERALS_NUM(xmarker)  ((size_t)((xmarker) >> 33))
+#define P_MARKER_RUN_MAX                ((size_t)0xffffffff)
+#define P_MARKER_LITERALS_MAX           ((size_t)0x7fffffff)
+#define P_MARKER(xbit, xrun_num, xliterals_num) \
+        ( (bitmap_block_t)(xbit) | ((bitmap_block_t)(xrun_num) << 1) | ((bitmap_block_t)(xliterals_num) << 33) )
+
+/** @brief The clean block of the bit */
+#define P_CLEAN_BLOCK(xbit)             ((xbit) ? ~(bitmap_block_t)0 : (bitmap_block_t)0)
+
+static int P_ewah_push2(
+        bitmap_ewah_t * bitmap,
+        bitmap_block_t word
+)
+{
+    if(bitmap->words_num == bitmap->words_capacity)
+    {
+        size_t capacity = (bitmap->words_capacity == 0) ? 16 : bitmap->words_capacity * 2;
+        bitmap_block_t * words = realloc(bitmap->words, capacity * sizeof(bitmap_block_t));
+        if(words == NULL)
+        {
+            return -1;
+        }
+        bitmap->words = words;
+        bitmap->words_capacity = capacity;
+    }
+    bitmap->words[bitmap->words_num++] = word;
+    return 0;
+}
+
+static int P_ewah_append_run3(
+        bitmap_ewah_t * bitmap,
+        bool bit,
+        size_t blocks_num
+)
+{
+    while(blocks_num > 0)
+    {
+        /* extend the run of the last marker, while there are no literals after it */
+        if(bitmap->words_num > 0)
+        {
+            bitmap_block_t marker = bitmap->words[bitmap->marker];
+            size_t run_num = P_MARKER_RUN_NUM(marker);
+            if(
+                    P_MARKER_LITERALS_NUM(marker) == 0 &&
+                    (run_num == 0 || P_MARKER_RUN_BIT(marker) == bit) &&
+                    run_num < P_MARKER_RUN_MAX
+            )
+            {
+                size_t num = P_MARKER_RUN_MAX - run_num;
+                if(num > blocks_num)
+                {
+                    num = blocks_num;
+                }
+                bitmap->words[bitmap->marker] = P_MARKER(bit, run_num + num, 0);
+                blocks_num -= num;
+                continue;
+            }
+        }
+        if(P_ewah_push2(bitmap, P_MARKER(0, 0, 0)) != 0)
+        {
+            return -1;
+        }
+        bitmap->marker = bitmap->words_num - 1;
+    }
+    return 0;
+}
+
+static int P_ewah_append_literal2(
+        bitmap_ewah_t * bitmap,
+        bitmap_block_t word
+)
+{
+    if(word == 0 || word == ~(bitmap_block_t)0)
+    {
+        return P_ewah_append_run3(bitmap, word != 0, 1);
+    }
+
+    if(bitmap->words_num == 0 || P_MARKER_LITERALS_NUM(bitmap->words[bitmap->marker]) == P_MARKER_LITERALS_MAX)
+    {
+        if(P_ewah_push2(bitmap, P_MARKER(0, 0, 0)) != 0)
+        {
+            return -1;
+        }
+        bitmap->marker = bitmap->words_num - 1;
+    }
+    if(P_ewah_push2(bitmap, word) != 0)
+    {
+        return -1;
+    }
+    bitmap_block_t marker = bitmap->words[bitmap->marker];
+    bitmap->words[bitmap->marker] = P_MARKER(
+            P_MARKER_RUN_BIT(marker),
+            P_MARKER_RUN_NUM(marker),
+            P_MARKER_LITERALS_NUM(marker) + 1
+    );
+    return 0;
+}
+
+void bitmap_ewah_init1(
+        bitmap_ewah_t * bitmap
+)
+{
+    bitmap->words = NULL;
+    bitmap->words_num = 0;
+    bitmap->words_capacity = 0;
+    bitmap->marker = 0;
+    bitmap->bits_num = 0;
+}
+
+void bitmap_ewah_destroy1(
+        bitmap_ewah_t * bitmap
+)
+{
+    free(bitmap->words);
+    bitmap_ewah_init1(bitmap);
+}
+
+int bitmap_ewah_encode3(
+        bitmap_ewah_t * BITMAP_RESTRICT dest,
+        const bitmap_block_t * BITMAP_RESTRICT src,
+        size_t bits_num
+)
+{
+    bitmap_ewah_t result;
+    bitmap_ewah_init1(&result);
+    result.bits_num = bits_num;
+
+    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
+    size_t iblock = 0;
+    int res = 0;
+    while(res == 0 && iblock < blocks_num)
+    {
+        /* the tail block is the literal */
+        if(iblock + 1 == blocks_num)
+        {
+            res = P_ewah_append_literal2(&result, src[iblock] & bitmap_P_tailblock_mask(bits_num));
+            ++iblock;
+            continue;
+        }
+
+        bitmap_block_t block = src[iblock];
+        size_t num;
+        if(block == 0)
+        {
+            num = bitmap_P_simd->find_nonzero(&src[iblock], blocks_num - 1 - iblock);
+            res = P_ewah_append_run3(&result, false, num);
+        }
+        else if(block == ~(bitmap_block_t)0)
+        {
+            num = bitmap_P_simd->find_notfull(&src[iblock], blocks_num - 1 - iblock);
+            res = P_ewah_append_run3(&result, true, num);
+        }
+        else
+        {
+            num = 1;
+            res = P_ewah_append_literal2(&result, block);
+        }
+        iblock += num;
+    }
+
+    if(res != 0)
+    {
+        bitmap_ewah_destroy1(&result);
+        return -1;
+    }
+    bitmap_ewah_destroy1(dest);
+    (*dest) = result;
+    return 0;
+}
+
+void bitmap_ewah_decode2(
+        bitmap_block_t * BITMAP_RESTRICT dest,
+        const bitmap_ewah_t * BITMAP_RESTRICT src
+)
+{
+    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(src->bits_num);
+    size_t iblock = 0;
+    size_t iword = 0;
+    while(iword < src->words_num)
+    {
+        bitmap_block_t marker = src->words[iword++];
+        size_t run_num = P_MARKER_RUN_NUM(marker);
+        size_t literals_num = P_MARKER_LITERALS_NUM(marker);
+        memset(&dest[iblock], P_MARKER_RUN_BIT(marker) ? 0xff : 0, run_num * sizeof(bitmap_block_t));
+        iblock += run_num;
+        memcpy(&dest[iblock], &src->words[iword], literals_num * sizeof(bitmap_block_t));
+        iblock += literals_num;
+        iword += literals_num;
+    }
+    /* the stream of the operation result can be shorter */
+    memset(&dest[iblock], 0, (blocks_num - iblock) * sizeof(bitmap_block_t));
+}
+
+size_t bitmap_ewah_power1(
+        const bitmap_ewah_t * bitmap
+)
+{
+    size_t power = 0;
+    size_t iword = 0;
+    while(iword < bitmap->words_num)
+    {
+        bitmap_block_t marker = bitmap->words[iword++];
+        size_t literals_num = P_MARKER_LITERALS_NUM(marker);
+        if(P_MARKER_RUN_BIT(marker))
+        {
+            power += P_MARKER_RUN_NUM(marker) * BITMAP_BITS_IN_BLOCK();
+        }
+        power += bitmap_P_simd_power->power(&bitmap->words[iword], literals_num);
+        iword += literals_num;
+    }
+    return power;
+}
+
+/** @brief Reader of the stream */
+struct P_ewah_reader
+{
+    const bitmap_ewah_t * bitmap;
+    size_t iword;           /**< The next block of the stream */
+    bool run_bit;           /**< The bit of the current run */
+    size_t run_num;         /**< Amount of the blocks of the current run */
+    size_t literals_num;    /**< Amount of the literal blocks after the current run */
+    bool finished;          /**< The stream is finished, it is extended by the cleared blocks */
+};
+
+static void P_ewah_reader_init2(
+        struct P_ewah_reader * reader,
+        const bitmap_ewah_t * bitmap
+)
+{
+    reader->bitmap = bitmap;
+    reader->iword = 0;
+    reader->run_bit = false;
+    reader->run_num = 0;
+    reader->literals_num = 0;
+    reader->finished = false;
+}
+
+/**
+ * @brief Load the next marker, if the current group is finished
+ * @return false, if the stream is finished
+ */
+static bool P_ewah_reader_load1(
+        struct P_ewah_reader * reader
+)
+{
+    if(reader->finished)
+    {
+        return false;
+    }
+    while(reader->run_num == 0 && reader->literals_num == 0)
+    {
+        if(reader->iword >= reader->bitmap->words_num)
+        {
+            /* the infinite run of the cleared blocks */
+            reader->finished = true;
+            reader->run_bit = false;
+            reader->run_num = SIZE_MAX;
+            return false;
+        }
+        bitmap_block_t marker = reader->bitmap->words[reader->iword++];
+        reader->run_bit = P_MARKER_RUN_BIT(marker);
+        reader->run_num = P_MARKER_RUN_NUM(marker);
+        reader->literals_num = P_MARKER_LITERALS_NUM(marker);
+    }
+    return true;
+}
+
+/**
+ * @brief Receiver of the operation result: the stream or the power
+ */
+struct P_ewah_sink
+{
+    bitmap_ewah_t * dest;   /**< The result stream, or NULL */
+    size_t power;           /**< The result power */
+};
+
+static int P_ewah_sink_run3(
+        struct P_ewah_sink * sink,
+        bool bit,
+        size_t blocks_num
+)
+{
+    if(sink->dest == NULL)
+    {
+        sink->power += bit ? blocks_num * BITMAP_BITS_IN_BLOCK() : 0;
+        return 0;
+    }
+    return P_ewah_append_run3(sink->dest, bit, blocks_num);
+}
+
+static inline bitmap_block_t P_block_operation(
+        enum bitmap_operation operation,
+        bitmap_block_t a,
+        bitmap_block_t b
+)
+{
+    switch(operation)
+    {
+        case BITMAP_OPERATION__AND  : return a & b;
+        case BITMAP_OPERATION__OR   : return a | b;
+        case BITMAP_OPERATION__CLEAR: return a & ~b;
+        case BITMAP_OPERATION__XOR  : return a ^ b;
+    }
+    return 0;
+}
+
+/**
+ * @brief The operation of the run of one stream and the literals of other stream
+ * @param run_first     The run is the first operand
+ */
+static int P_ewah_sink_run_literals6(
+        struct P_ewah_sink * sink,
+        enum bitmap_operation operation,
+        bool run_bit,
+        const bitmap_block_t * literals,
+        size_t literals_num,
+        bool run_first
+)
+{
+    bitmap_block_t clean = P_CLEAN_BLOCK(run_bit);
+    bitmap_block_t result_0 = run_first ?
+            P_block_operation(operation, clean, 0) :
+            P_block_operation(operation, 0, clean);
+    bitmap_block_t result_1 = run_first ?
+            P_block_operation(operation, clean, ~(bitmap_block_t)0) :
+            P_block_operation(operation, ~(bitmap_block_t)0, clean);
+
+    /* the result does not depend on the literals */
+    if(result_0 == result_1)
+    {
+        return P_ewah_sink_run3(sink, result_0 != 0, literals_num);
+    }
+
+    /* the result is the literals or the inverted literals */
+    bitmap_block_t invert = result_0;
+    size_t i;
+    if(sink->dest == NULL)
+    {
+        for(i = 0; i < literals_num; ++i)
+        {
+            sink->power += POPCOUNT(literals[i] ^ invert);
+        }
+        return 0;
+    }
+    for(i = 0; i < literals_num; ++i)
+    {
+        if(P_ewah_append_literal2(sink->dest, literals[i] ^ invert) != 0)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int P_ewah_sink_literals5(
+        struct P_ewah_sink * sink,
+        enum bitmap_operation operation,
+        const bitmap_block_t * a,
+        const bitmap_block_t * b,
+        size_t literals_num
+)
+{
+    size_t i;
+    if(sink->dest == NULL)
+    {
+        for(i = 0; i < literals_num; ++i)
+        {
+            sink->power += POPCOUNT(P_block_operation(operation, a[i], b[i]));
+        }
+        return 0;
+    }
+    for(i = 0; i < literals_num; ++i)
+    {
+        if(P_ewah_append_literal2(sink->dest, P_block_operation(operation, a[i], b[i])) != 0)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Merge the streams group by group
+ */
+static int P_ewah_operation4(
+        struct P_ewah_sink * sink,
+        enum bitmap_operation operation,
+        const bitmap_ewah_t * a,
+        const bitmap_ewah_t * b
+)
+{
+    struct P_ewah_reader reader_a;
+    struct P_ewah_reader reader_b;
+    P_ewah_reader_init2(&reader_a, a);
+    P_ewah_reader_init2(&reader_b, b);
+
+    for(;;)
+    {
+        bool exist_a = P_ewah_reader_load1(&reader_a);
+        bool exist_b = P_ewah_reader_load1(&reader_b);
+        if(!exist_a && !exist_b)
+        {
+            break;
+        }
+
+        int res;
+        size_t num;
+        if(reader_a.run_num > 0 && reader_b.run_num > 0)
+        {
+            num = (reader_a.run_num < reader_b.run_num) ? reader_a.run_num : reader_b.run_num;
+            bitmap_block_t result = P_block_operation(
+                    operation,
+                    P_CLEAN_BLOCK(reader_a.run_bit),
+                    P_CLEAN_BLOCK(reader_b.run_bit)
+            );
+            res = P_ewah_sink_run3(sink, result != 0, num);
+            reader_a.run_num -= num;
+            reader_b.run_num -= num;
+        }
+        else if(reader_a.run_num > 0)
+        {
+            num = (reader_a.run_num < reader_b.literals_num) ? reader_a.run_num : reader_b.literals_num;
+            res = P_ewah_sink_run_literals6(
+                    sink,
+                    operation,
+                    reader_a.run_bit,
+                    &b->words[reader_b.iword],
+                    num,
+                    true
+            );
+            reader_a.run_num -= num;
+            reader_b.literals_num -= num;
+            reader_b.iword += num;
+        }
+        else if(reader_b.run_num > 0)
+        {
+            num = (reader_b.run_num < reader_a.literals_num) ? reader_b.run_num : reader_a.literals_num;
+            res = P_ewah_sink_run_literals6(
+                    sink,
+                    operation,
+                    reader_b.run_bit,
+                    &a->words[reader_a.iword],
+                    num,
+                    false
+            );
+            reader_b.run_num -= num;
+            reader_a.literals_num -= num;
+            reader_a.iword += num;
+        }
+        else
+        {
+            num = (reader_a.literals_num < reader_b.literals_num) ? reader_a.literals_num : reader_b.literals_num;
+            res = P_ewah_sink_literals5(
+                    sink,
+                    operation,
+                    &a->words[reader_a.iword],
+                    &b->words[reader_b.iword],
+                    num
+            );
+            reader_a.literals_num -= num;
+            reader_a.iword += num;
+            reader_b.literals_num -= num;
+            reader_b.iword += num;
+        }
+        if(res != 0)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int bitmap_ewah_operation4(
+        bitmap_ewah_t * dest,
+        enum bitmap_operation operation,
+        const bitmap_ewah_t * a,
+        const bitmap_ewah_t * b
+)
+{
+    /* the result is built aside: dest can be a or b */
+    bitmap_ewah_t result;
+    bitmap_ewah_init1(&result);
+    result.bits_num = (a->bits_num > b->bits_num) ? a->bits_num : b->bits_num;
+
+    struct P_ewah_sink sink = { .dest = &result, .power = 0 };
+    if(P_ewah_operation4(&sink, operation, a, b) != 0)
+    {
+        bitmap_ewah_destroy1(&result);
+        return -1;
+    }
+    bitmap_ewah_destroy1(dest);
+    (*dest) = result;
+    return 0;
+}
+
+size_t bitmap_ewah_operation_power3(
+        enum bitmap_operation operation,
+        const bitmap_ewah_t * a,
+        const bitmap_ewah_t * b
+)
+{
+    struct P_ewah_sink sink = { .dest = NULL, .power = 0 };
+    P_ewah_operation4(&sink, operation, a, b);
+    return sink.power;
+}
+
+int bitmap_ewah_and3(
+        bitmap_ewah_t * dest,
+        const bitmap_ewah_t * a,
+        const bitmap_ewah_t * b
+)
+{
+    return bitmap_ewah_operation4(dest, BITMAP_OPERATION__AND, a, b);
+}
+
+int bitmap_ewah_or3(
+        bitmap_ewah_t * dest,
+        const bitmap_ewah_t * a,
+        const bitmap_ewah_t * b
+)
+{
+    return bitmap_ewah_operation4(dest, BITMAP_OPERATION__OR, a, b);
+}
+
+int bitmap_ewah_clear3(
+        bitmap_ewah_t * dest,
+        const bitmap_ewah_t * a,
+        const bitmap_ewah_t * b
+)
+{
+    return bitmap_ewah_operation4(dest, BITMAP_OPERATION__CLEAR, a, b);
+}
+
+int bitmap_ewah_xor3(
+        bitmap_ewah_t * dest,
+        const bitmap_ewah_t * a,
+        const bitmap_ewah_t * b
+)
+{
+    return bitmap_ewah_operation4(dest, BITMAP_OPERATION__XOR, a, b);
+}
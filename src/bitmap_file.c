@@ -0,0 +1,199 @@
+/**
+ * @file bitmap_file.c
+ * @brief Memory-mapped bitmap files
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <bitmap/bitmap_file.h>
+
+#include "bitmap_common.h"
+#include "bitmap_simd.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+_Static_assert(sizeof(struct bitmap_file_header) == 64, "the header is 64 bytes");
+
+/**
+ * @brief Size of the file of the bitmap
+ */
+static size_t P_file_size1(
+        size_t bits_num
+)
+{
+    return sizeof(struct bitmap_file_header) + BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num) * sizeof(bitmap_block_t);
+}
+
+/**
+ * @brief Map the opened file
+ */
+static int P_file_map3(
+        bitmap_file_t * file,
+        size_t size,
+        enum bitmap_file_mode mode
+)
+{
+    int prot = (mode == BITMAP_FILE_MODE__WRITE) ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void * map = mmap(NULL, size, prot, MAP_SHARED, file->fd, 0);
+    if(map == MAP_FAILED)
+    {
+        return -1;
+    }
+    file->mode = mode;
+    file->header = map;
+    file->size = size;
+    return 0;
+}
+
+/**
+ * @brief Close the file, keep errno
+ */
+static void P_file_close1(
+        int fd
+)
+{
+    int error = errno;
+    close(fd);
+    errno = error;
+}
+
+uint32_t bitmap_crc32c3(
+        uint32_t crc,
+        const void * data,
+        size_t size
+)
+{
+    return bitmap_P_crc32c(crc, data, size);
+}
+
+int bitmap_file_create3(
+        bitmap_file_t * BITMAP_RESTRICT file,
+        const char * BITMAP_RESTRICT path,
+        size_t bits_num
+)
+{
+    size_t size = P_file_size1(bits_num);
+
+    file->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(file->fd < 0)
+    {
+        return -1;
+    }
+    /* the blocks are the holes of zeros */
+    if(ftruncate(file->fd, (off_t)size) != 0 || P_file_map3(file, size, BITMAP_FILE_MODE__WRITE) != 0)
+    {
+        P_file_close1(file->fd);
+        return -1;
+    }
+
+    struct bitmap_file_header * header = file->header;
+    memcpy(header->magic, BITMAP_FILE_MAGIC, sizeof(header->magic));
+    header->version = BITMAP_FILE_VERSION;
+    header->block_size = sizeof(bitmap_block_t);
+    header->bits_num = bits_num;
+    header->endianness = BITMAP_FILE_ENDIANNESS;
+    header->crc32c = 0;
+    memset(header->reserved, 0, sizeof(header->reserved));
+    return 0;
+}
+
+int bitmap_file_open3(
+        bitmap_file_t * BITMAP_RESTRICT file,
+        const char * BITMAP_RESTRICT path,
+        enum bitmap_file_mode mode
+)
+{
+    file->fd = open(path, (mode == BITMAP_FILE_MODE__WRITE) ? O_RDWR : O_RDONLY);
+    if(file->fd < 0)
+    {
+        return -1;
+    }
+
+    struct stat st;
+    if(fstat(file->fd, &st) != 0)
+    {
+        P_file_close1(file->fd);
+        return -1;
+    }
+    if((uint64_t)st.st_size < sizeof(struct bitmap_file_header) || (uint64_t)st.st_size > SIZE_MAX)
+    {
+        close(file->fd);
+        errno = EINVAL;
+        return -1;
+    }
+    if(P_file_map3(file, (size_t)st.st_size, mode) != 0)
+    {
+        P_file_close1(file->fd);
+        return -1;
+    }
+
+    const struct bitmap_file_header * header = file->header;
+    if(
+            memcmp(header->magic, BITMAP_FILE_MAGIC, sizeof(header->magic)) != 0 ||
+            header->version != BITMAP_FILE_VERSION ||
+            header->block_size != sizeof(bitmap_block_t) ||
+            header->endianness != BITMAP_FILE_ENDIANNESS ||
+            header->bits_num > SIZE_MAX ||
+            P_file_size1((size_t)header->bits_num) != file->size
+    )
+    {
+        munmap(file->header, file->size);
+        close(file->fd);
+        errno = EINVAL;
+        return -1;
+    }
+    return 0;
+}
+
+int bitmap_file_sync1(
+        bitmap_file_t * file
+)
+{
+    file->header->crc32c = bitmap_crc32c3(
+            0,
+            bitmap_file_bitmap1(file),
+            file->size - sizeof(struct bitmap_file_header)
+    );
+    return msync(file->header, file->size, MS_SYNC);
+}
+
+int bitmap_file_close1(
+        bitmap_file_t * file
+)
+{
+    int ret = 0;
+    if(file->mode == BITMAP_FILE_MODE__WRITE)
+    {
+        ret = bitmap_file_sync1(file);
+    }
+    munmap(file->header, file->size);
+    if(ret != 0)
+    {
+        P_file_close1(file->fd);
+    }
+    else
+    {
+        ret = close(file->fd);
+    }
+    file->fd = -1;
+    file->header = NULL;
+    file->size = 0;
+    return ret;
+}
+
+bool bitmap_file_check_crc1(
+        const bitmap_file_t * file
+)
+{
+    uint32_t crc = bitmap_crc32c3(
+            0,
+            bitmap_file_bitmap1(file),
+            file->size - sizeof(struct bitmap_file_header)
+    );
+    return crc == file->header->crc32c;
+}
@@ -0,0 +1,279 @@
+/**
+ * @file bitmap_idalloc.c
+ * @brief Lock-free allocator of the integer IDs
+ */
+
+#include <bitmap/bitmap_idalloc.h>
+#include <bitmap/bitmap_atomic.h>
+
+#include "bitmap_common.h"
+
+#include <stdlib.h>
+
+/** @brief The full block */
+#define P_FULL (~(bitmap_block_t)0)
+
+/** @brief The bit in the block */
+#define P_BIT(xindex) ((bitmap_block_t)1 << ((xindex) % BITMAP_BITS_IN_BLOCK()))
+
+/**
+ * @brief Mark the block of the level as full in the levels above
+ * @details The free of the block between the check and the mark is caught by the re-check.
+ *          The free marks the block as not full after it clears the bit, so one of them sees the other.
+ *          The mark goes up while it fills the block of the summary.
+ */
+static void P_full_set3(
+        bitmap_idalloc_t * alloc,
+        size_t level,
+        size_t iblock
+)
+{
+    for(; level + 1 < alloc->levels_num; ++level)
+    {
+        bitmap_block_t * summary = alloc->levels[level + 1];
+        size_t isummary = iblock / BITMAP_BITS_IN_BLOCK();
+        bitmap_block_t bit = P_BIT(iblock);
+        bitmap_block_t prev = bitmap_atomic_block_or4(summary, isummary, bit, BITMAP_MEMORY_ORDER__SEQ_CST);
+        if(bitmap_atomic_block_get3(alloc->levels[level], iblock, BITMAP_MEMORY_ORDER__SEQ_CST) != P_FULL)
+        {
+            bitmap_atomic_block_clear4(summary, isummary, bit, BITMAP_MEMORY_ORDER__SEQ_CST);
+            return;
+        }
+        if((prev | bit) != P_FULL)
+        {
+            return;
+        }
+        iblock = isummary;
+    }
+}
+
+/**
+ * @brief Take the free bit of the block
+ * @return Is the ID allocated?
+ */
+static bool P_block_alloc3(
+        bitmap_idalloc_t * alloc,
+        size_t iblock,
+        size_t * id
+)
+{
+    bitmap_block_t block = bitmap_atomic_block_get3(alloc->bitmap, iblock, BITMAP_MEMORY_ORDER__RELAXED);
+    while(block != P_FULL)
+    {
+        /* the lowest cleared bit */
+        bitmap_block_t bit = ~block & (block + 1);
+        if(bitmap_atomic_block_compare_exchange5(alloc->bitmap, iblock, &block, block | bit, BITMAP_MEMORY_ORDER__ACQUIRE))
+        {
+            if((block | bit) == P_FULL)
+            {
+                P_full_set3(alloc, 0, iblock);
+            }
+            *id = iblock * BITMAP_BITS_IN_BLOCK() + CTZ(bit);
+            return true;
+        }
+        /* the block is changed by the other thread, it is reloaded by the compare-exchange */
+    }
+    P_full_set3(alloc, 0, iblock);
+    return false;
+}
+
+/**
+ * @brief Find the block of the bitmap, which is not full by the summary, from the block iblock
+ * @details Up: to the level with the not full block at the index or after it. Down: the lowest not full block
+ *          of each level. The late summary, full block under the cleared bit, is marked and skipped.
+ * @return The block, or blocks_num if the blocks up to the end are full
+ */
+static size_t P_block_find2(
+        bitmap_idalloc_t * alloc,
+        size_t iblock
+)
+{
+    size_t level = 1;
+    size_t index = iblock;
+    for(;;)
+    {
+        bitmap_block_t notfull;
+        for(;;)
+        {
+            if(index >= alloc->sizes[level])
+            {
+                return alloc->blocks_num;
+            }
+            notfull = ~bitmap_atomic_block_get3(alloc->levels[level], index / BITMAP_BITS_IN_BLOCK(), BITMAP_MEMORY_ORDER__RELAXED);
+            notfull &= P_FULL << (index % BITMAP_BITS_IN_BLOCK());
+            if(notfull != 0)
+            {
+                break;
+            }
+            if(level + 1 == alloc->levels_num)
+            {
+                return alloc->blocks_num;
+            }
+            index = index / BITMAP_BITS_IN_BLOCK() + 1;
+            ++level;
+        }
+        index = index / BITMAP_BITS_IN_BLOCK() * BITMAP_BITS_IN_BLOCK() + CTZ(notfull);
+
+        for(; level > 1; --level)
+        {
+            notfull = ~bitmap_atomic_block_get3(alloc->levels[level - 1], index, BITMAP_MEMORY_ORDER__RELAXED);
+            if(notfull == 0)
+            {
+                break;
+            }
+            index = index * BITMAP_BITS_IN_BLOCK() + CTZ(notfull);
+        }
+        if(level == 1)
+        {
+            return index;
+        }
+
+        /* the late summary */
+        P_full_set3(alloc, level - 1, index);
+        ++index;
+    }
+}
+
+int bitmap_idalloc_create2(
+        bitmap_idalloc_t * alloc,
+        size_t ids_num
+)
+{
+    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(ids_num);
+
+    /* at least one summary level, the top level is one block */
+    size_t levels_num = 1;
+    size_t summaries_blocks_num = 0;
+    size_t size = ids_num;
+    do
+    {
+        size = BITMAP_BITS_TO_BLOCKS_ALIGNED(size);
+        summaries_blocks_num += BITMAP_BITS_TO_BLOCKS_ALIGNED(size);
+        ++levels_num;
+    } while(size > BITMAP_BITS_IN_BLOCK());
+
+    /* one allocation, the items are placed by descending alignment, it is not empty for 0 IDs */
+    void * data = malloc(
+            levels_num * sizeof(bitmap_block_t *) +
+            levels_num * sizeof(size_t) +
+            (blocks_num + summaries_blocks_num + 1) * sizeof(bitmap_block_t)
+    );
+    if(data == NULL)
+    {
+        return -1;
+    }
+
+    alloc->ids_num = ids_num;
+    alloc->blocks_num = blocks_num;
+    alloc->levels_num = levels_num;
+    alloc->levels = data;
+    alloc->sizes = (size_t *)&alloc->levels[levels_num];
+
+    bitmap_block_t * blocks = (bitmap_block_t *)&alloc->sizes[levels_num];
+    size_t level;
+    for(level = 0; level < levels_num; ++level)
+    {
+        size = (level == 0) ? ids_num : BITMAP_BITS_TO_BLOCKS_ALIGNED(alloc->sizes[level - 1]);
+        size_t level_blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(size);
+        alloc->sizes[level] = size;
+        alloc->levels[level] = blocks;
+        blocks += level_blocks_num;
+
+        /* the bits out of the range are allocated forever */
+        bitmap_bitwise_clear2(alloc->levels[level], size);
+        if(level_blocks_num > 0)
+        {
+            alloc->levels[level][level_blocks_num - 1] |= ~bitmap_P_tailblock_mask(size);
+        }
+    }
+    alloc->bitmap = alloc->levels[0];
+    return 0;
+}
+
+void bitmap_idalloc_destroy1(
+        bitmap_idalloc_t * alloc
+)
+{
+    free(alloc->levels);
+    alloc->bitmap = NULL;
+    alloc->levels = NULL;
+    alloc->sizes = NULL;
+}
+
+int bitmap_idalloc_alloc3(
+        bitmap_idalloc_t * alloc,
+        size_t * BITMAP_RESTRICT hint,
+        size_t * BITMAP_RESTRICT id
+)
+{
+    if(alloc->blocks_num == 0)
+    {
+        return -1;
+    }
+
+    /* from the hint to the end, from the begin to the hint */
+    size_t iblock_start = ((*hint < alloc->ids_num) ? *hint : 0) / BITMAP_BITS_IN_BLOCK();
+    size_t iblock = iblock_start;
+    bool wrapped = false;
+    for(;;)
+    {
+        iblock = P_block_find2(alloc, iblock);
+        if(iblock == alloc->blocks_num || (wrapped && iblock > iblock_start))
+        {
+            if(wrapped)
+            {
+                break;
+            }
+            wrapped = true;
+            iblock = 0;
+            continue;
+        }
+        if(P_block_alloc3(alloc, iblock, id))
+        {
+            *hint = *id;
+            return 0;
+        }
+        ++iblock;
+    }
+
+    /* the summary can be late, check all blocks */
+    for(iblock = 0; iblock < alloc->blocks_num; ++iblock)
+    {
+        if(P_block_alloc3(alloc, iblock, id))
+        {
+            *hint = *id;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+void bitmap_idalloc_free2(
+        bitmap_idalloc_t * alloc,
+        size_t id
+)
+{
+    bitmap_atomic_bit_clear3(alloc->bitmap, id, BITMAP_MEMORY_ORDER__SEQ_CST);
+
+    /* the summary blocks are written only when the blocks were full */
+    size_t iblock = id / BITMAP_BITS_IN_BLOCK();
+    size_t level;
+    for(level = 1; level < alloc->levels_num; ++level)
+    {
+        size_t isummary = iblock / BITMAP_BITS_IN_BLOCK();
+        bitmap_block_t bit = P_BIT(iblock);
+        if(bitmap_atomic_block_get3(alloc->levels[level], isummary, BITMAP_MEMORY_ORDER__SEQ_CST) & bit)
+        {
+            bitmap_atomic_block_clear4(alloc->levels[level], isummary, bit, BITMAP_MEMORY_ORDER__SEQ_CST);
+        }
+        iblock = isummary;
+    }
+}
+
+bool bitmap_idalloc_check2(
+        const bitmap_idalloc_t * alloc,
+        size_t id
+)
+{
+    return bitmap_atomic_bit_get3(alloc->bitmap, id, BITMAP_MEMORY_ORDER__ACQUIRE);
+}
@@ -5,144 +5,262 @@
 #include <bitmap/bitmap.h>
 
 #include "bitmap_common.h"
+#include "bitmap_simd.h"
 
 #include <errno.h>
 #include <stdio.h>
 #include <ctype.h>
+#include <string.h>
 #include <unistd.h>
 
+/** @brief Size of the chunk of the streaming output */
+#define P_PRINT_CHUNK_SIZE (4096)
+
 /**
- * @brief Append formatted string to the string with size checking
- * @param[in,out] str_ptr       Pointer to string. Is modifiable! (char *)
- * @param[in,out] str_rest      Amount of rest of chars in str_ptr. Is modifiable! (ssize_t *)
- * @param[in]     format        Format string, see `snprintf()`
- * @return length (ssize_t)
- *                  >= 0 - Written chars, except '\0';
- *                  < 0 - No free space to write the string.
- * @note If return < 0, str_rest < 0 too.
+ * @brief The streaming output: the chunk is flushed to the sink
  */
-#define STR_SNPRINTF_PUSH(str_ptr, str_rest, format, ...) \
-        ({ \
-            ssize_t _len = snprintf((str_ptr), *(str_rest), format, ##__VA_ARGS__); \
-            if(_len > 0) \
-            { \
-                (str_ptr) += _len; \
-                *(str_rest) -= _len; \
-            } \
-            (str_rest) >= 0 ? _len : -1; \
-        })
-
+struct P_printer
+{
+    bitmap_sink_t sink;     /**< The sink, NULL for the dry run */
+    void * ctx;             /**< Context of the sink */
+    size_t length;          /**< Amount of chars written */
+    size_t used;            /**< Amount of chars in the chunk */
+    char chunk[P_PRINT_CHUNK_SIZE];
+};
 
 /**
- * @breif Print the single range
- * @param first         Is the first range?
- * @param dest          Destination string.
- * @param rest          Rest of the string.
- * @param range         Range.
- * @param enum_marker   Marker of the enumeration: ", ".
- * @param range_marker  Marker of the range: " - ".
+ * @brief Flush the chunk to the sink
  */
-static int P_snprintf_range(
-        bool first,
-        char ** BITMAP_RESTRICT dest,
-        ssize_t * BITMAP_RESTRICT rest,
-        const struct bitmap_range * BITMAP_RESTRICT range,
-        const char * BITMAP_RESTRICT enum_marker,
-        const char * BITMAP_RESTRICT range_marker
+static int P_printer_flush1(
+        struct P_printer * printer
 )
 {
-    if(!first)
+    size_t used = printer->used;
+    printer->used = 0;
+    if(used == 0 || printer->sink == NULL)
     {
-        STR_SNPRINTF_PUSH(*dest, rest, "%s", enum_marker);
-        if((*rest) < 0)
-        {
-            return -1;
-        }
+        return 0;
     }
+    return printer->sink(printer->ctx, printer->chunk, used);
+}
 
-    if(range->begin == range->end)
-    {
-        STR_SNPRINTF_PUSH(*dest, rest, "%d", (int)range->begin);
-    }
-    else
+/**
+ * @brief Write the chars to the chunk
+ */
+static int P_printer_write3(
+        struct P_printer * BITMAP_RESTRICT printer,
+        const char * BITMAP_RESTRICT data,
+        size_t size
+)
+{
+    printer->length += size;
+    if(printer->sink == NULL)
     {
-        STR_SNPRINTF_PUSH(
-                *dest,
-                rest,
-                "%d%s%d",
-                (int)range->begin,
-                ((range->begin + 1 == range->end) ? enum_marker : range_marker),
-                (int)range->end
-        );
+        return 0;
     }
-    if((*rest) < 0)
+    while(size > 0)
     {
-        return -1;
+        size_t rest = P_PRINT_CHUNK_SIZE - printer->used;
+        if(rest == 0)
+        {
+            if(P_printer_flush1(printer) != 0)
+            {
+                return -1;
+            }
+            rest = P_PRINT_CHUNK_SIZE;
+        }
+        size_t len = (size < rest) ? size : rest;
+        memcpy(&printer->chunk[printer->used], data, len);
+        printer->used += len;
+        data += len;
+        size -= len;
     }
     return 0;
 }
 
-int bitmap_snprintf_ranged6(
-        char * BITMAP_RESTRICT dest,
-        size_t size,
+/**
+ * @brief Write the decimal value
+ */
+static int P_printer_write_size2(
+        struct P_printer * printer,
+        size_t value
+)
+{
+    char digits[BITMAP_P_SIZE_DIGITS_MAX];
+    size_t offset = bitmap_P_size_format2(digits, value);
+    return P_printer_write3(printer, &digits[offset], BITMAP_P_SIZE_DIGITS_MAX - offset);
+}
+
+/**
+ * @brief Print the ranges, run by run
+ * @details The runs are found by the blocks: the raised bit is the begin, the cleared bit is the end.
+ */
+static int P_printer_ranged6(
+        struct P_printer * BITMAP_RESTRICT printer,
         const bitmap_block_t * BITMAP_RESTRICT bitmap,
         size_t bits_num,
         const char * BITMAP_RESTRICT enum_marker,
-        const char * BITMAP_RESTRICT range_marker
+        const char * BITMAP_RESTRICT range_marker,
+        bool pairs_ranged
 )
 {
-    int res = 0;
+    size_t enum_marker_len = strlen(enum_marker);
+    size_t range_marker_len = strlen(range_marker);
+    bool first = true;
+    bitmap_bit_nearest_get_context_t raised;
+    bitmap_bit_nearest_get_context_t cleared;
 
-    char * bits_str_ptr = dest;
-    ssize_t rest = size;
-
-    /* protect */
-    if(size == 0)
-    {
-        return 0;
-    }
-    bits_str_ptr[0] = '\0';
-
-    struct bitmap_range range;
-    bool first_iteration = true;
-    bool first_print = true;
-    size_t ibit;
-    bitmap_foreach_bit_context_t ctx;
-    BITMAP_FOREACH_BIT_IN_BITMAP(&ibit, bitmap, bits_num, &ctx)
+    bitmap_bit_nearest_forward_raised_get4(bitmap, bits_num, 0, &raised);
+    while(raised.exist)
     {
+        size_t begin = raised.index;
+        bitmap_bit_nearest_forward_cleared_get4(bitmap, bits_num, begin, &cleared);
+        size_t end = cleared.exist ? (cleared.index - 1) : (bits_num - 1);
 
-        if(unlikely(first_iteration))
+        if(!first && P_printer_write3(printer, enum_marker, enum_marker_len) != 0)
         {
-            range.begin = ibit;
-            first_iteration = false;
+            return -1;
         }
-        else
+        first = false;
+        if(P_printer_write_size2(printer, begin) != 0)
+        {
+            return -1;
+        }
+        if(begin != end)
         {
-            bool range_interrupted = (range.end + 1 != ibit);
-            if(range_interrupted)
+            int res = (begin + 1 == end && !pairs_ranged)
+                    ? P_printer_write3(printer, enum_marker, enum_marker_len)
+                    : P_printer_write3(printer, range_marker, range_marker_len);
+            if(res != 0 || P_printer_write_size2(printer, end) != 0)
             {
-                res = P_snprintf_range(first_print, &bits_str_ptr, &rest, &range, enum_marker, range_marker);
-                if(res) goto end;
-
-                first_print = false;
-
-                range.begin = ibit;
+                return -1;
             }
         }
 
-        range.end = ibit;
+        if(!cleared.exist)
+        {
+            break;
+        }
+        bitmap_bit_nearest_forward_raised_get4(bitmap, bits_num, cleared.index + 1, &raised);
     }
+    return P_printer_flush1(printer);
+}
 
-    if(!first_iteration)
+int bitmap_P_print_ranged8(
+        bitmap_sink_t sink,
+        void * ctx,
+        const bitmap_block_t * BITMAP_RESTRICT bitmap,
+        size_t bits_num,
+        const char * BITMAP_RESTRICT enum_marker,
+        const char * BITMAP_RESTRICT range_marker,
+        bool pairs_ranged,
+        size_t * BITMAP_RESTRICT length
+)
+{
+    struct P_printer printer;
+    printer.sink = sink;
+    printer.ctx = ctx;
+    printer.length = 0;
+    printer.used = 0;
+    int res = P_printer_ranged6(&printer, bitmap, bits_num, enum_marker, range_marker, pairs_ranged);
+    if(length != NULL)
     {
-        res = P_snprintf_range(first_print, &bits_str_ptr, &rest, &range, enum_marker, range_marker);
-        if(res) goto end;
+        *length = printer.length;
     }
+    return res;
+}
+
+int bitmap_print_ranged7(
+        bitmap_sink_t sink,
+        void * ctx,
+        const bitmap_block_t * BITMAP_RESTRICT bitmap,
+        size_t bits_num,
+        const char * BITMAP_RESTRICT enum_marker,
+        const char * BITMAP_RESTRICT range_marker,
+        size_t * BITMAP_RESTRICT length
+)
+{
+    return bitmap_P_print_ranged8(sink, ctx, bitmap, bits_num, enum_marker, range_marker, false, length);
+}
+
+size_t bitmap_print_ranged_length4(
+        const bitmap_block_t * BITMAP_RESTRICT bitmap,
+        size_t bits_num,
+        const char * BITMAP_RESTRICT enum_marker,
+        const char * BITMAP_RESTRICT range_marker
+)
+{
+    size_t length;
+    bitmap_print_ranged7(NULL, NULL, bitmap, bits_num, enum_marker, range_marker, &length);
+    return length;
+}
+
+/**
+ * @brief The sink to FILE *
+ */
+static int P_sink_file3(
+        void * ctx,
+        const char * data,
+        size_t size
+)
+{
+    return (fwrite(data, 1, size, (FILE *)ctx) == size) ? 0 : -1;
+}
+
+int bitmap_fprint_ranged5(
+        FILE * BITMAP_RESTRICT stream,
+        const bitmap_block_t * BITMAP_RESTRICT bitmap,
+        size_t bits_num,
+        const char * BITMAP_RESTRICT enum_marker,
+        const char * BITMAP_RESTRICT range_marker
+)
+{
+    return bitmap_print_ranged7(P_sink_file3, stream, bitmap, bits_num, enum_marker, range_marker, NULL);
+}
 
-    end:
+/**
+ * @brief The sink to the string, the room for '\0' is kept
+ */
+struct P_sink_string
+{
+    char * dest;
+    size_t rest;
+};
 
-    dest[size - 1] = '\0';
+static int P_sink_string3(
+        void * ctx,
+        const char * data,
+        size_t size
+)
+{
+    struct P_sink_string * string = ctx;
+    size_t len = (size < string->rest) ? size : string->rest;
+    memcpy(string->dest, data, len);
+    string->dest += len;
+    string->rest -= len;
+    return (len == size) ? 0 : -1;
+}
+
+int bitmap_snprintf_ranged6(
+        char * BITMAP_RESTRICT dest,
+        size_t size,
+        const bitmap_block_t * BITMAP_RESTRICT bitmap,
+        size_t bits_num,
+        const char * BITMAP_RESTRICT enum_marker,
+        const char * BITMAP_RESTRICT range_marker
+)
+{
+    /* protect */
+    if(size == 0)
+    {
+        return 0;
+    }
 
+    struct P_sink_string string;
+    string.dest = dest;
+    string.rest = size - 1;
+    int res = bitmap_print_ranged7(P_sink_string3, &string, bitmap, bits_num, enum_marker, range_marker, NULL);
+    string.dest[0] = '\0';
     return res;
 }
 
@@ -270,6 +388,11 @@ int bitmap_sscanf_append_ranged5(
             {
                 if(ch == enum_marker)
                 {
+                    if(value == &range.begin)
+                    {
+                        range.end = range.begin;
+                    }
+                    bitmap_bitwise_range_raise2(bitmap, &range);
                     state = ST_DIGIT_AFTER_MARKER_ENUM;
                 }
                 else if(ch == range_marker)
@@ -365,3 +488,117 @@ int bitmap_sscanf_append_ranged5(
 
     return 0;
 }
+
+/**
+ * @brief Offset of the first char after the white spaces
+ */
+static inline size_t P_spaces_skip3(
+        const char * src,
+        size_t size,
+        size_t offset
+)
+{
+    for(; offset < size && bitmap_P_is_space1(src[offset]); ++offset);
+    return offset;
+}
+
+int bitmap_P_index_parse5(
+        const char * BITMAP_RESTRICT src,
+        size_t size,
+        size_t * BITMAP_RESTRICT offset,
+        size_t bits_num,
+        size_t * BITMAP_RESTRICT index
+)
+{
+    const char * digit = &src[*offset];
+    size_t len = bitmap_P_simd->span_digits(digit, size - *offset);
+    if(len == 0 || bits_num == 0)
+    {
+        return -1;
+    }
+
+    const char * end = &digit[len];
+    size_t limit = bits_num - 1;
+    size_t value = 0;
+    for(; digit < end; ++digit)
+    {
+        size_t d = (size_t)(*digit - '0');
+        if(limit < d || value > (limit - d) / 10)
+        {
+            return -1;
+        }
+        value = value * 10 + d;
+    }
+    (*index) = value;
+    (*offset) += len;
+    return 0;
+}
+
+int bitmap_parse_append_ranged7(
+        bitmap_block_t * BITMAP_RESTRICT bitmap,
+        size_t bits_num,
+        char enum_marker,
+        char range_marker,
+        const char * BITMAP_RESTRICT src,
+        size_t size,
+        size_t * BITMAP_RESTRICT error_offset
+)
+{
+    struct bitmap_range range;
+    size_t offset = P_spaces_skip3(src, size, 0);
+    size_t offset_token;
+
+    while(offset < size)
+    {
+        offset_token = offset;
+        if(bitmap_P_index_parse5(src, size, &offset, bits_num, &range.begin) != 0)
+        {
+            goto error;
+        }
+        range.end = range.begin;
+        offset = P_spaces_skip3(src, size, offset);
+
+        if(offset < size && src[offset] == range_marker)
+        {
+            offset = P_spaces_skip3(src, size, offset + 1);
+            offset_token = offset;
+            if(
+                    bitmap_P_index_parse5(src, size, &offset, bits_num, &range.end) != 0 ||
+                    range.end < range.begin
+            )
+            {
+                goto error;
+            }
+            offset = P_spaces_skip3(src, size, offset);
+        }
+
+        if(range.begin == range.end)
+        {
+            bitmap_bit_raise2(bitmap, range.begin);
+        }
+        else
+        {
+            bitmap_bitwise_range_raise2(bitmap, &range);
+        }
+
+        if(offset == size)
+        {
+            break;
+        }
+        if(src[offset] != enum_marker)
+        {
+            offset_token = offset;
+            goto error;
+        }
+        /* the trailing enum marker is allowed, as by bitmap_sscanf_append_ranged5() */
+        offset = P_spaces_skip3(src, size, offset + 1);
+    }
+    return 0;
+
+    error:
+    if(error_offset != NULL)
+    {
+        (*error_offset) = offset_token;
+    }
+    return -1;
+}
@@ -5,76 +5,299 @@
 #include <bitmap/bitmap.h>
 
 #include "bitmap_common.h"
+#include "bitmap_simd.h"
 
 /**
- * @param ibit_from     bit index
- * @param ibit_to       bit index
- * @note 0 <= ibit_from <= ibit_to < BITMAP_BITS_IN_BLOCK()
+ * @brief Find "forward" the nearest bit of the value
+ * @param bitmap            The bitmap
+ * @param bits_num          Amount of bits in bitmap
+ * @param bit_index_from    The bit numer, from which start searching
+ * @param raised            The value of the bit
+ * @param bit_nearest       The nearest bit
  */
-static void P_block_bit_nearest_forward_raised_get4(
-        bitmap_block_t block,
-        uint8_t ibit_from,
-        uint8_t ibit_to,
+static inline void P_bit_nearest_forward_get5(
+        const bitmap_block_t *bitmap,
+        size_t bits_num,
+        size_t bit_index_from,
+        bool raised,
         bitmap_bit_nearest_get_context_t * bit_nearest
 )
 {
-    uint8_t iblockbit;
-    for(iblockbit = ibit_from; iblockbit < ibit_to; ++iblockbit)
+    bit_nearest->exist = false;
+
+    if(bit_index_from >= bits_num)
     {
-        bitmap_block_t bit = BITMAP_RAISED_BIT(iblockbit);
-        bool found = ((block & bit) != 0);
-        if(found)
+        return;
+    }
+
+    /* the cleared bits are searched as the raised bits of the inverted blocks */
+    bitmap_block_t invert = raised ? 0 : ~(bitmap_block_t)0;
+    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
+    size_t iblock = bit_index_from / BITMAP_BITS_IN_BLOCK();
+
+    /* bits of the first block before bit_index_from are skipped */
+    bitmap_block_t block = (bitmap[iblock] ^ invert) & ( ~(bitmap_block_t)0 << (bit_index_from % BITMAP_BITS_IN_BLOCK()) );
+    if(block == 0)
+    {
+        ++iblock;
+        iblock += raised ?
+                bitmap_P_simd->find_nonzero(&bitmap[iblock], blocks_num - iblock) :
+                bitmap_P_simd->find_notfull(&bitmap[iblock], blocks_num - iblock);
+        if(iblock >= blocks_num)
         {
-            bit_nearest->index = iblockbit;
-            bit_nearest->exist = true;
             return;
         }
+        block = bitmap[iblock] ^ invert;
+    }
+
+    size_t index = iblock * BITMAP_BITS_IN_BLOCK() + CTZ(block);
+    /* insignificant bits of the tail block */
+    if(index >= bits_num)
+    {
+        return;
     }
+
+    bit_nearest->index = index;
+    bit_nearest->exist = true;
 }
 
-void bitmap_bit_nearest_forward_raised_get4(
+/**
+ * @brief Find "backward" the nearest bit of the value
+ * @param bitmap            The bitmap
+ * @param bits_num          Amount of bits in bitmap
+ * @param bit_index_from    The bit numer, from which start searching, bits_num - 1 if above
+ * @param raised            The value of the bit
+ * @param bit_nearest       The nearest bit
+ */
+static inline void P_bit_nearest_backward_get5(
         const bitmap_block_t *bitmap,
         size_t bits_num,
         size_t bit_index_from,
+        bool raised,
         bitmap_bit_nearest_get_context_t * bit_nearest
 )
 {
-    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
-    size_t iblock;
-    size_t bit_index_tmp;
-
     bit_nearest->exist = false;
 
-    for(
-            iblock = bit_index_from / BITMAP_BITS_IN_BLOCK(), bit_index_tmp = bit_index_from;
-            iblock < blocks_num;
-            ++iblock                                        , bit_index_tmp = iblock * BITMAP_BITS_IN_BLOCK()
-    )
+    if(bits_num == 0)
     {
-        bitmap_block_t block = bitmap[iblock];
-        if(block == 0) /* skip zero block */
-        {
-            continue;
-        }
+        return;
+    }
+    if(bit_index_from >= bits_num)
+    {
+        bit_index_from = bits_num - 1;
+    }
+
+    bitmap_block_t invert = raised ? 0 : ~(bitmap_block_t)0;
+    size_t iblock = bit_index_from / BITMAP_BITS_IN_BLOCK();
 
-        bool last = (iblock + 1 == blocks_num);
-        size_t blockbits = last ?
-                BITMAP_BITS_IN_TAILBLOCK(bits_num) :
-                BITMAP_BITS_IN_BLOCK();
-
-        P_block_bit_nearest_forward_raised_get4(
-                block,
-                bit_index_tmp % BITMAP_BITS_IN_BLOCK(),
-                blockbits,
-                bit_nearest
-        );
-        if(bit_nearest->exist)
+    /* bits of the first block after bit_index_from, including the insignificant bits, are skipped */
+    bitmap_block_t block = (bitmap[iblock] ^ invert) &
+            ( ~(bitmap_block_t)0 >> (BITMAP_BITS_IN_BLOCK() - 1 - bit_index_from % BITMAP_BITS_IN_BLOCK()) );
+    while(block == 0)
+    {
+        if(iblock == 0)
         {
-            bit_nearest->index += iblock * BITMAP_BITS_IN_BLOCK();
             return;
         }
+        --iblock;
+        block = bitmap[iblock] ^ invert;
+    }
+
+    bit_nearest->index = iblock * BITMAP_BITS_IN_BLOCK() + (BITMAP_BITS_IN_BLOCK() - 1 - CLZ(block));
+    bit_nearest->exist = true;
+}
+
+void bitmap_bit_nearest_forward_raised_get4(
+        const bitmap_block_t *bitmap,
+        size_t bits_num,
+        size_t bit_index_from,
+        bitmap_bit_nearest_get_context_t * bit_nearest
+)
+{
+    P_bit_nearest_forward_get5(bitmap, bits_num, bit_index_from, true, bit_nearest);
+}
+
+void bitmap_bit_nearest_forward_cleared_get4(
+        const bitmap_block_t *bitmap,
+        size_t bits_num,
+        size_t bit_index_from,
+        bitmap_bit_nearest_get_context_t * bit_nearest
+)
+{
+    P_bit_nearest_forward_get5(bitmap, bits_num, bit_index_from, false, bit_nearest);
+}
 
+void bitmap_bit_nearest_backward_raised_get4(
+        const bitmap_block_t *bitmap,
+        size_t bits_num,
+        size_t bit_index_from,
+        bitmap_bit_nearest_get_context_t * bit_nearest
+)
+{
+    P_bit_nearest_backward_get5(bitmap, bits_num, bit_index_from, true, bit_nearest);
+}
+
+void bitmap_bit_nearest_backward_cleared_get4(
+        const bitmap_block_t *bitmap,
+        size_t bits_num,
+        size_t bit_index_from,
+        bitmap_bit_nearest_get_context_t * bit_nearest
+)
+{
+    P_bit_nearest_backward_get5(bitmap, bits_num, bit_index_from, false, bit_nearest);
+}
+
+void bitmap_bit_range_first_raised_get3(
+        const bitmap_block_t *bitmap,
+        const struct bitmap_range * range,
+        bitmap_bit_nearest_get_context_t * bit_nearest
+)
+{
+    if(range->begin > range->end)
+    {
+        bit_nearest->exist = false;
+        return;
+    }
+    /* the bits after the range are insignificant as the bits of the tail block */
+    P_bit_nearest_forward_get5(bitmap, range->end + 1, range->begin, true, bit_nearest);
+}
+
+/**
+ * @brief Load the block to the iterator
+ * @param iterator      The iterator
+ * @param iblock        Index of the block, < iterator->blocks_num
+ */
+static inline void P_iterator_load2(
+        bitmap_iterator_t * iterator,
+        size_t iblock
+)
+{
+    bitmap_block_t block = iterator->bitmap[iblock];
+    if(iblock + 1 == iterator->blocks_num)
+    {
+        block &= bitmap_P_tailblock_mask(iterator->bits_num);
+    }
+    iterator->iblock = iblock;
+    iterator->block = block;
+}
+
+void bitmap_iterator_init4(
+        bitmap_iterator_t * BITMAP_RESTRICT iterator,
+        const bitmap_block_t * BITMAP_RESTRICT bitmap,
+        size_t bits_num,
+        size_t bit_index_from
+)
+{
+    iterator->bitmap = bitmap;
+    iterator->bits_num = bits_num;
+    iterator->blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
+
+    if(bit_index_from >= bits_num)
+    {
+        iterator->iblock = iterator->blocks_num;
+        iterator->block = 0;
+        return;
+    }
+
+    P_iterator_load2(iterator, bit_index_from / BITMAP_BITS_IN_BLOCK());
+    /* bits before bit_index_from are visited */
+    iterator->block &= ( ~(bitmap_block_t)0 << (bit_index_from % BITMAP_BITS_IN_BLOCK()) );
+}
+
+bool bitmap_iterator_refill1(
+        bitmap_iterator_t * iterator
+)
+{
+    size_t blocks_num = iterator->blocks_num;
+    size_t iblock = iterator->iblock + 1;
+
+    if(iblock < blocks_num)
+    {
+        iblock += bitmap_P_simd->find_nonzero(&iterator->bitmap[iblock], blocks_num - iblock);
+        if(iblock < blocks_num)
+        {
+            P_iterator_load2(iterator, iblock);
+            if(iterator->block != 0)
+            {
+                return true;
+            }
+        }
     }
 
+    /* finished */
+    iterator->iblock = blocks_num;
+    iterator->block = 0;
+    return false;
 }
 
+/**
+ * @brief Define the decoding of the raised bits to indexes
+ * @details The head and the tail blocks are decoded by count-trailing-zeros, the middle blocks by the kernel,
+ *          the zero blocks are skipped.
+ * @param xname     Name of the function
+ * @param xtype     Type of the index
+ * @param xkernel   The decoding kernel in the bitmap_P_simd
+ */
+#define P_DEFINE_TO_INDICES(xname, xtype, xkernel) \
+        size_t xname( \
+                xtype * BITMAP_RESTRICT indices, \
+                size_t indices_num, \
+                const bitmap_block_t * BITMAP_RESTRICT bitmap, \
+                size_t bits_num, \
+                size_t * BITMAP_RESTRICT bit_index_from \
+        ) \
+        { \
+            size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num); \
+            size_t iwritten = 0; \
+            if((*bit_index_from) >= bits_num) \
+            { \
+                (*bit_index_from) = bits_num; \
+                return 0; \
+            } \
+            size_t iblock = (*bit_index_from) / BITMAP_BITS_IN_BLOCK(); \
+            bitmap_block_t block = bitmap[iblock] & ( ~(bitmap_block_t)0 << ((*bit_index_from) % BITMAP_BITS_IN_BLOCK()) ); \
+            for(;;) \
+            { \
+                if(iblock + 1 == blocks_num) \
+                { \
+                    block &= bitmap_P_tailblock_mask(bits_num); \
+                } \
+                for(; block != 0; block &= block - 1) \
+                { \
+                    size_t index = iblock * BITMAP_BITS_IN_BLOCK() + CTZ(block); \
+                    if(iwritten == indices_num) \
+                    { \
+                        (*bit_index_from) = index; \
+                        return iwritten; \
+                    } \
+                    indices[iwritten++] = (xtype)index; \
+                } \
+                if(++iblock >= blocks_num) \
+                { \
+                    break; \
+                } \
+                /* whole blocks while there is the room, except the tail block */ \
+                size_t written; \
+                iblock += bitmap_P_simd->xkernel( \
+                        &indices[iwritten], \
+                        indices_num - iwritten, \
+                        &bitmap[iblock], \
+                        blocks_num - 1 - iblock, \
+                        (xtype)(iblock * BITMAP_BITS_IN_BLOCK()), \
+                        &written \
+                ); \
+                iwritten += written; \
+                iblock += bitmap_P_simd->find_nonzero(&bitmap[iblock], blocks_num - iblock); \
+                if(iblock >= blocks_num) \
+                { \
+                    break; \
+                } \
+                block = bitmap[iblock]; \
+            } \
+            (*bit_index_from) = bits_num; \
+            return iwritten; \
+        }
+
+P_DEFINE_TO_INDICES(bitmap_to_indices5   , size_t  , decode_size)
+P_DEFINE_TO_INDICES(bitmap_to_indices32_5, uint32_t, decode_u32 )
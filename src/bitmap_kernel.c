@@ -0,0 +1,431 @@
+/**
+ * @file bitmap_kernel.c
+ * @brief The bitmap formats of the Linux kernel
+ */
+
+#include <bitmap/bitmap_kernel.h>
+
+#include "bitmap_common.h"
+
+#include <string.h>
+
+/** @brief Amount of bits in the chunk of the hex mask */
+#define P_CHUNK_BITS (32)
+/** @brief Amount of hex digits in the chunk */
+#define P_CHUNK_DIGITS (8)
+/** @brief Step by the blocks in the chunk */
+#define P_CHUNK_STEP (BITMAP_BITS_IN_BLOCK() < P_CHUNK_BITS ? BITMAP_BITS_IN_BLOCK() : P_CHUNK_BITS)
+
+/** @brief SWAR: 0x01 in each byte */
+#define P_SWAR_ONES  UINT64_C(0x0101010101010101)
+/** @brief SWAR: 0x80 in each byte */
+#define P_SWAR_HIGHS UINT64_C(0x8080808080808080)
+/**
+ * @brief SWAR: 0x80 in each byte b of x, for which m < b < n
+ * @note The bytes above 0x7F are not in any range, m <= 127, n <= 128.
+ */
+#define P_SWAR_BETWEEN(x, m, n) \
+        (( \
+                (P_SWAR_ONES * (127 + (n)) - ((x) & (P_SWAR_ONES * 127))) & \
+                ~(x) & \
+                (((x) & (P_SWAR_ONES * 127)) + P_SWAR_ONES * (127 - (m))) \
+        ) & P_SWAR_HIGHS)
+
+/**
+ * @brief The output like snprintf(): the chars are cropped, the length is full
+ */
+struct P_output
+{
+    char * dest;
+    size_t size;
+    size_t length;
+};
+
+/**
+ * @brief The sink of bitmap_P_print_ranged8(), never fails
+ */
+static int P_output_write3(
+        void * ctx,
+        const char * data,
+        size_t len
+)
+{
+    struct P_output * output = ctx;
+    if(output->length + 1 < output->size)
+    {
+        size_t room = output->size - 1 - output->length;
+        memcpy(&output->dest[output->length], data, (len < room) ? len : room);
+    }
+    output->length += len;
+    return 0;
+}
+
+static size_t P_output_finish1(
+        struct P_output * output
+)
+{
+    if(output->size > 0)
+    {
+        output->dest[(output->length < output->size) ? output->length : (output->size - 1)] = '\0';
+    }
+    return output->length;
+}
+
+/**
+ * @brief The chunk of 32 bits, without the tail bits
+ */
+static uint32_t P_chunk_get3(
+        const bitmap_block_t * bitmap,
+        size_t bits_num,
+        size_t ichunk
+)
+{
+    size_t ibit_chunk = ichunk * P_CHUNK_BITS;
+    uint32_t chunk = 0;
+    size_t i;
+    for(i = 0; i < P_CHUNK_BITS && ibit_chunk + i < bits_num; i += P_CHUNK_STEP)
+    {
+        size_t ibit = ibit_chunk + i;
+        chunk |= (uint32_t)(bitmap[ibit / BITMAP_BITS_IN_BLOCK()] >> (ibit % BITMAP_BITS_IN_BLOCK())) << i;
+    }
+    if(bits_num - ibit_chunk < P_CHUNK_BITS)
+    {
+        chunk &= ((uint32_t)1 << (bits_num - ibit_chunk)) - 1;
+    }
+    return chunk;
+}
+
+/**
+ * @brief Raise the bits of the chunk, the chunk is in the bitmap
+ */
+static void P_chunk_raise3(
+        bitmap_block_t * bitmap,
+        size_t bits_num,
+        size_t ichunk,
+        uint32_t chunk
+)
+{
+    size_t ibit_chunk = ichunk * P_CHUNK_BITS;
+    size_t i;
+    for(i = 0; i < P_CHUNK_BITS && ibit_chunk + i < bits_num; i += P_CHUNK_STEP)
+    {
+        size_t ibit = ibit_chunk + i;
+        bitmap[ibit / BITMAP_BITS_IN_BLOCK()] |= (bitmap_block_t)((bitmap_block_t)(chunk >> i) << (ibit % BITMAP_BITS_IN_BLOCK()));
+    }
+}
+
+/**
+ * @brief Load 8 chars, the first one is the lowest byte
+ */
+static inline uint64_t P_load8(
+        const char * src
+)
+{
+    uint64_t chars = 0;
+    size_t i;
+    for(i = 0; i < 8; ++i)
+    {
+        chars |= (uint64_t)(uint8_t)src[i] << (i * 8);
+    }
+    return chars;
+}
+
+/**
+ * @brief Convert 1 to 8 hex digits to the chunk, all digits at once
+ * @return  0       OK
+ * @return -1       Not a hex digit
+ */
+static int P_hex_parse3(
+        const char * BITMAP_RESTRICT src,
+        size_t len,
+        uint32_t * BITMAP_RESTRICT chunk
+)
+{
+    uint64_t chars;
+    if(len == P_CHUNK_DIGITS)
+    {
+        chars = P_load8(src);
+    }
+    else
+    {
+        char padded[P_CHUNK_DIGITS];
+        memset(padded, '0', P_CHUNK_DIGITS - len);
+        memcpy(&padded[P_CHUNK_DIGITS - len], src, len);
+        chars = P_load8(padded);
+    }
+
+    /* 'A'..'F' to 'a'..'f', the digits are not changed */
+    uint64_t lower = chars | (P_SWAR_ONES * 0x20);
+    uint64_t digits = P_SWAR_BETWEEN(chars, '0' - 1, '9' + 1);
+    uint64_t letters = P_SWAR_BETWEEN(lower, 'a' - 1, 'f' + 1);
+    if((digits | letters) != P_SWAR_HIGHS)
+    {
+        return -1;
+    }
+    uint64_t nibbles = (chars & (P_SWAR_ONES * 0x0F)) + (letters >> 7) * 9;
+
+    /* the first char is the highest nibble */
+    nibbles = ((nibbles << 4) | (nibbles >> 8)) & UINT64_C(0x00FF00FF00FF00FF);
+    nibbles = ((nibbles << 8) | (nibbles >> 16)) & UINT64_C(0x0000FFFF0000FFFF);
+    (*chunk) = (uint32_t)((nibbles << 16) | (nibbles >> 32));
+    return 0;
+}
+
+/**
+ * @brief Convert the chunk to 8 hex digits, all digits at once
+ */
+static void P_hex_format2(
+        char * BITMAP_RESTRICT dest,
+        uint32_t chunk
+)
+{
+    uint64_t nibbles = (chunk >> 16) | ((uint64_t)(chunk & 0xFFFF) << 32);
+    nibbles = ((nibbles >> 8) & UINT64_C(0x000000FF000000FF)) | ((nibbles & UINT64_C(0x000000FF000000FF)) << 16);
+    nibbles = ((nibbles >> 4) & UINT64_C(0x000F000F000F000F)) | ((nibbles & UINT64_C(0x000F000F000F000F)) << 8);
+
+    uint64_t letters = (nibbles + P_SWAR_ONES * (0x80 - 10)) & P_SWAR_HIGHS;
+    uint64_t chars = nibbles + P_SWAR_ONES * '0' + (letters >> 7) * ('a' - '0' - 10);
+    size_t i;
+    for(i = 0; i < P_CHUNK_DIGITS; ++i)
+    {
+        dest[i] = (char)(chars >> (i * 8));
+    }
+}
+
+size_t bitmap_cpulist_format4(
+        char * BITMAP_RESTRICT dest,
+        size_t size,
+        const bitmap_block_t * BITMAP_RESTRICT bitmap,
+        size_t bits_num
+)
+{
+    struct P_output output = { dest, size, 0 };
+    bitmap_P_print_ranged8(P_output_write3, &output, bitmap, bits_num, ",", "-", true, NULL);
+    return P_output_finish1(&output);
+}
+
+/**
+ * @brief Is the char the end of the cpulist region
+ */
+static inline bool P_cpulist_separator1(
+        char ch
+)
+{
+    return ch == ',' || ch == '\0' || bitmap_P_is_space1(ch);
+}
+
+/**
+ * @brief Parse the bit of the cpulist region: the decimal index or "N", the last bit
+ */
+static int P_cpulist_index_parse5(
+        const char * BITMAP_RESTRICT src,
+        size_t size,
+        size_t * BITMAP_RESTRICT offset,
+        size_t bits_num,
+        size_t * BITMAP_RESTRICT index
+)
+{
+    if((*offset) < size && src[*offset] == 'N')
+    {
+        if(bits_num == 0)
+        {
+            return -1;
+        }
+        (*index) = bits_num - 1;
+        ++(*offset);
+        return 0;
+    }
+    return bitmap_P_index_parse5(src, size, offset, bits_num, index);
+}
+
+int bitmap_cpulist_parse5(
+        bitmap_block_t * BITMAP_RESTRICT bitmap,
+        size_t bits_num,
+        const char * BITMAP_RESTRICT src,
+        size_t size,
+        size_t * BITMAP_RESTRICT error_offset
+)
+{
+    bitmap_bitwise_clear2(bitmap, bits_num);
+
+    size_t offset = 0;
+    size_t offset_region;
+    while(1)
+    {
+        for(; offset < size && src[offset] != '\0' && P_cpulist_separator1(src[offset]); ++offset);
+        if(offset == size || src[offset] == '\0')
+        {
+            return 0;
+        }
+
+        offset_region = offset;
+        struct bitmap_range range;
+        size_t used = 1;
+        size_t group = 1;
+        if(P_cpulist_index_parse5(src, size, &offset, bits_num, &range.begin) != 0)
+        {
+            goto error;
+        }
+        range.end = range.begin;
+        if(offset < size && src[offset] == '-')
+        {
+            ++offset;
+            if(P_cpulist_index_parse5(src, size, &offset, bits_num, &range.end) != 0 || range.end < range.begin)
+            {
+                goto error;
+            }
+            used = group = range.end - range.begin + 1;
+            if(offset < size && src[offset] == ':')
+            {
+                ++offset;
+                if(
+                        bitmap_P_index_parse5(src, size, &offset, SIZE_MAX, &used) != 0 ||
+                        offset == size || src[offset] != '/'
+                )
+                {
+                    goto error;
+                }
+                ++offset;
+                if(bitmap_P_index_parse5(src, size, &offset, SIZE_MAX, &group) != 0 || group == 0 || used > group)
+                {
+                    goto error;
+                }
+            }
+        }
+        if(offset < size && !P_cpulist_separator1(src[offset]))
+        {
+            goto error;
+        }
+
+        if(used == group)
+        {
+            bitmap_bitwise_range_raise2(bitmap, &range);
+            continue;
+        }
+        if(used == 0)
+        {
+            continue;
+        }
+        size_t ibit = range.begin;
+        while(1)
+        {
+            struct bitmap_range part = { ibit, (range.end - ibit < used) ? range.end : (ibit + used - 1) };
+            bitmap_bitwise_range_raise2(bitmap, &part);
+            if(range.end - ibit < group)
+            {
+                break;
+            }
+            ibit += group;
+        }
+    }
+
+    error:
+    if(error_offset != NULL)
+    {
+        (*error_offset) = offset_region;
+    }
+    return -1;
+}
+
+size_t bitmap_cpumask_format4(
+        char * BITMAP_RESTRICT dest,
+        size_t size,
+        const bitmap_block_t * BITMAP_RESTRICT bitmap,
+        size_t bits_num
+)
+{
+    struct P_output output = { dest, size, 0 };
+    size_t chunks_num = (bits_num + P_CHUNK_BITS - 1) / P_CHUNK_BITS;
+    char digits[P_CHUNK_DIGITS];
+    size_t ichunk = chunks_num;
+
+    if(ichunk > 0)
+    {
+        --ichunk;
+        size_t digits_num = (bits_num - ichunk * P_CHUNK_BITS + 3) / 4;
+        P_hex_format2(digits, P_chunk_get3(bitmap, bits_num, ichunk));
+        P_output_write3(&output, &digits[P_CHUNK_DIGITS - digits_num], digits_num);
+    }
+    while(ichunk > 0)
+    {
+        --ichunk;
+        P_hex_format2(digits, P_chunk_get3(bitmap, bits_num, ichunk));
+        P_output_write3(&output, ",", 1);
+        P_output_write3(&output, digits, P_CHUNK_DIGITS);
+    }
+    return P_output_finish1(&output);
+}
+
+int bitmap_cpumask_parse5(
+        bitmap_block_t * BITMAP_RESTRICT bitmap,
+        size_t bits_num,
+        const char * BITMAP_RESTRICT src,
+        size_t size,
+        size_t * BITMAP_RESTRICT error_offset
+)
+{
+    bitmap_bitwise_clear2(bitmap, bits_num);
+
+    const char * nul = memchr(src, '\0', size);
+    size_t end = (nul != NULL) ? (size_t)(nul - src) : size;
+    size_t offset = 0;
+    for(; offset < end && bitmap_P_is_space1(src[offset]); ++offset);
+    for(; end > offset && bitmap_P_is_space1(src[end - 1]); --end);
+    if(offset == end)
+    {
+        return 0;
+    }
+
+    /* the lowest chunk is the last one */
+    size_t ichunk = 0;
+    const char * comma;
+    for(
+            comma = memchr(&src[offset], ',', end - offset);
+            comma != NULL;
+            comma = memchr(comma + 1, ',', (size_t)(&src[end] - (comma + 1)))
+    )
+    {
+        ++ichunk;
+    }
+
+    while(1)
+    {
+        comma = memchr(&src[offset], ',', end - offset);
+        size_t chunk_end = (comma != NULL) ? (size_t)(comma - src) : end;
+        size_t len = chunk_end - offset;
+        uint32_t chunk;
+        if(len == 0 || len > P_CHUNK_DIGITS || P_hex_parse3(&src[offset], len, &chunk) != 0)
+        {
+            goto error;
+        }
+
+        /* the zero chunks above the bitmap are allowed */
+        if(chunk != 0)
+        {
+            if(ichunk >= (bits_num + P_CHUNK_BITS - 1) / P_CHUNK_BITS)
+            {
+                goto error;
+            }
+            size_t chunk_bits_num = bits_num - ichunk * P_CHUNK_BITS;
+            if(chunk_bits_num < P_CHUNK_BITS && (chunk >> chunk_bits_num) != 0)
+            {
+                goto error;
+            }
+            P_chunk_raise3(bitmap, bits_num, ichunk, chunk);
+        }
+
+        if(comma == NULL)
+        {
+            return 0;
+        }
+        offset = chunk_end + 1;
+        --ichunk;
+    }
+
+    error:
+    if(error_offset != NULL)
+    {
+        (*error_offset) = offset;
+    }
+    return -1;
+}
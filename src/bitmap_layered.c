@@ -0,0 +1,292 @@
+/**
+ * @file bitmap_layered.c
+ * @brief Bitmap with the hierarchical summaries
+ */
+
+#include <bitmap/bitmap_layered.h>
+
+#include "bitmap_common.h"
+
+#include <stdlib.h>
+
+/** @brief The full block */
+#define P_FULL ((bitmap_block_t)~(bitmap_block_t)0)
+
+/** @brief The bit in the block */
+#define P_BIT(xindex) ((bitmap_block_t)1 << ((xindex) % BITMAP_BITS_IN_BLOCK()))
+
+/**
+ * @brief Is the block of the level full?
+ * @details The padding of the summaries is raised, the padding of the bitmap is cleared.
+ */
+static bool P_block_full3(
+        const bitmap_layered_t * layered,
+        size_t level,
+        size_t iblock
+)
+{
+    bitmap_block_t block = layered->full[level][iblock];
+    if(level == 0 && iblock == BITMAP_BITS_TO_BLOCKS_ALIGNED(layered->bits_num) - 1)
+    {
+        block |= ~bitmap_P_tailblock_mask(layered->bits_num);
+    }
+    return block == P_FULL;
+}
+
+/**
+ * @brief Build the summaries from the bitmap
+ */
+static void P_levels_build1(
+        bitmap_layered_t * layered
+)
+{
+    size_t level;
+    for(level = 1; level < layered->levels_num; ++level)
+    {
+        size_t bits_num = layered->sizes[level];
+        size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
+        bitmap_block_t * nonzero = layered->nonzero[level];
+        bitmap_block_t * full = layered->full[level];
+
+        bitmap_bitwise_clear2(nonzero, bits_num);
+        bitmap_bitwise_clear2(full, bits_num);
+        full[blocks_num - 1] = ~bitmap_P_tailblock_mask(bits_num);
+
+        size_t index;
+        for(index = 0; index < bits_num; ++index)
+        {
+            if(layered->nonzero[level - 1][index] != 0)
+            {
+                nonzero[index / BITMAP_BITS_IN_BLOCK()] |= P_BIT(index);
+            }
+            if(P_block_full3(layered, level - 1, index))
+            {
+                full[index / BITMAP_BITS_IN_BLOCK()] |= P_BIT(index);
+            }
+        }
+    }
+}
+
+int bitmap_layered_create2(
+        bitmap_layered_t * layered,
+        size_t bits_num
+)
+{
+    size_t levels_num = 1;
+    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
+    size_t summaries_blocks_num = 0;
+    size_t size = bits_num;
+    while(size > BITMAP_BITS_IN_BLOCK())
+    {
+        size = BITMAP_BITS_TO_BLOCKS_ALIGNED(size);
+        summaries_blocks_num += BITMAP_BITS_TO_BLOCKS_ALIGNED(size);
+        ++levels_num;
+    }
+
+    /* one allocation, the items are placed by descending alignment */
+    void * data = malloc(
+            levels_num * 2 * sizeof(bitmap_block_t *) +
+            levels_num * sizeof(size_t) +
+            (blocks_num + summaries_blocks_num * 2 + 1) * sizeof(bitmap_block_t)
+    );
+    if(data == NULL)
+    {
+        return -1;
+    }
+
+    layered->bits_num = bits_num;
+    layered->levels_num = levels_num;
+    layered->nonzero = data;
+    layered->full = &layered->nonzero[levels_num];
+    layered->sizes = (size_t *)&layered->full[levels_num];
+
+    bitmap_block_t * blocks = (bitmap_block_t *)&layered->sizes[levels_num];
+    layered->sizes[0] = bits_num;
+    layered->nonzero[0] = blocks;
+    layered->full[0] = blocks;
+    blocks += blocks_num;
+
+    size_t level;
+    for(level = 1; level < levels_num; ++level)
+    {
+        size = BITMAP_BITS_TO_BLOCKS_ALIGNED(layered->sizes[level - 1]);
+        layered->sizes[level] = size;
+        layered->nonzero[level] = blocks;
+        blocks += BITMAP_BITS_TO_BLOCKS_ALIGNED(size);
+        layered->full[level] = blocks;
+        blocks += BITMAP_BITS_TO_BLOCKS_ALIGNED(size);
+    }
+
+    bitmap_bitwise_clear2(layered->nonzero[0], bits_num);
+    P_levels_build1(layered);
+    return 0;
+}
+
+void bitmap_layered_destroy1(
+        bitmap_layered_t * layered
+)
+{
+    free(layered->nonzero);
+    layered->nonzero = NULL;
+    layered->full = NULL;
+    layered->sizes = NULL;
+}
+
+void bitmap_layered_assign2(
+        bitmap_layered_t * BITMAP_RESTRICT layered,
+        const bitmap_block_t * BITMAP_RESTRICT src
+)
+{
+    size_t blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(layered->bits_num);
+    if(blocks_num == 0)
+    {
+        return;
+    }
+    bitmap_bitwise_copy3(layered->nonzero[0], src, layered->bits_num);
+    layered->nonzero[0][blocks_num - 1] &= bitmap_P_tailblock_mask(layered->bits_num);
+    P_levels_build1(layered);
+}
+
+void bitmap_layered_bit_raise2(
+        bitmap_layered_t * layered,
+        size_t bit_index
+)
+{
+    size_t iblock = bit_index / BITMAP_BITS_IN_BLOCK();
+    bitmap_block_t block = layered->nonzero[0][iblock];
+    if(block & P_BIT(bit_index))
+    {
+        return;
+    }
+    layered->nonzero[0][iblock] = block | P_BIT(bit_index);
+
+    size_t level;
+    size_t index;
+    /* the block was zero: up to the level, where the block was not zero */
+    index = bit_index;
+    for(level = 1; level < layered->levels_num && block == 0; ++level)
+    {
+        index /= BITMAP_BITS_IN_BLOCK();
+        bitmap_block_t * summary = &layered->nonzero[level][index / BITMAP_BITS_IN_BLOCK()];
+        block = *summary;
+        *summary = block | P_BIT(index);
+    }
+    /* the block is full now: up to the level, where the block is not full */
+    index = bit_index;
+    for(level = 1; level < layered->levels_num && P_block_full3(layered, level - 1, index / BITMAP_BITS_IN_BLOCK()); ++level)
+    {
+        index /= BITMAP_BITS_IN_BLOCK();
+        layered->full[level][index / BITMAP_BITS_IN_BLOCK()] |= P_BIT(index);
+    }
+}
+
+void bitmap_layered_bit_clear2(
+        bitmap_layered_t * layered,
+        size_t bit_index
+)
+{
+    size_t iblock = bit_index / BITMAP_BITS_IN_BLOCK();
+    bitmap_block_t block = layered->nonzero[0][iblock];
+    if(!(block & P_BIT(bit_index)))
+    {
+        return;
+    }
+    bool full = P_block_full3(layered, 0, iblock);
+    layered->nonzero[0][iblock] = block & ~P_BIT(bit_index);
+
+    size_t level;
+    size_t index;
+    /* the block is zero now: up to the level, where the block is not zero */
+    index = bit_index;
+    for(level = 1; level < layered->levels_num && layered->nonzero[level - 1][index / BITMAP_BITS_IN_BLOCK()] == 0; ++level)
+    {
+        index /= BITMAP_BITS_IN_BLOCK();
+        layered->nonzero[level][index / BITMAP_BITS_IN_BLOCK()] &= ~P_BIT(index);
+    }
+    /* the block was full: up to the level, where the block was not full */
+    index = bit_index;
+    for(level = 1; level < layered->levels_num && full; ++level)
+    {
+        index /= BITMAP_BITS_IN_BLOCK();
+        bitmap_block_t * summary = &layered->full[level][index / BITMAP_BITS_IN_BLOCK()];
+        full = (*summary == P_FULL);
+        *summary &= ~P_BIT(index);
+    }
+}
+
+/**
+ * @brief Find "forward" the nearest raised bit of the levels, inverted by the mask
+ * @param levels        The nonzero or the full levels.
+ * @param invert        0 for the nonzero levels, P_FULL for the full levels.
+ */
+static void P_nearest_forward_get5(
+        const bitmap_layered_t * layered,
+        bitmap_block_t * const * levels,
+        bitmap_block_t invert,
+        size_t bit_index_from,
+        bitmap_bit_nearest_get_context_t * bit_nearest
+)
+{
+    bit_nearest->exist = false;
+    if(bit_index_from >= layered->bits_num)
+    {
+        return;
+    }
+
+    /* up to the level with the found bit */
+    size_t level = 0;
+    size_t index = bit_index_from;
+    for(;;)
+    {
+        size_t iblock = index / BITMAP_BITS_IN_BLOCK();
+        bitmap_block_t block = (bitmap_block_t)((levels[level][iblock] ^ invert) & (P_FULL << (index % BITMAP_BITS_IN_BLOCK())));
+        if(block != 0)
+        {
+            index = iblock * BITMAP_BITS_IN_BLOCK() + CTZ(block);
+            break;
+        }
+        if(++level == layered->levels_num)
+        {
+            return;
+        }
+        /* the next block of the level below */
+        index = iblock + 1;
+        if(index >= layered->sizes[level])
+        {
+            return;
+        }
+    }
+
+    /* down by the first found bit */
+    while(level > 0)
+    {
+        --level;
+        index = index * BITMAP_BITS_IN_BLOCK() + CTZ((bitmap_block_t)(levels[level][index] ^ invert));
+    }
+
+    /* the cleared padding of the bitmap */
+    if(index >= layered->bits_num)
+    {
+        return;
+    }
+    bit_nearest->exist = true;
+    bit_nearest->index = index;
+}
+
+void bitmap_layered_nearest_forward_raised_get3(
+        const bitmap_layered_t * layered,
+        size_t bit_index_from,
+        bitmap_bit_nearest_get_context_t * bit_nearest
+)
+{
+    P_nearest_forward_get5(layered, layered->nonzero, 0, bit_index_from, bit_nearest);
+}
+
+void bitmap_layered_nearest_forward_cleared_get3(
+        const bitmap_layered_t * layered,
+        size_t bit_index_from,
+        bitmap_bit_nearest_get_context_t * bit_nearest
+)
+{
+    P_nearest_forward_get5(layered, layered->full, P_FULL, bit_index_from, bit_nearest);
+}
@@ -0,0 +1,364 @@
+/**
+ * @file bitmap_parallel.c
+ * @brief Multi-threaded bulk operations on the big bitmaps
+ */
+
+#include <bitmap/bitmap_parallel.h>
+
+#include "bitmap_common.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/** @brief Amount of blocks in the cache line */
+#define P_LINE_BLOCKS \
+        ((BITMAP_PARALLEL_CACHE_LINE > sizeof(bitmap_block_t)) ? (BITMAP_PARALLEL_CACHE_LINE / sizeof(bitmap_block_t)) : 1)
+
+/**
+ * @brief The built-in pool
+ * @details One job at a time. The job is posted when no thread works on the previous one,
+ *          so the late thread does not take the parts of the next job.
+ */
+struct P_pool
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t start;       /**< The new job or the exit */
+    pthread_cond_t done;        /**< The part or the thread is done */
+    bool exit;
+    bool busy;                  /**< The job is running */
+    size_t generation;          /**< The number of the job */
+    size_t active;              /**< Amount of threads, which work on the job */
+    bitmap_parallel_task_t task;
+    void * arg;
+    size_t parts_num;
+    size_t parts_next;          /**< The next part to take, atomic */
+    size_t parts_done;
+    size_t threads_num;         /**< Amount of the started threads */
+    pthread_t threads[];
+};
+
+/**
+ * @brief Take and run the parts of the current job
+ * @return Amount of the done parts
+ */
+static size_t P_pool_parts_run1(
+        struct P_pool * pool
+)
+{
+    size_t done = 0;
+    size_t ipart;
+    while((ipart = __atomic_fetch_add(&pool->parts_next, 1, __ATOMIC_RELAXED)) < pool->parts_num)
+    {
+        pool->task(pool->arg, ipart);
+        ++done;
+    }
+    return done;
+}
+
+static void * P_pool_thread(
+        void * arg
+)
+{
+    struct P_pool * pool = arg;
+    size_t generation = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    for(;;)
+    {
+        while(!pool->exit && pool->generation == generation)
+        {
+            pthread_cond_wait(&pool->start, &pool->mutex);
+        }
+        if(pool->exit)
+        {
+            break;
+        }
+        generation = pool->generation;
+        ++pool->active;
+        pthread_mutex_unlock(&pool->mutex);
+
+        size_t done = P_pool_parts_run1(pool);
+
+        pthread_mutex_lock(&pool->mutex);
+        pool->parts_done += done;
+        --pool->active;
+        pthread_cond_broadcast(&pool->done);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    return NULL;
+}
+
+static void P_pool_run(
+        void * ctx,
+        bitmap_parallel_task_t task,
+        void * arg,
+        size_t parts_num
+)
+{
+    struct P_pool * pool = ctx;
+
+    pthread_mutex_lock(&pool->mutex);
+    while(pool->busy || pool->active > 0)
+    {
+        pthread_cond_wait(&pool->done, &pool->mutex);
+    }
+    pool->busy = true;
+    pool->task = task;
+    pool->arg = arg;
+    pool->parts_num = parts_num;
+    pool->parts_next = 0;
+    pool->parts_done = 0;
+    ++pool->generation;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->mutex);
+
+    size_t done = P_pool_parts_run1(pool);
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->parts_done += done;
+    while(pool->parts_done < parts_num)
+    {
+        pthread_cond_wait(&pool->done, &pool->mutex);
+    }
+    pool->busy = false;
+    pthread_cond_broadcast(&pool->done);
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+/**
+ * @brief Stop the started threads and free the pool
+ */
+static void P_pool_free1(
+        struct P_pool * pool
+)
+{
+    pthread_mutex_lock(&pool->mutex);
+    pool->exit = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->mutex);
+
+    size_t ithread;
+    for(ithread = 0; ithread < pool->threads_num; ++ithread)
+    {
+        pthread_join(pool->threads[ithread], NULL);
+    }
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->mutex);
+    free(pool);
+}
+
+int bitmap_parallel_pool_create2(
+        bitmap_parallel_executor_t * executor,
+        size_t threads_num
+)
+{
+    if(threads_num == 0)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads_num = (cpus > 0) ? (size_t)cpus : 1;
+    }
+
+    struct P_pool * pool = malloc(sizeof(struct P_pool) + (threads_num - 1) * sizeof(pthread_t));
+    if(pool == NULL)
+    {
+        return -1;
+    }
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    pool->exit = false;
+    pool->busy = false;
+    pool->generation = 0;
+    pool->active = 0;
+    pool->threads_num = 0;
+
+    while(pool->threads_num < threads_num - 1)
+    {
+        if(pthread_create(&pool->threads[pool->threads_num], NULL, P_pool_thread, pool) != 0)
+        {
+            P_pool_free1(pool);
+            return -1;
+        }
+        ++pool->threads_num;
+    }
+
+    executor->run = P_pool_run;
+    executor->ctx = pool;
+    executor->threads_num = threads_num;
+    executor->bits_min = BITMAP_PARALLEL_BITS_MIN;
+    return 0;
+}
+
+void bitmap_parallel_pool_destroy1(
+        bitmap_parallel_executor_t * executor
+)
+{
+    P_pool_free1(executor->ctx);
+    executor->run = NULL;
+    executor->ctx = NULL;
+}
+
+/** @brief The operation */
+enum P_operation
+{
+    P_OPERATION__NOT,
+    P_OPERATION__OR,
+    P_OPERATION__AND,
+    P_OPERATION__CLEAR,
+    P_OPERATION__POWER,
+};
+
+/** @brief The parallel job */
+struct P_job
+{
+    enum P_operation operation;
+    bitmap_block_t * dest;
+    const bitmap_block_t * a;
+    const bitmap_block_t * b;
+    size_t bits_num;
+    size_t blocks_num;
+    size_t head;                /**< Amount of blocks before the first cache line border */
+    size_t part_blocks;         /**< Amount of blocks in the part, whole cache lines */
+    size_t power;               /**< The power, atomic */
+};
+
+static void P_job_task(
+        void * arg,
+        size_t ipart
+)
+{
+    struct P_job * job = arg;
+
+    /* the first part ends at the cache line border, the last part takes the tail */
+    size_t iblock_begin = (ipart == 0) ? 0 : ipart * job->part_blocks - job->head;
+    size_t iblock_end = (ipart + 1) * job->part_blocks - job->head;
+    if(iblock_begin >= job->blocks_num)
+    {
+        return;
+    }
+    size_t bits_num = (iblock_end >= job->blocks_num) ?
+            job->bits_num - BITMAP_BLOCKS_TO_BITS_ALIGNED(iblock_begin) :
+            BITMAP_BLOCKS_TO_BITS_ALIGNED(iblock_end - iblock_begin);
+
+    const bitmap_block_t * a = &job->a[iblock_begin];
+    switch(job->operation)
+    {
+        case P_OPERATION__NOT:
+            bitmap_bitwise_not3(&job->dest[iblock_begin], a, bits_num);
+            break;
+        case P_OPERATION__OR:
+            bitmap_bitwise_or4(&job->dest[iblock_begin], a, &job->b[iblock_begin], bits_num);
+            break;
+        case P_OPERATION__AND:
+            bitmap_bitwise_and4(&job->dest[iblock_begin], a, &job->b[iblock_begin], bits_num);
+            break;
+        case P_OPERATION__CLEAR:
+            bitmap_bitwise_clear4(&job->dest[iblock_begin], a, &job->b[iblock_begin], bits_num);
+            break;
+        case P_OPERATION__POWER:
+            __atomic_fetch_add(&job->power, bitmap_bitwise_power2(a, bits_num), __ATOMIC_RELAXED);
+            break;
+    }
+}
+
+/**
+ * @brief Split the job to the parts and run it
+ * @param aligned       The bitmap, to which cache lines the parts are aligned.
+ * @return false, if the job must be processed serially
+ */
+static bool P_job_run3(
+        const bitmap_parallel_executor_t * executor,
+        struct P_job * job,
+        const bitmap_block_t * aligned
+)
+{
+    if(executor == NULL || executor->threads_num < 2 || job->bits_num == 0 || job->bits_num < executor->bits_min)
+    {
+        return false;
+    }
+
+    job->blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(job->bits_num);
+    job->head = (size_t)(((uintptr_t)aligned / sizeof(bitmap_block_t)) % P_LINE_BLOCKS);
+    size_t lines_num = (job->head + job->blocks_num + P_LINE_BLOCKS - 1) / P_LINE_BLOCKS;
+    size_t parts_num = (lines_num < executor->threads_num) ? lines_num : executor->threads_num;
+    job->part_blocks = (lines_num + parts_num - 1) / parts_num * P_LINE_BLOCKS;
+
+    executor->run(executor->ctx, P_job_task, job, parts_num);
+    return true;
+}
+
+void bitmap_parallel_bitwise_not4(
+        const bitmap_parallel_executor_t * executor,
+        bitmap_block_t * BITMAP_RESTRICT dest,
+        const bitmap_block_t * BITMAP_RESTRICT src,
+        size_t bits_num
+)
+{
+    struct P_job job = { .operation = P_OPERATION__NOT, .dest = dest, .a = src, .bits_num = bits_num };
+    if(!P_job_run3(executor, &job, dest))
+    {
+        bitmap_bitwise_not3(dest, src, bits_num);
+    }
+}
+
+void bitmap_parallel_bitwise_or5(
+        const bitmap_parallel_executor_t * executor,
+        bitmap_block_t * BITMAP_RESTRICT dest,
+        const bitmap_block_t * BITMAP_RESTRICT a,
+        const bitmap_block_t * BITMAP_RESTRICT b,
+        size_t bits_num
+)
+{
+    struct P_job job = { .operation = P_OPERATION__OR, .dest = dest, .a = a, .b = b, .bits_num = bits_num };
+    if(!P_job_run3(executor, &job, dest))
+    {
+        bitmap_bitwise_or4(dest, a, b, bits_num);
+    }
+}
+
+void bitmap_parallel_bitwise_and5(
+        const bitmap_parallel_executor_t * executor,
+        bitmap_block_t * BITMAP_RESTRICT dest,
+        const bitmap_block_t * BITMAP_RESTRICT a,
+        const bitmap_block_t * BITMAP_RESTRICT b,
+        size_t bits_num
+)
+{
+    struct P_job job = { .operation = P_OPERATION__AND, .dest = dest, .a = a, .b = b, .bits_num = bits_num };
+    if(!P_job_run3(executor, &job, dest))
+    {
+        bitmap_bitwise_and4(dest, a, b, bits_num);
+    }
+}
+
+void bitmap_parallel_bitwise_clear5(
+        const bitmap_parallel_executor_t * executor,
+        bitmap_block_t * BITMAP_RESTRICT dest,
+        const bitmap_block_t * BITMAP_RESTRICT a,
+        const bitmap_block_t * BITMAP_RESTRICT b,
+        size_t bits_num
+)
+{
+    struct P_job job = { .operation = P_OPERATION__CLEAR, .dest = dest, .a = a, .b = b, .bits_num = bits_num };
+    if(!P_job_run3(executor, &job, dest))
+    {
+        bitmap_bitwise_clear4(dest, a, b, bits_num);
+    }
+}
+
+size_t bitmap_parallel_bitwise_power3(
+        const bitmap_parallel_executor_t * executor,
+        const bitmap_block_t * BITMAP_RESTRICT src,
+        size_t bits_num
+)
+{
+    struct P_job job = { .operation = P_OPERATION__POWER, .a = src, .bits_num = bits_num };
+    if(!P_job_run3(executor, &job, src))
+    {
+        return bitmap_bitwise_power2(src, bits_num);
+    }
+    return job.power;
+}
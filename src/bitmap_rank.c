@@ -0,0 +1,235 @@
+/**
+ * @file bitmap_rank.c
+ * @brief Rank/select index over a bitmap
+ */
+
+#include <bitmap/bitmap_rank.h>
+
+#include "bitmap_common.h"
+#include "bitmap_simd.h"
+
+#include <stdlib.h>
+
+/** @brief Amount of blocks in the basic block: 512 bits */
+#define P_BASIC_BLOCKS (8)
+/** @brief Amount of blocks in the superblock: 65536 bits, the relative counters fit uint16_t */
+#define P_SUPER_BLOCKS (1024)
+/** @brief Rank distance between the select samples */
+#define P_SAMPLE_RANKS (8192)
+
+/**
+ * @brief Sizes of the arrays of the index
+ */
+struct P_rank_sizes
+{
+    size_t blocks_num;
+    size_t superblocks_num;
+    size_t samples_num;
+    size_t basicblocks_num;
+};
+
+static void P_rank_sizes_get2(
+        struct P_rank_sizes * sizes,
+        size_t bits_num
+)
+{
+    sizes->blocks_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num);
+    sizes->superblocks_num = (sizes->blocks_num + P_SUPER_BLOCKS - 1) / P_SUPER_BLOCKS;
+    sizes->samples_num = bits_num / P_SAMPLE_RANKS + 1;
+    sizes->basicblocks_num = (sizes->blocks_num + P_BASIC_BLOCKS - 1) / P_BASIC_BLOCKS;
+}
+
+int bitmap_rank_create3(
+        bitmap_rank_t * rank,
+        const bitmap_block_t * bitmap,
+        size_t bits_num
+)
+{
+    struct P_rank_sizes sizes;
+    P_rank_sizes_get2(&sizes, bits_num);
+
+    /* one allocation, the items are placed by descending alignment */
+    void * data = malloc(
+            (sizes.superblocks_num + 1) * sizeof(uint64_t) +
+            sizes.samples_num * sizeof(size_t) +
+            sizes.basicblocks_num * sizeof(uint16_t)
+    );
+    if(data == NULL)
+    {
+        return -1;
+    }
+
+    rank->bitmap = bitmap;
+    rank->bits_num = bits_num;
+    rank->superblocks = data;
+    rank->samples = (size_t *)&rank->superblocks[sizes.superblocks_num + 1];
+    rank->basicblocks = (uint16_t *)&rank->samples[sizes.samples_num];
+
+    bitmap_rank_update1(rank);
+    return 0;
+}
+
+void bitmap_rank_destroy1(
+        bitmap_rank_t * rank
+)
+{
+    free(rank->superblocks);
+    rank->superblocks = NULL;
+    rank->samples = NULL;
+    rank->basicblocks = NULL;
+}
+
+void bitmap_rank_update1(
+        bitmap_rank_t * rank
+)
+{
+    struct P_rank_sizes sizes;
+    P_rank_sizes_get2(&sizes, rank->bits_num);
+
+    const bitmap_block_t * bitmap = rank->bitmap;
+    size_t power = 0;
+    size_t superblock_power = 0;
+    size_t iblock;
+    for(iblock = 0; iblock < sizes.blocks_num; iblock += P_BASIC_BLOCKS)
+    {
+        if(iblock % P_SUPER_BLOCKS == 0)
+        {
+            rank->superblocks[iblock / P_SUPER_BLOCKS] = power;
+            superblock_power = power;
+        }
+        rank->basicblocks[iblock / P_BASIC_BLOCKS] = (uint16_t)(power - superblock_power);
+
+        size_t blocks_num = sizes.blocks_num - iblock;
+        if(blocks_num > P_BASIC_BLOCKS)
+        {
+            power += bitmap_P_simd_power->power(&bitmap[iblock], P_BASIC_BLOCKS);
+        }
+        else
+        {
+            /* the tail block */
+            power += bitmap_P_simd_power->power(&bitmap[iblock], blocks_num - 1);
+            power += POPCOUNT(bitmap[sizes.blocks_num - 1] & bitmap_P_tailblock_mask(rank->bits_num));
+        }
+    }
+    rank->superblocks[sizes.superblocks_num] = power;
+    rank->power = power;
+
+    size_t isample = 0;
+    size_t isuperblock;
+    for(isuperblock = 0; isuperblock < sizes.superblocks_num; ++isuperblock)
+    {
+        for(; isample * P_SAMPLE_RANKS < rank->superblocks[isuperblock + 1]; ++isample)
+        {
+            rank->samples[isample] = isuperblock;
+        }
+    }
+}
+
+size_t bitmap_rank_rank2(
+        const bitmap_rank_t * rank,
+        size_t bit_index
+)
+{
+    if(bit_index >= rank->bits_num)
+    {
+        return rank->power;
+    }
+
+    const bitmap_block_t * bitmap = rank->bitmap;
+    size_t iblock = bit_index / BITMAP_BITS_IN_BLOCK();
+    size_t power = rank->superblocks[iblock / P_SUPER_BLOCKS] + rank->basicblocks[iblock / P_BASIC_BLOCKS];
+    size_t i;
+    for(i = iblock - iblock % P_BASIC_BLOCKS; i < iblock; ++i)
+    {
+        power += POPCOUNT(bitmap[i]);
+    }
+    /* bits of the block before bit_index */
+    power += POPCOUNT(bitmap[iblock] & (BITMAP_RAISED_BIT(bit_index % BITMAP_BITS_IN_BLOCK()) - 1));
+    return power;
+}
+
+/**
+ * @brief Define the search of the last counter in range [lo; hi], which is not above the rank
+ * @param xname     Name of the function
+ * @param xtype     Type of the counter
+ */
+#define P_DEFINE_COUNTER_SEARCH(xname, xtype) \
+        static inline size_t xname( \
+                const xtype * counters, \
+                size_t lo, \
+                size_t hi, \
+                size_t bit_rank \
+        ) \
+        { \
+            while(lo < hi) \
+            { \
+                size_t mid = lo + (hi - lo + 1) / 2; \
+                if(counters[mid] <= bit_rank) \
+                { \
+                    lo = mid; \
+                } \
+                else \
+                { \
+                    hi = mid - 1; \
+                } \
+            } \
+            return lo; \
+        }
+
+P_DEFINE_COUNTER_SEARCH(P_superblock_search4, uint64_t)
+P_DEFINE_COUNTER_SEARCH(P_basicblock_search4, uint16_t)
+
+int bitmap_rank_select3(
+        const bitmap_rank_t * BITMAP_RESTRICT rank,
+        size_t bit_rank,
+        size_t * BITMAP_RESTRICT bit_index
+)
+{
+    if(bit_rank >= rank->power)
+    {
+        return -1;
+    }
+
+    struct P_rank_sizes sizes;
+    P_rank_sizes_get2(&sizes, rank->bits_num);
+
+    /* the superblock is between the samples */
+    size_t isample = bit_rank / P_SAMPLE_RANKS;
+    size_t isuperblock = P_superblock_search4(
+            rank->superblocks,
+            rank->samples[isample],
+            ((isample + 1) * P_SAMPLE_RANKS < rank->power) ? rank->samples[isample + 1] : sizes.superblocks_num - 1,
+            bit_rank
+    );
+    bit_rank -= rank->superblocks[isuperblock];
+
+    size_t ibasicblock_begin = isuperblock * (P_SUPER_BLOCKS / P_BASIC_BLOCKS);
+    size_t ibasicblock_end = ibasicblock_begin + (P_SUPER_BLOCKS / P_BASIC_BLOCKS);
+    if(ibasicblock_end > sizes.basicblocks_num)
+    {
+        ibasicblock_end = sizes.basicblocks_num;
+    }
+    size_t ibasicblock = P_basicblock_search4(rank->basicblocks, ibasicblock_begin, ibasicblock_end - 1, bit_rank);
+    bit_rank -= rank->basicblocks[ibasicblock];
+
+    const bitmap_block_t * bitmap = rank->bitmap;
+    size_t iblock = ibasicblock * P_BASIC_BLOCKS;
+    bitmap_block_t block;
+    for(;; ++iblock)
+    {
+        block = bitmap[iblock];
+        if(iblock + 1 == sizes.blocks_num)
+        {
+            block &= bitmap_P_tailblock_mask(rank->bits_num);
+        }
+        size_t power = POPCOUNT(block);
+        if(bit_rank < power)
+        {
+            break;
+        }
+        bit_rank -= power;
+    }
+
+    (*bit_index) = iblock * BITMAP_BITS_IN_BLOCK() + bitmap_P_select(block, bit_rank);
+    return 0;
+}
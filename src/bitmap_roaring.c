@@ -0,0 +1,1399 @@
+/**
+ * @file bitmap_roaring.c
+ * @brief Compressed bitmap of the 32-bit indexes
+ */
+
+#include <bitmap/bitmap_roaring.h>
+#include <bitmap/bitmap4096.h>
+
+#include "bitmap_common.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/** @brief Bits of the index inside the chunk */
+#define P_CHUNK_SHIFT (12)
+/** @brief Mask of the index inside the chunk */
+#define P_CHUNK_MASK (BITMAP4096_BITS_NUM - 1)
+/** @brief Amount of the indexes, while the array is not above the dense chunk */
+#define P_ARRAY_MAX (sizeof(bitmap4096_t) / sizeof(uint16_t))
+
+/** @brief Type of the chunk container */
+enum P_container
+{
+    P_CONTAINER__ARRAY, /**< Sorted array of the indexes */
+    P_CONTAINER__DENSE, /**< bitmap4096_t */
+    P_CONTAINER__RUN,   /**< Sorted array of the runs */
+};
+
+/** @brief The run of raised bits */
+struct P_run
+{
+    uint16_t begin; /**< The first bit */
+    uint16_t end;   /**< The last bit */
+};
+
+/** @brief Amount of the runs, while the runs are below the dense chunk */
+#define P_RUNS_MAX (sizeof(bitmap4096_t) / sizeof(struct P_run))
+
+struct bitmap_P_roaring_chunk
+{
+    uint32_t key;               /**< High bits of the indexes */
+    enum P_container type;      /**< Type of the container */
+    uint16_t power;             /**< Amount of raised bits, 1 .. BITMAP4096_BITS_NUM */
+    uint16_t items_num;         /**< Amount of the indexes or runs */
+    uint16_t items_capacity;    /**< Amount of the allocated indexes or runs */
+    union
+    {
+        uint16_t * values;
+        struct P_run * runs;
+        bitmap4096_t * dense;
+    } container;                /**< The container */
+};
+
+typedef struct bitmap_P_roaring_chunk P_chunk_t;
+
+static void P_chunk_free1(
+        P_chunk_t * chunk
+)
+{
+    free(chunk->container.values);
+    chunk->container.values = NULL;
+}
+
+/**
+ * @brief Raise the bits of the chunk in the dense bitmap
+ */
+static void P_chunk_dense_fill2(
+        bitmap4096_t * BITMAP_RESTRICT dense,
+        const P_chunk_t * BITMAP_RESTRICT chunk
+)
+{
+    size_t i;
+    switch(chunk->type)
+    {
+        case P_CONTAINER__ARRAY:
+        {
+            bitmap4096_clear1(dense);
+            for(i = 0; i < chunk->items_num; ++i)
+            {
+                bitmap4096_bit_raise2(dense, chunk->container.values[i]);
+            }
+            break;
+        }
+        case P_CONTAINER__DENSE:
+        {
+            bitmap4096_copy2(dense, chunk->container.dense);
+            break;
+        }
+        case P_CONTAINER__RUN:
+        {
+            bitmap4096_clear1(dense);
+            for(i = 0; i < chunk->items_num; ++i)
+            {
+                struct bitmap_range range = { chunk->container.runs[i].begin, chunk->container.runs[i].end };
+                bitmap_bitwise_range_raise2(dense->data, &range);
+            }
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Amount of the runs of raised bits in the dense bitmap
+ */
+static size_t P_dense_runs_num1(
+        const bitmap4096_t * dense
+)
+{
+    size_t runs_num = 0;
+    bitmap_block_t carry = 0;
+    size_t iblock;
+    BITMAP_FOREACH_BLOCK(iblock, BITMAP_BITS_TO_BLOCKS_ALIGNED(BITMAP4096_BITS_NUM))
+    {
+        bitmap_block_t block = dense->data[iblock];
+        /* the first bits of the runs */
+        runs_num += POPCOUNT(block & ~((block << 1) | carry));
+        carry = block >> (BITMAP_BITS_IN_BLOCK() - 1);
+    }
+    return runs_num;
+}
+
+/**
+ * @brief Build the chunk of the smallest container from the dense bitmap
+ * @param chunk     The chunk to build, power is 0 if the dense bitmap is empty
+ * @param key       Key of the chunk
+ * @param dense     The dense bitmap
+ * @return  0       OK
+ * @return -1       No memory
+ */
+static int P_chunk_from_dense3(
+        P_chunk_t * BITMAP_RESTRICT chunk,
+        uint32_t key,
+        const bitmap4096_t * BITMAP_RESTRICT dense
+)
+{
+    size_t power = bitmap_bitwise_power2(dense->data, BITMAP4096_BITS_NUM);
+
+    chunk->key = key;
+    chunk->power = (uint16_t)power;
+    chunk->items_num = 0;
+    chunk->items_capacity = 0;
+    chunk->container.values = NULL;
+    if(power == 0)
+    {
+        return 0;
+    }
+
+    size_t runs_num = P_dense_runs_num1(dense);
+    size_t array_size = power * sizeof(uint16_t);
+    size_t runs_size = runs_num * sizeof(struct P_run);
+
+    if(array_size <= runs_size && power <= P_ARRAY_MAX)
+    {
+        chunk->type = P_CONTAINER__ARRAY;
+        chunk->container.values = malloc(array_size);
+        if(chunk->container.values == NULL)
+        {
+            return -1;
+        }
+        bitmap4096_foreach_bit_context_t ctx;
+        size_t ibit;
+        BITMAP4096_FOREACH_BIT_IN_BITMAP(&ibit, dense->data, &ctx)
+        {
+            chunk->container.values[chunk->items_num++] = (uint16_t)ibit;
+        }
+        chunk->items_capacity = chunk->items_num;
+    }
+    else if(runs_size < sizeof(bitmap4096_t))
+    {
+        chunk->type = P_CONTAINER__RUN;
+        chunk->container.runs = malloc(runs_size);
+        if(chunk->container.runs == NULL)
+        {
+            return -1;
+        }
+        bitmap_bit_nearest_get_context_t begin;
+        bitmap_bit_nearest_get_context_t end;
+        for(
+                bitmap_bit_nearest_forward_raised_get4(dense->data, BITMAP4096_BITS_NUM, 0, &begin);
+                begin.exist;
+                bitmap_bit_nearest_forward_raised_get4(dense->data, BITMAP4096_BITS_NUM, end.index, &begin)
+        )
+        {
+            bitmap_bit_nearest_forward_cleared_get4(dense->data, BITMAP4096_BITS_NUM, begin.index, &end);
+            if(!end.exist)
+            {
+                end.index = BITMAP4096_BITS_NUM;
+            }
+            chunk->container.runs[chunk->items_num].begin = (uint16_t)begin.index;
+            chunk->container.runs[chunk->items_num].end = (uint16_t)(end.index - 1);
+            ++chunk->items_num;
+        }
+        chunk->items_capacity = chunk->items_num;
+    }
+    else
+    {
+        chunk->type = P_CONTAINER__DENSE;
+        chunk->container.dense = malloc(sizeof(bitmap4096_t));
+        if(chunk->container.dense == NULL)
+        {
+            return -1;
+        }
+        bitmap4096_copy2(chunk->container.dense, dense);
+    }
+    return 0;
+}
+
+/**
+ * @brief Build the chunk from the sorted indexes
+ * @return  0       OK
+ * @return -1       No memory
+ */
+static int P_chunk_from_values4(
+        P_chunk_t * BITMAP_RESTRICT chunk,
+        uint32_t key,
+        const uint16_t * BITMAP_RESTRICT values,
+        size_t values_num
+)
+{
+    if(values_num > P_ARRAY_MAX)
+    {
+        bitmap4096_t dense;
+        bitmap4096_clear1(&dense);
+        size_t i;
+        for(i = 0; i < values_num; ++i)
+        {
+            bitmap4096_bit_raise2(&dense, values[i]);
+        }
+        return P_chunk_from_dense3(chunk, key, &dense);
+    }
+
+    chunk->key = key;
+    chunk->type = P_CONTAINER__ARRAY;
+    chunk->power = (uint16_t)values_num;
+    chunk->items_num = (uint16_t)values_num;
+    chunk->items_capacity = (uint16_t)values_num;
+    chunk->container.values = NULL;
+    if(values_num == 0)
+    {
+        return 0;
+    }
+    chunk->container.values = malloc(values_num * sizeof(uint16_t));
+    if(chunk->container.values == NULL)
+    {
+        return -1;
+    }
+    memcpy(chunk->container.values, values, values_num * sizeof(uint16_t));
+    return 0;
+}
+
+/**
+ * @brief Build the chunk of the smallest container from the sorted runs
+ * @details The containers are chosen as of P_chunk_from_dense3(), the runs are not adjacent.
+ * @return  0       OK
+ * @return -1       No memory
+ */
+static int P_chunk_from_runs4(
+        P_chunk_t * BITMAP_RESTRICT chunk,
+        uint32_t key,
+        const struct P_run * BITMAP_RESTRICT runs,
+        size_t runs_num
+)
+{
+    size_t power = 0;
+    size_t irun;
+    for(irun = 0; irun < runs_num; ++irun)
+    {
+        power += (size_t)runs[irun].end - runs[irun].begin + 1;
+    }
+
+    chunk->key = key;
+    chunk->power = (uint16_t)power;
+    chunk->items_num = 0;
+    chunk->items_capacity = 0;
+    chunk->container.values = NULL;
+    if(power == 0)
+    {
+        return 0;
+    }
+
+    size_t array_size = power * sizeof(uint16_t);
+    size_t runs_size = runs_num * sizeof(struct P_run);
+
+    if(array_size <= runs_size && power <= P_ARRAY_MAX)
+    {
+        chunk->type = P_CONTAINER__ARRAY;
+        chunk->container.values = malloc(array_size);
+        if(chunk->container.values == NULL)
+        {
+            return -1;
+        }
+        for(irun = 0; irun < runs_num; ++irun)
+        {
+            size_t value;
+            for(value = runs[irun].begin; value <= runs[irun].end; ++value)
+            {
+                chunk->container.values[chunk->items_num++] = (uint16_t)value;
+            }
+        }
+        chunk->items_capacity = chunk->items_num;
+    }
+    else if(runs_size < sizeof(bitmap4096_t))
+    {
+        chunk->type = P_CONTAINER__RUN;
+        chunk->container.runs = malloc(runs_size);
+        if(chunk->container.runs == NULL)
+        {
+            return -1;
+        }
+        memcpy(chunk->container.runs, runs, runs_size);
+        chunk->items_num = (uint16_t)runs_num;
+        chunk->items_capacity = chunk->items_num;
+    }
+    else
+    {
+        chunk->type = P_CONTAINER__DENSE;
+        chunk->container.dense = malloc(sizeof(bitmap4096_t));
+        if(chunk->container.dense == NULL)
+        {
+            return -1;
+        }
+        bitmap4096_clear1(chunk->container.dense);
+        for(irun = 0; irun < runs_num; ++irun)
+        {
+            struct bitmap_range range = { runs[irun].begin, runs[irun].end };
+            bitmap_bitwise_range_raise2(chunk->container.dense->data, &range);
+        }
+    }
+    return 0;
+}
+
+static int P_chunk_copy2(
+        P_chunk_t * BITMAP_RESTRICT dest,
+        const P_chunk_t * BITMAP_RESTRICT src
+)
+{
+    size_t size;
+    switch(src->type)
+    {
+        case P_CONTAINER__ARRAY: size = src->items_num * sizeof(uint16_t); break;
+        case P_CONTAINER__RUN  : size = src->items_num * sizeof(struct P_run); break;
+        case P_CONTAINER__DENSE:
+        default                : size = sizeof(bitmap4096_t); break;
+    }
+    (*dest) = (*src);
+    dest->items_capacity = dest->items_num;
+    dest->container.values = malloc(size);
+    if(dest->container.values == NULL)
+    {
+        return -1;
+    }
+    memcpy(dest->container.values, src->container.values, size);
+    return 0;
+}
+
+/**
+ * @brief Position of the value in the sorted array, or the position to insert it
+ */
+static size_t P_values_search3(
+        const uint16_t * values,
+        size_t values_num,
+        uint16_t value
+)
+{
+    size_t lo = 0;
+    size_t hi = values_num;
+    while(lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if(values[mid] < value)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief Amount of the runs, which begin not after the value: the next run is the position to insert it
+ */
+static size_t P_runs_search3(
+        const struct P_run * runs,
+        size_t runs_num,
+        uint16_t value
+)
+{
+    size_t lo = 0;
+    size_t hi = runs_num;
+    while(lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if(runs[mid].begin <= value)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static bool P_chunk_bit_get2(
+        const P_chunk_t * chunk,
+        uint16_t value
+)
+{
+    switch(chunk->type)
+    {
+        case P_CONTAINER__ARRAY:
+        {
+            size_t i = P_values_search3(chunk->container.values, chunk->items_num, value);
+            return (i < chunk->items_num && chunk->container.values[i] == value);
+        }
+        case P_CONTAINER__DENSE:
+        {
+            return bitmap4096_bit_get2(chunk->container.dense, value);
+        }
+        case P_CONTAINER__RUN:
+        {
+            size_t irun = P_runs_search3(chunk->container.runs, chunk->items_num, value);
+            return (irun > 0 && value <= chunk->container.runs[irun - 1].end);
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Position of the chunk, or the position to insert it
+ */
+static size_t P_roaring_search2(
+        const bitmap_roaring_t * bitmap,
+        uint32_t key
+)
+{
+    size_t lo = 0;
+    size_t hi = bitmap->chunks_num;
+    while(lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if(bitmap->chunks[mid].key < key)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief Insert the chunk, the bitmap owns the container after the success
+ */
+static int P_roaring_insert3(
+        bitmap_roaring_t * BITMAP_RESTRICT bitmap,
+        size_t ichunk,
+        const P_chunk_t * BITMAP_RESTRICT chunk
+)
+{
+    if(bitmap->chunks_num == bitmap->chunks_capacity)
+    {
+        size_t capacity = (bitmap->chunks_capacity == 0) ? 4 : bitmap->chunks_capacity * 2;
+        P_chunk_t * chunks = realloc(bitmap->chunks, capacity * sizeof(P_chunk_t));
+        if(chunks == NULL)
+        {
+            return -1;
+        }
+        bitmap->chunks = chunks;
+        bitmap->chunks_capacity = capacity;
+    }
+    memmove(
+            &bitmap->chunks[ichunk + 1],
+            &bitmap->chunks[ichunk],
+            (bitmap->chunks_num - ichunk) * sizeof(P_chunk_t)
+    );
+    bitmap->chunks[ichunk] = (*chunk);
+    ++bitmap->chunks_num;
+    return 0;
+}
+
+static void P_roaring_remove2(
+        bitmap_roaring_t * bitmap,
+        size_t ichunk
+)
+{
+    P_chunk_free1(&bitmap->chunks[ichunk]);
+    --bitmap->chunks_num;
+    memmove(
+            &bitmap->chunks[ichunk],
+            &bitmap->chunks[ichunk + 1],
+            (bitmap->chunks_num - ichunk) * sizeof(P_chunk_t)
+    );
+}
+
+/**
+ * @brief Append the chunk, if it is not empty, the bitmap owns the container after the success
+ */
+static int P_roaring_append2(
+        bitmap_roaring_t * BITMAP_RESTRICT bitmap,
+        P_chunk_t * BITMAP_RESTRICT chunk
+)
+{
+    if(chunk->power == 0)
+    {
+        P_chunk_free1(chunk);
+        return 0;
+    }
+    if(P_roaring_insert3(bitmap, bitmap->chunks_num, chunk) != 0)
+    {
+        P_chunk_free1(chunk);
+        return -1;
+    }
+    return 0;
+}
+
+void bitmap_roaring_init1(
+        bitmap_roaring_t * bitmap
+)
+{
+    bitmap->chunks = NULL;
+    bitmap->chunks_num = 0;
+    bitmap->chunks_capacity = 0;
+}
+
+void bitmap_roaring_destroy1(
+        bitmap_roaring_t * bitmap
+)
+{
+    size_t ichunk;
+    for(ichunk = 0; ichunk < bitmap->chunks_num; ++ichunk)
+    {
+        P_chunk_free1(&bitmap->chunks[ichunk]);
+    }
+    free(bitmap->chunks);
+    bitmap_roaring_init1(bitmap);
+}
+
+int bitmap_roaring_copy2(
+        bitmap_roaring_t * BITMAP_RESTRICT dest,
+        const bitmap_roaring_t * BITMAP_RESTRICT src
+)
+{
+    bitmap_roaring_t result;
+    bitmap_roaring_init1(&result);
+
+    size_t ichunk;
+    for(ichunk = 0; ichunk < src->chunks_num; ++ichunk)
+    {
+        P_chunk_t chunk;
+        if(
+                P_chunk_copy2(&chunk, &src->chunks[ichunk]) != 0 ||
+                P_roaring_append2(&result, &chunk) != 0
+        )
+        {
+            bitmap_roaring_destroy1(&result);
+            return -1;
+        }
+    }
+
+    bitmap_roaring_destroy1(dest);
+    (*dest) = result;
+    return 0;
+}
+
+int bitmap_roaring_optimize1(
+        bitmap_roaring_t * bitmap
+)
+{
+    size_t ichunk;
+    for(ichunk = 0; ichunk < bitmap->chunks_num; ++ichunk)
+    {
+        P_chunk_t * chunk = &bitmap->chunks[ichunk];
+        bitmap4096_t dense;
+        P_chunk_dense_fill2(&dense, chunk);
+        P_chunk_t optimized;
+        if(P_chunk_from_dense3(&optimized, chunk->key, &dense) != 0)
+        {
+            P_chunk_free1(&optimized);
+            return -1;
+        }
+        P_chunk_free1(chunk);
+        (*chunk) = optimized;
+    }
+    return 0;
+}
+
+/**
+ * @brief Change the bit of the chunk through the dense bitmap
+ * @return  0       OK
+ * @return -1       No memory, the chunk is not changed
+ */
+static int P_chunk_dense_bit_set3(
+        P_chunk_t * chunk,
+        uint16_t value,
+        bool raise
+)
+{
+    bitmap4096_t dense;
+    P_chunk_dense_fill2(&dense, chunk);
+    if(raise)
+    {
+        bitmap4096_bit_raise2(&dense, value);
+    }
+    else
+    {
+        bitmap4096_bit_clear2(&dense, value);
+    }
+
+    P_chunk_t changed;
+    if(P_chunk_from_dense3(&changed, chunk->key, &dense) != 0)
+    {
+        P_chunk_free1(&changed);
+        return -1;
+    }
+    P_chunk_free1(chunk);
+    (*chunk) = changed;
+    return 0;
+}
+
+/**
+ * @brief Raise the cleared bit of the run chunk: extend, join or insert the run
+ * @details The chunk is re-encoded, if the new run makes the array or the dense chunk smaller.
+ * @return  0       OK
+ * @return -1       No memory, the chunk is not changed
+ */
+static int P_chunk_run_raise2(
+        P_chunk_t * chunk,
+        uint16_t value
+)
+{
+    struct P_run * runs = chunk->container.runs;
+    size_t irun = P_runs_search3(runs, chunk->items_num, value);
+    bool join_prev = (irun > 0 && (size_t)runs[irun - 1].end + 1 == value);
+    bool join_next = (irun < chunk->items_num && (size_t)value + 1 == runs[irun].begin);
+
+    if(join_prev && join_next)
+    {
+        runs[irun - 1].end = runs[irun].end;
+        --chunk->items_num;
+        memmove(&runs[irun], &runs[irun + 1], (chunk->items_num - irun) * sizeof(struct P_run));
+    }
+    else if(join_prev)
+    {
+        runs[irun - 1].end = value;
+    }
+    else if(join_next)
+    {
+        runs[irun].begin = value;
+    }
+    else
+    {
+        size_t runs_num = (size_t)chunk->items_num + 1;
+        size_t power = (size_t)chunk->power + 1;
+        if(runs_num >= P_RUNS_MAX || (power * sizeof(uint16_t) <= runs_num * sizeof(struct P_run) && power <= P_ARRAY_MAX))
+        {
+            return P_chunk_dense_bit_set3(chunk, value, true);
+        }
+        if(chunk->items_num == chunk->items_capacity)
+        {
+            size_t capacity = chunk->items_capacity * 2;
+            if(capacity > P_RUNS_MAX - 1)
+            {
+                capacity = P_RUNS_MAX - 1;
+            }
+            runs = realloc(runs, capacity * sizeof(struct P_run));
+            if(runs == NULL)
+            {
+                return -1;
+            }
+            chunk->container.runs = runs;
+            chunk->items_capacity = (uint16_t)capacity;
+        }
+        memmove(&runs[irun + 1], &runs[irun], (chunk->items_num - irun) * sizeof(struct P_run));
+        runs[irun].begin = value;
+        runs[irun].end = value;
+        ++chunk->items_num;
+    }
+    ++chunk->power;
+    return 0;
+}
+
+int bitmap_roaring_bit_raise2(
+        bitmap_roaring_t * bitmap,
+        uint32_t bit_index
+)
+{
+    uint32_t key = bit_index >> P_CHUNK_SHIFT;
+    uint16_t value = (uint16_t)(bit_index & P_CHUNK_MASK);
+
+    size_t ichunk = P_roaring_search2(bitmap, key);
+    if(ichunk == bitmap->chunks_num || bitmap->chunks[ichunk].key != key)
+    {
+        P_chunk_t chunk;
+        if(P_chunk_from_values4(&chunk, key, &value, 1) != 0)
+        {
+            return -1;
+        }
+        if(P_roaring_insert3(bitmap, ichunk, &chunk) != 0)
+        {
+            P_chunk_free1(&chunk);
+            return -1;
+        }
+        return 0;
+    }
+
+    P_chunk_t * chunk = &bitmap->chunks[ichunk];
+    switch(chunk->type)
+    {
+        case P_CONTAINER__ARRAY:
+        {
+            size_t i = P_values_search3(chunk->container.values, chunk->items_num, value);
+            if(i < chunk->items_num && chunk->container.values[i] == value)
+            {
+                return 0;
+            }
+            if(chunk->items_num == P_ARRAY_MAX)
+            {
+                return P_chunk_dense_bit_set3(chunk, value, true);
+            }
+            if(chunk->items_num == chunk->items_capacity)
+            {
+                size_t capacity = chunk->items_capacity * 2;
+                if(capacity > P_ARRAY_MAX)
+                {
+                    capacity = P_ARRAY_MAX;
+                }
+                uint16_t * values = realloc(chunk->container.values, capacity * sizeof(uint16_t));
+                if(values == NULL)
+                {
+                    return -1;
+                }
+                chunk->container.values = values;
+                chunk->items_capacity = (uint16_t)capacity;
+            }
+            memmove(
+                    &chunk->container.values[i + 1],
+                    &chunk->container.values[i],
+                    (chunk->items_num - i) * sizeof(uint16_t)
+            );
+            chunk->container.values[i] = value;
+            ++chunk->items_num;
+            ++chunk->power;
+            return 0;
+        }
+        case P_CONTAINER__DENSE:
+        {
+            if(!bitmap4096_bit_get2(chunk->container.dense, value))
+            {
+                bitmap4096_bit_raise2(chunk->container.dense, value);
+                ++chunk->power;
+            }
+            return 0;
+        }
+        case P_CONTAINER__RUN:
+        {
+            if(P_chunk_bit_get2(chunk, value))
+            {
+                return 0;
+            }
+            return P_chunk_run_raise2(chunk, value);
+        }
+    }
+    return 0;
+}
+
+int bitmap_roaring_bit_clear2(
+        bitmap_roaring_t * bitmap,
+        uint32_t bit_index
+)
+{
+    uint32_t key = bit_index >> P_CHUNK_SHIFT;
+    uint16_t value = (uint16_t)(bit_index & P_CHUNK_MASK);
+
+    size_t ichunk = P_roaring_search2(bitmap, key);
+    if(ichunk == bitmap->chunks_num || bitmap->chunks[ichunk].key != key)
+    {
+        return 0;
+    }
+
+    P_chunk_t * chunk = &bitmap->chunks[ichunk];
+    if(!P_chunk_bit_get2(chunk, value))
+    {
+        return 0;
+    }
+    if(chunk->power == 1)
+    {
+        P_roaring_remove2(bitmap, ichunk);
+        return 0;
+    }
+
+    switch(chunk->type)
+    {
+        case P_CONTAINER__ARRAY:
+        {
+            size_t i = P_values_search3(chunk->container.values, chunk->items_num, value);
+            --chunk->items_num;
+            --chunk->power;
+            memmove(
+                    &chunk->container.values[i],
+                    &chunk->container.values[i + 1],
+                    (chunk->items_num - i) * sizeof(uint16_t)
+            );
+            return 0;
+        }
+        case P_CONTAINER__DENSE:
+        {
+            if(chunk->power > P_ARRAY_MAX)
+            {
+                bitmap4096_bit_clear2(chunk->container.dense, value);
+                --chunk->power;
+                return 0;
+            }
+            return P_chunk_dense_bit_set3(chunk, value, false);
+        }
+        case P_CONTAINER__RUN:
+        {
+            return P_chunk_dense_bit_set3(chunk, value, false);
+        }
+    }
+    return 0;
+}
+
+bool bitmap_roaring_bit_get2(
+        const bitmap_roaring_t * bitmap,
+        uint32_t bit_index
+)
+{
+    uint32_t key = bit_index >> P_CHUNK_SHIFT;
+    size_t ichunk = P_roaring_search2(bitmap, key);
+    return
+            ichunk < bitmap->chunks_num &&
+            bitmap->chunks[ichunk].key == key &&
+            P_chunk_bit_get2(&bitmap->chunks[ichunk], (uint16_t)(bit_index & P_CHUNK_MASK));
+}
+
+size_t bitmap_roaring_power1(
+        const bitmap_roaring_t * bitmap
+)
+{
+    size_t power = 0;
+    size_t ichunk;
+    for(ichunk = 0; ichunk < bitmap->chunks_num; ++ichunk)
+    {
+        power += bitmap->chunks[ichunk].power;
+    }
+    return power;
+}
+
+/**
+ * @brief The operation on two sorted arrays of the indexes
+ * @param dest      The result, room for a_num + b_num indexes
+ * @return Amount of the indexes of the result
+ */
+static size_t P_values_operation6(
+        uint16_t * BITMAP_RESTRICT dest,
+        enum bitmap_operation operation,
+        const uint16_t * BITMAP_RESTRICT a,
+        size_t a_num,
+        const uint16_t * BITMAP_RESTRICT b,
+        size_t b_num
+)
+{
+    bool keep_a = (operation != BITMAP_OPERATION__AND);
+    bool keep_b = (operation == BITMAP_OPERATION__OR || operation == BITMAP_OPERATION__XOR);
+    bool keep_both = (operation == BITMAP_OPERATION__AND || operation == BITMAP_OPERATION__OR);
+    size_t dest_num = 0;
+    size_t ia = 0;
+    size_t ib = 0;
+    while(ia < a_num && ib < b_num)
+    {
+        if(a[ia] < b[ib])
+        {
+            if(keep_a) dest[dest_num++] = a[ia];
+            ++ia;
+        }
+        else if(a[ia] > b[ib])
+        {
+            if(keep_b) dest[dest_num++] = b[ib];
+            ++ib;
+        }
+        else
+        {
+            if(keep_both) dest[dest_num++] = a[ia];
+            ++ia;
+            ++ib;
+        }
+    }
+    for(; keep_a && ia < a_num; ++ia)
+    {
+        dest[dest_num++] = a[ia];
+    }
+    for(; keep_b && ib < b_num; ++ib)
+    {
+        dest[dest_num++] = b[ib];
+    }
+    return dest_num;
+}
+
+/**
+ * @brief The item of the array or run chunk as the run, the index is the run of one bit
+ */
+static struct P_run P_chunk_run2(
+        const P_chunk_t * chunk,
+        size_t iitem
+)
+{
+    if(chunk->type == P_CONTAINER__ARRAY)
+    {
+        struct P_run run = { chunk->container.values[iitem], chunk->container.values[iitem] };
+        return run;
+    }
+    return chunk->container.runs[iitem];
+}
+
+/**
+ * @brief Is the bit raised by the operation?
+ */
+static bool P_operation3(
+        enum bitmap_operation operation,
+        bool a,
+        bool b
+)
+{
+    switch(operation)
+    {
+        case BITMAP_OPERATION__AND  : return a && b;
+        case BITMAP_OPERATION__OR   : return a || b;
+        case BITMAP_OPERATION__CLEAR: return a && !b;
+        case BITMAP_OPERATION__XOR  : return a != b;
+    }
+    return false;
+}
+
+/**
+ * @brief Position of the next edge of the runs: the begin of the run or the bit after it
+ * @return The position or BITMAP4096_BITS_NUM + 1, if the runs are finished
+ */
+static size_t P_runs_edge3(
+        const P_chunk_t * chunk,
+        size_t iitem,
+        bool inside
+)
+{
+    if(iitem == chunk->items_num)
+    {
+        return BITMAP4096_BITS_NUM + 1;
+    }
+    struct P_run run = P_chunk_run2(chunk, iitem);
+    return inside ? (size_t)run.end + 1 : run.begin;
+}
+
+/**
+ * @brief The operation on two array or run chunks by the merge of the runs
+ * @details The edges of both chunks are walked in order, the result is switched at the edges.
+ * @param dest      The result, room for the items of both chunks, the runs are not adjacent
+ * @return Amount of the runs of the result
+ */
+static size_t P_runs_operation4(
+        struct P_run * BITMAP_RESTRICT dest,
+        enum bitmap_operation operation,
+        const P_chunk_t * a,
+        const P_chunk_t * b
+)
+{
+    size_t dest_num = 0;
+    size_t ia = 0;
+    size_t ib = 0;
+    bool inside_a = false;
+    bool inside_b = false;
+    bool inside = false;
+    size_t begin = 0;
+    for(;;)
+    {
+        size_t edge_a = P_runs_edge3(a, ia, inside_a);
+        size_t edge_b = P_runs_edge3(b, ib, inside_b);
+        size_t edge = (edge_a < edge_b) ? edge_a : edge_b;
+        if(edge > BITMAP4096_BITS_NUM)
+        {
+            break;
+        }
+        /* all edges of the position: the adjacent runs are joined */
+        while(edge_a == edge)
+        {
+            ia += inside_a;
+            inside_a = !inside_a;
+            edge_a = P_runs_edge3(a, ia, inside_a);
+        }
+        while(edge_b == edge)
+        {
+            ib += inside_b;
+            inside_b = !inside_b;
+            edge_b = P_runs_edge3(b, ib, inside_b);
+        }
+
+        bool raised = P_operation3(operation, inside_a, inside_b);
+        if(raised != inside)
+        {
+            if(raised)
+            {
+                begin = edge;
+            }
+            else
+            {
+                dest[dest_num].begin = (uint16_t)begin;
+                dest[dest_num].end = (uint16_t)(edge - 1);
+                ++dest_num;
+            }
+            inside = raised;
+        }
+    }
+    return dest_num;
+}
+
+/**
+ * @brief The operation of the dense bitmap and the run
+ * @param operation     OR, CLEAR or XOR
+ */
+static void P_dense_run_operation3(
+        bitmap4096_t * dense,
+        enum bitmap_operation operation,
+        struct P_run run
+)
+{
+    struct bitmap_range range = { run.begin, run.end };
+    switch(operation)
+    {
+        case BITMAP_OPERATION__AND:
+        {
+            /* by the gaps between the runs, see P_dense_operation3() */
+            break;
+        }
+        case BITMAP_OPERATION__OR:
+        {
+            bitmap_bitwise_range_raise2(dense->data, &range);
+            break;
+        }
+        case BITMAP_OPERATION__CLEAR:
+        {
+            bitmap_bitwise_range_clear2(dense->data, &range);
+            break;
+        }
+        case BITMAP_OPERATION__XOR:
+        {
+            struct bitmap_P_range_blocks range_blocks;
+            if(!bitmap_P_range_blocks_get2(&range_blocks, &range))
+            {
+                break;
+            }
+            dense->data[range_blocks.iblock_begin] ^= range_blocks.mask_begin;
+            size_t iblock;
+            for(iblock = range_blocks.iblock_begin + 1; iblock < range_blocks.iblock_end; ++iblock)
+            {
+                dense->data[iblock] = ~dense->data[iblock];
+            }
+            dense->data[range_blocks.iblock_end] ^= range_blocks.mask_end;
+            break;
+        }
+    }
+}
+
+/**
+ * @brief The operation of the dense bitmap and the chunk: dense = dense <operation> chunk
+ */
+static void P_dense_operation3(
+        bitmap4096_t * BITMAP_RESTRICT dense,
+        enum bitmap_operation operation,
+        const P_chunk_t * BITMAP_RESTRICT chunk
+)
+{
+    size_t iitem;
+    if(chunk->type == P_CONTAINER__DENSE)
+    {
+        const bitmap4096_t * src = chunk->container.dense;
+        switch(operation)
+        {
+            case BITMAP_OPERATION__AND:
+            {
+                bitmap_bitwise_and3(dense->data, src->data, BITMAP4096_BITS_NUM);
+                break;
+            }
+            case BITMAP_OPERATION__OR:
+            {
+                bitmap_bitwise_or3(dense->data, src->data, BITMAP4096_BITS_NUM);
+                break;
+            }
+            case BITMAP_OPERATION__CLEAR:
+            {
+                bitmap_bitwise_clear3(dense->data, src->data, BITMAP4096_BITS_NUM);
+                break;
+            }
+            case BITMAP_OPERATION__XOR:
+            {
+                size_t iblock;
+                BITMAP_FOREACH_BLOCK(iblock, BITMAP_BITS_TO_BLOCKS_ALIGNED(BITMAP4096_BITS_NUM))
+                {
+                    dense->data[iblock] ^= src->data[iblock];
+                }
+                break;
+            }
+        }
+        return;
+    }
+
+    if(operation == BITMAP_OPERATION__AND)
+    {
+        /* clear the gaps between the runs */
+        size_t begin = 0;
+        for(iitem = 0; iitem <= chunk->items_num; ++iitem)
+        {
+            struct bitmap_range gap = { begin, BITMAP4096_BITS_NUM - 1 };
+            if(iitem < chunk->items_num)
+            {
+                struct P_run run = P_chunk_run2(chunk, iitem);
+                gap.end = (size_t)run.begin - 1;
+                begin = (size_t)run.end + 1;
+            }
+            if(gap.begin <= gap.end && gap.end < BITMAP4096_BITS_NUM)
+            {
+                bitmap_bitwise_range_clear2(dense->data, &gap);
+            }
+        }
+        return;
+    }
+    for(iitem = 0; iitem < chunk->items_num; ++iitem)
+    {
+        P_dense_run_operation3(dense, operation, P_chunk_run2(chunk, iitem));
+    }
+}
+
+/**
+ * @brief The operation on two chunks of the same key
+ * @details The array and run chunks are merged as the runs, the array is searched by the other chunk.
+ *          Only the dense chunk is copied, the other one is applied to the copy.
+ * @param dest      The result, power is 0 if it is empty
+ * @return  0       OK
+ * @return -1       No memory
+ */
+static int P_chunk_operation4(
+        P_chunk_t * dest,
+        enum bitmap_operation operation,
+        const P_chunk_t * a,
+        const P_chunk_t * b
+)
+{
+    if(a->type == P_CONTAINER__ARRAY && b->type == P_CONTAINER__ARRAY)
+    {
+        uint16_t values[P_ARRAY_MAX * 2];
+        size_t values_num = P_values_operation6(
+                values,
+                operation,
+                a->container.values,
+                a->items_num,
+                b->container.values,
+                b->items_num
+        );
+        return P_chunk_from_values4(dest, a->key, values, values_num);
+    }
+
+    /* the result is the subset of the array */
+    if(
+            a->type == P_CONTAINER__ARRAY &&
+            (operation == BITMAP_OPERATION__AND || operation == BITMAP_OPERATION__CLEAR)
+    )
+    {
+        bool keep = (operation == BITMAP_OPERATION__AND);
+        uint16_t values[P_ARRAY_MAX];
+        size_t values_num = 0;
+        size_t i;
+        for(i = 0; i < a->items_num; ++i)
+        {
+            if(P_chunk_bit_get2(b, a->container.values[i]) == keep)
+            {
+                values[values_num++] = a->container.values[i];
+            }
+        }
+        return P_chunk_from_values4(dest, a->key, values, values_num);
+    }
+    if(b->type == P_CONTAINER__ARRAY && operation == BITMAP_OPERATION__AND)
+    {
+        return P_chunk_operation4(dest, operation, b, a);
+    }
+
+    if(a->type != P_CONTAINER__DENSE && b->type != P_CONTAINER__DENSE)
+    {
+        struct P_run runs[P_ARRAY_MAX + P_RUNS_MAX];
+        size_t runs_num = P_runs_operation4(runs, operation, a, b);
+        return P_chunk_from_runs4(dest, a->key, runs, runs_num);
+    }
+
+    bitmap4096_t dense;
+    if(a->type == P_CONTAINER__DENSE)
+    {
+        bitmap4096_copy2(&dense, a->container.dense);
+        P_dense_operation3(&dense, operation, b);
+    }
+    else if(operation == BITMAP_OPERATION__CLEAR)
+    {
+        /* a & ~b */
+        size_t iblock;
+        BITMAP_FOREACH_BLOCK(iblock, BITMAP_BITS_TO_BLOCKS_ALIGNED(BITMAP4096_BITS_NUM))
+        {
+            dense.data[iblock] = ~b->container.dense->data[iblock];
+        }
+        P_dense_operation3(&dense, BITMAP_OPERATION__AND, a);
+    }
+    else
+    {
+        bitmap4096_copy2(&dense, b->container.dense);
+        P_dense_operation3(&dense, operation, a);
+    }
+    return P_chunk_from_dense3(dest, a->key, &dense);
+}
+
+int bitmap_roaring_operation4(
+        bitmap_roaring_t * dest,
+        enum bitmap_operation operation,
+        const bitmap_roaring_t * a,
+        const bitmap_roaring_t * b
+)
+{
+    bool keep_a = (operation != BITMAP_OPERATION__AND);
+    bool keep_b = (operation == BITMAP_OPERATION__OR || operation == BITMAP_OPERATION__XOR);
+
+    /* the result is built aside: dest can be a or b */
+    bitmap_roaring_t result;
+    bitmap_roaring_init1(&result);
+
+    size_t ia = 0;
+    size_t ib = 0;
+    while(ia < a->chunks_num || ib < b->chunks_num)
+    {
+        const P_chunk_t * chunk_a = (ia < a->chunks_num) ? &a->chunks[ia] : NULL;
+        const P_chunk_t * chunk_b = (ib < b->chunks_num) ? &b->chunks[ib] : NULL;
+        P_chunk_t chunk;
+        chunk.power = 0;
+        chunk.container.values = NULL;
+        int res = 0;
+
+        if(chunk_b == NULL || (chunk_a != NULL && chunk_a->key < chunk_b->key))
+        {
+            if(keep_a)
+            {
+                res = P_chunk_copy2(&chunk, chunk_a);
+            }
+            ++ia;
+        }
+        else if(chunk_a == NULL || chunk_b->key < chunk_a->key)
+        {
+            if(keep_b)
+            {
+                res = P_chunk_copy2(&chunk, chunk_b);
+            }
+            ++ib;
+        }
+        else
+        {
+            res = P_chunk_operation4(&chunk, operation, chunk_a, chunk_b);
+            ++ia;
+            ++ib;
+        }
+
+        if(res != 0)
+        {
+            P_chunk_free1(&chunk);
+            bitmap_roaring_destroy1(&result);
+            return -1;
+        }
+        if(P_roaring_append2(&result, &chunk) != 0)
+        {
+            bitmap_roaring_destroy1(&result);
+            return -1;
+        }
+    }
+
+    bitmap_roaring_destroy1(dest);
+    (*dest) = result;
+    return 0;
+}
+
+int bitmap_roaring_and3(
+        bitmap_roaring_t * dest,
+        const bitmap_roaring_t * a,
+        const bitmap_roaring_t * b
+)
+{
+    return bitmap_roaring_operation4(dest, BITMAP_OPERATION__AND, a, b);
+}
+
+int bitmap_roaring_or3(
+        bitmap_roaring_t * dest,
+        const bitmap_roaring_t * a,
+        const bitmap_roaring_t * b
+)
+{
+    return bitmap_roaring_operation4(dest, BITMAP_OPERATION__OR, a, b);
+}
+
+int bitmap_roaring_clear3(
+        bitmap_roaring_t * dest,
+        const bitmap_roaring_t * a,
+        const bitmap_roaring_t * b
+)
+{
+    return bitmap_roaring_operation4(dest, BITMAP_OPERATION__CLEAR, a, b);
+}
+
+int bitmap_roaring_xor3(
+        bitmap_roaring_t * dest,
+        const bitmap_roaring_t * a,
+        const bitmap_roaring_t * b
+)
+{
+    return bitmap_roaring_operation4(dest, BITMAP_OPERATION__XOR, a, b);
+}
+
+void bitmap_roaring_iterator_init2(
+        bitmap_roaring_iterator_t * BITMAP_RESTRICT iterator,
+        const bitmap_roaring_t * BITMAP_RESTRICT bitmap
+)
+{
+    iterator->bitmap = bitmap;
+    iterator->ichunk = 0;
+    iterator->iitem = 0;
+    iterator->ibit = 0;
+    iterator->block = 0;
+}
+
+bool bitmap_roaring_iterator_next2(
+        bitmap_roaring_iterator_t * BITMAP_RESTRICT iterator,
+        uint32_t * BITMAP_RESTRICT bit_index
+)
+{
+    for(
+            ;
+            iterator->ichunk < iterator->bitmap->chunks_num;
+            ++iterator->ichunk, iterator->iitem = 0, iterator->ibit = 0, iterator->block = 0
+    )
+    {
+        const P_chunk_t * chunk = &iterator->bitmap->chunks[iterator->ichunk];
+        size_t value;
+        switch(chunk->type)
+        {
+            case P_CONTAINER__ARRAY:
+            {
+                if(iterator->iitem >= chunk->items_num)
+                {
+                    continue;
+                }
+                value = chunk->container.values[iterator->iitem++];
+                break;
+            }
+            case P_CONTAINER__DENSE:
+            {
+                /* as bitmap_iterator_next2(): one count-trailing-zeros and one lowest bit reset per step */
+                while(iterator->block == 0 && iterator->iitem < BITMAP_BITS_TO_BLOCKS_ALIGNED(BITMAP4096_BITS_NUM))
+                {
+                    iterator->block = chunk->container.dense->data[iterator->iitem++];
+                }
+                if(iterator->block == 0)
+                {
+                    continue;
+                }
+                value = (iterator->iitem - 1) * BITMAP_BITS_IN_BLOCK() + (size_t)CTZ(iterator->block);
+                iterator->block &= iterator->block - 1;
+                break;
+            }
+            case P_CONTAINER__RUN:
+            default:
+            {
+                if(iterator->iitem >= chunk->items_num)
+                {
+                    continue;
+                }
+                const struct P_run * run = &chunk->container.runs[iterator->iitem];
+                value = run->begin + iterator->ibit;
+                if(value == run->end)
+                {
+                    ++iterator->iitem;
+                    iterator->ibit = 0;
+                }
+                else
+                {
+                    ++iterator->ibit;
+                }
+                break;
+            }
+        }
+        (*bit_index) = (chunk->key << P_CHUNK_SHIFT) | (uint32_t)value;
+        return true;
+    }
+    return false;
+}
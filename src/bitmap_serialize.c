@@ -0,0 +1,350 @@
+/**
+ * @file bitmap_serialize.c
+ * @brief Binary serialization of the bitmap
+ */
+
+#include <bitmap/bitmap_serialize.h>
+
+#include "bitmap_common.h"
+#include "bitmap_simd.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/** @brief The magic of the header */
+#define P_MAGIC "BMAP"
+/** @brief The version of the format */
+#define P_VERSION (1)
+/** @brief Size of the word of the payload */
+#define P_WORD_SIZE (8)
+/** @brief Amount of bits in the word of the payload */
+#define P_WORD_BITS (64)
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#   define P_LITTLE_ENDIAN 1
+#else
+#   define P_LITTLE_ENDIAN 0
+#endif
+
+/**
+ * @brief The header
+ * @details On the wire: magic[4], version u16, format u16, bits_num u64, words_present u64, crc32c u32, zero u32.
+ */
+struct P_header
+{
+    enum bitmap_serialize_format format;
+    size_t bits_num;
+    size_t words_num;       /**< Amount of words in bitmap */
+    size_t words_present;   /**< Amount of words in the payload */
+    size_t index_size;      /**< Size of the index of the present words */
+    uint32_t crc32c;        /**< CRC32C of the payload */
+    size_t size;            /**< Size of the serialized bitmap */
+};
+
+static void P_store_le3(
+        uint8_t * dest,
+        uint64_t value,
+        size_t size
+)
+{
+    size_t i;
+    for(i = 0; i < size; ++i)
+    {
+        dest[i] = (uint8_t)(value >> (i * 8));
+    }
+}
+
+static uint64_t P_load_le2(
+        const uint8_t * src,
+        size_t size
+)
+{
+    uint64_t value = 0;
+    size_t i;
+    for(i = 0; i < size; ++i)
+    {
+        value |= (uint64_t)src[i] << (i * 8);
+    }
+    return value;
+}
+
+/**
+ * @brief Size of the index of the present words
+ */
+static size_t P_index_size1(
+        size_t words_num
+)
+{
+    return (words_num + P_WORD_BITS - 1) / P_WORD_BITS * P_WORD_SIZE;
+}
+
+/**
+ * @brief The word of the bitmap, without the tail bits
+ */
+static uint64_t P_word_get3(
+        const bitmap_block_t * bitmap,
+        size_t bits_num,
+        size_t iword
+)
+{
+    size_t bytes_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num) * sizeof(bitmap_block_t);
+    size_t ibyte = iword * P_WORD_SIZE;
+    size_t size = (bytes_num - ibyte < P_WORD_SIZE) ? (bytes_num - ibyte) : P_WORD_SIZE;
+    uint64_t word = 0;
+#if P_LITTLE_ENDIAN
+    memcpy(&word, (const uint8_t *)bitmap + ibyte, size);
+#else
+    size_t i;
+    for(i = 0; i < size; ++i, ++ibyte)
+    {
+        uint8_t byte = (uint8_t)(bitmap[ibyte / sizeof(bitmap_block_t)] >> (ibyte % sizeof(bitmap_block_t) * 8));
+        word |= (uint64_t)byte << (i * 8);
+    }
+#endif
+    size_t tail_bits = bits_num - iword * P_WORD_BITS;
+    if(tail_bits < P_WORD_BITS)
+    {
+        word &= ((uint64_t)1 << tail_bits) - 1;
+    }
+    return word;
+}
+
+/**
+ * @brief Set the word of the bitmap
+ */
+static void P_word_set4(
+        bitmap_block_t * bitmap,
+        size_t bits_num,
+        size_t iword,
+        uint64_t word
+)
+{
+    size_t bytes_num = BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num) * sizeof(bitmap_block_t);
+    size_t ibyte = iword * P_WORD_SIZE;
+    size_t size = (bytes_num - ibyte < P_WORD_SIZE) ? (bytes_num - ibyte) : P_WORD_SIZE;
+    size_t tail_bits = bits_num - iword * P_WORD_BITS;
+    if(tail_bits < P_WORD_BITS)
+    {
+        word &= ((uint64_t)1 << tail_bits) - 1;
+    }
+#if P_LITTLE_ENDIAN
+    memcpy((uint8_t *)bitmap + ibyte, &word, size);
+#else
+    size_t i;
+    for(i = 0; i < size; ++i, ++ibyte)
+    {
+        size_t shift = ibyte % sizeof(bitmap_block_t) * 8;
+        bitmap_block_t * block = &bitmap[ibyte / sizeof(bitmap_block_t)];
+        *block = (bitmap_block_t)((*block & ~((bitmap_block_t)0xFF << shift)) | ((bitmap_block_t)(uint8_t)(word >> (i * 8)) << shift));
+    }
+#endif
+}
+
+/**
+ * @brief Parse and check the header
+ * @return  0       OK
+ * @return -1       The header is wrong or incomplete
+ */
+static int P_header_parse3(
+        struct P_header * header,
+        const uint8_t * src,
+        size_t src_size
+)
+{
+    if(src_size < BITMAP_SERIALIZE_HEADER_SIZE || memcmp(src, P_MAGIC, 4) != 0 || P_load_le2(&src[4], 2) != P_VERSION)
+    {
+        return -1;
+    }
+    uint64_t format = P_load_le2(&src[6], 2);
+    uint64_t bits_num = P_load_le2(&src[8], 8);
+    uint64_t words_present = P_load_le2(&src[16], 8);
+    if(format > BITMAP_SERIALIZE_FORMAT__SPARSE || bits_num > SIZE_MAX - P_WORD_BITS)
+    {
+        return -1;
+    }
+
+    header->format = (enum bitmap_serialize_format)format;
+    header->bits_num = (size_t)bits_num;
+    header->words_num = (header->bits_num + P_WORD_BITS - 1) / P_WORD_BITS;
+    header->index_size = (header->format == BITMAP_SERIALIZE_FORMAT__SPARSE) ? P_index_size1(header->words_num) : 0;
+    header->crc32c = (uint32_t)P_load_le2(&src[24], 4);
+    if(
+            (header->format == BITMAP_SERIALIZE_FORMAT__DENSE && words_present != header->words_num) ||
+            words_present > header->words_num ||
+            header->words_num > (SIZE_MAX - BITMAP_SERIALIZE_HEADER_SIZE) / P_WORD_SIZE / 2
+    )
+    {
+        return -1;
+    }
+    header->words_present = (size_t)words_present;
+    header->size = BITMAP_SERIALIZE_HEADER_SIZE + header->index_size + header->words_present * P_WORD_SIZE;
+    return 0;
+}
+
+size_t bitmap_serialize5(
+        void * BITMAP_RESTRICT dest,
+        size_t dest_size,
+        const bitmap_block_t * BITMAP_RESTRICT bitmap,
+        size_t bits_num,
+        enum bitmap_serialize_format format
+)
+{
+    size_t words_num = (bits_num + P_WORD_BITS - 1) / P_WORD_BITS;
+    size_t index_size = 0;
+    size_t words_present = words_num;
+    size_t iword;
+
+    if(format == BITMAP_SERIALIZE_FORMAT__SPARSE)
+    {
+        index_size = P_index_size1(words_num);
+        words_present = 0;
+        for(iword = 0; iword < words_num; ++iword)
+        {
+            if(P_word_get3(bitmap, bits_num, iword) != 0)
+            {
+                ++words_present;
+            }
+        }
+    }
+
+    size_t size = BITMAP_SERIALIZE_HEADER_SIZE + index_size + words_present * P_WORD_SIZE;
+    if(size > dest_size)
+    {
+        return size;
+    }
+
+    uint8_t * header = dest;
+    uint8_t * payload = &header[BITMAP_SERIALIZE_HEADER_SIZE];
+    uint8_t * words = &payload[index_size];
+    memset(payload, 0, index_size);
+    for(iword = 0; iword < words_num; ++iword)
+    {
+        uint64_t word = P_word_get3(bitmap, bits_num, iword);
+        if(format == BITMAP_SERIALIZE_FORMAT__SPARSE)
+        {
+            if(word == 0)
+            {
+                continue;
+            }
+            payload[iword / 8] |= (uint8_t)(1 << (iword % 8));
+        }
+        P_store_le3(words, word, P_WORD_SIZE);
+        words += P_WORD_SIZE;
+    }
+
+    memcpy(header, P_MAGIC, 4);
+    P_store_le3(&header[4], P_VERSION, 2);
+    P_store_le3(&header[6], format, 2);
+    P_store_le3(&header[8], bits_num, 8);
+    P_store_le3(&header[16], words_present, 8);
+    P_store_le3(&header[24], bitmap_P_crc32c(0, payload, size - BITMAP_SERIALIZE_HEADER_SIZE), 4);
+    P_store_le3(&header[28], 0, 4);
+    return size;
+}
+
+int bitmap_deserialize_info4(
+        const void * BITMAP_RESTRICT src,
+        size_t src_size,
+        size_t * BITMAP_RESTRICT bits_num,
+        size_t * BITMAP_RESTRICT size
+)
+{
+    struct P_header header;
+    if(P_header_parse3(&header, src, src_size) != 0)
+    {
+        return -1;
+    }
+    *bits_num = header.bits_num;
+    *size = header.size;
+    return 0;
+}
+
+int bitmap_deserialize4(
+        bitmap_block_t * BITMAP_RESTRICT dest,
+        size_t dest_bits_num,
+        const void * BITMAP_RESTRICT src,
+        size_t src_size
+)
+{
+    struct P_header header;
+    if(
+            P_header_parse3(&header, src, src_size) != 0 ||
+            header.size > src_size ||
+            header.bits_num > dest_bits_num
+    )
+    {
+        return -1;
+    }
+
+    const uint8_t * payload = (const uint8_t *)src + BITMAP_SERIALIZE_HEADER_SIZE;
+    const uint8_t * words = &payload[header.index_size];
+    if(bitmap_P_crc32c(0, payload, header.size - BITMAP_SERIALIZE_HEADER_SIZE) != header.crc32c)
+    {
+        return -1;
+    }
+
+    size_t iword;
+    if(header.format == BITMAP_SERIALIZE_FORMAT__DENSE)
+    {
+        for(iword = 0; iword < header.words_num; ++iword)
+        {
+            P_word_set4(dest, header.bits_num, iword, P_load_le2(&words[iword * P_WORD_SIZE], P_WORD_SIZE));
+        }
+        return 0;
+    }
+
+    /* the index is checked before the write: dest is not changed on error */
+    size_t present = 0;
+    size_t ibyte;
+    for(ibyte = 0; ibyte < header.index_size; ++ibyte)
+    {
+        present += (size_t)__builtin_popcount(payload[ibyte]);
+    }
+    size_t index_bits_num = header.index_size * 8;
+    if(
+            present != header.words_present ||
+            (index_bits_num > header.words_num && (P_load_le2(&payload[header.index_size - P_WORD_SIZE], P_WORD_SIZE) >> (header.words_num % P_WORD_BITS)) != 0)
+    )
+    {
+        return -1;
+    }
+
+    for(iword = 0; iword < header.words_num; ++iword)
+    {
+        uint64_t word = 0;
+        if(payload[iword / 8] & (1 << (iword % 8)))
+        {
+            word = P_load_le2(words, P_WORD_SIZE);
+            words += P_WORD_SIZE;
+        }
+        P_word_set4(dest, header.bits_num, iword, word);
+    }
+    return 0;
+}
+
+int bitmap_deserialize_view4(
+        const bitmap_block_t ** BITMAP_RESTRICT view,
+        size_t * BITMAP_RESTRICT bits_num,
+        const void * BITMAP_RESTRICT src,
+        size_t src_size
+)
+{
+    struct P_header header;
+    if(P_header_parse3(&header, src, src_size) != 0 || header.size > src_size)
+    {
+        return -1;
+    }
+
+    const uint8_t * payload = (const uint8_t *)src + BITMAP_SERIALIZE_HEADER_SIZE;
+    if(
+            !P_LITTLE_ENDIAN ||
+            header.format != BITMAP_SERIALIZE_FORMAT__DENSE ||
+            (uintptr_t)payload % _Alignof(bitmap_block_t) != 0
+    )
+    {
+        return -1;
+    }
+    *view = (const bitmap_block_t *)payload;
+    *bits_num = header.bits_num;
+    return 0;
+}
@@ -0,0 +1,310 @@
+/**
+ * @file bitmap_simd.c
+ * @brief Scalar kernels of the bulk operations and selection of the kernels by the CPU features.
+ */
+
+#include <bitmap/bitmap.h>
+
+#include "bitmap_common.h"
+#include "bitmap_simd.h"
+
+#if BITMAP_SIMD_X86
+#   include <immintrin.h>
+#endif
+
+#define SIMD_TABLE          bitmap_P_simd_scalar
+#define SIMD_TABLE_NAME     "scalar"
+#define SIMD_VEC            bitmap_block_t
+#define SIMD_BLOCKS         1
+#define SIMD_LOAD(p)        (*(p))
+#define SIMD_STORE(p, v)    (*(p) = (v))
+#define SIMD_NOT(a)         (~(a))
+#define SIMD_OR(a, b)       ((a) | (b))
+#define SIMD_AND(a, b)      ((a) & (b))
+#define SIMD_CLEAR(a, b)    ((a) & ~(b))
+#define SIMD_IS_ZERO(a)     ((a) == 0)
+
+#include "bitmap_simd_template.h"
+
+/**
+ * @brief Define the scalar cardinality kernel of the binary operation
+ * @param xname         Name of the kernel
+ * @param xop           Binary operator
+ * @param xattr         Attributes of the kernel
+ */
+#define SIMD_DEFINE_POWER_SCALAR_OP(xname, xop, xattr) \
+        xattr static size_t xname( \
+                const bitmap_block_t * a, \
+                const bitmap_block_t * b, \
+                size_t blocks_num \
+        ) \
+        { \
+            size_t power = 0; \
+            size_t iblock; \
+            BITMAP_FOREACH_BLOCK(iblock, blocks_num) \
+            { \
+                power += POPCOUNT(xop(a[iblock], b[iblock])); \
+            } \
+            return power; \
+        }
+
+#define SCALAR_XOR(a, b)    ((a) ^ (b))
+
+/**
+ * @brief Define the scalar kernel of the powers of a & b and of a | b
+ * @param xname         Name of the kernel
+ * @param xattr         Attributes of the kernel
+ */
+#define SIMD_DEFINE_POWER_SCALAR_AND_OR(xname, xattr) \
+        xattr static void xname( \
+                const bitmap_block_t * a, \
+                const bitmap_block_t * b, \
+                size_t blocks_num, \
+                size_t * power_and, \
+                size_t * power_or \
+        ) \
+        { \
+            size_t power_and_tmp = 0; \
+            size_t power_or_tmp = 0; \
+            size_t iblock; \
+            BITMAP_FOREACH_BLOCK(iblock, blocks_num) \
+            { \
+                bitmap_block_t blockA = a[iblock]; \
+                bitmap_block_t blockB = b[iblock]; \
+                power_and_tmp += POPCOUNT(blockA & blockB); \
+                power_or_tmp += POPCOUNT(blockA | blockB); \
+            } \
+            *power_and = power_and_tmp; \
+            *power_or = power_or_tmp; \
+        }
+
+/**
+ * @brief Select in the block: skip the bytes by their power, then the lower bits of the byte
+ */
+size_t bitmap_P_select_scalar(
+        bitmap_block_t block,
+        size_t rank
+)
+{
+    size_t index = 0;
+    size_t power;
+    while((power = (size_t)POPCOUNT(block & 0xff)) <= rank)
+    {
+        rank -= power;
+        block >>= 8;
+        index += 8;
+    }
+    for(; rank > 0; --rank)
+    {
+        block &= block - 1;
+    }
+    return index + (size_t)CTZ(block);
+}
+
+#if BITMAP_SIMD_X86 && defined(__x86_64__)
+/**
+ * @brief Select in the block: deposit the bit of the rank to the position of the raised bit of the rank
+ */
+__attribute__((target("bmi,bmi2")))
+size_t bitmap_P_select_bmi2(
+        bitmap_block_t block,
+        size_t rank
+)
+{
+    return (size_t)CTZ(_pdep_u64((bitmap_block_t)1 << rank, block));
+}
+#endif
+
+/**
+ * @brief Define the scalar cardinality kernels
+ * @param xtable        Name of the table variable
+ * @param xname         Name of the kernels set (string)
+ * @param xprefix       Prefix of the kernel names
+ * @param xattr         Attributes of the kernels
+ */
+#define SIMD_DEFINE_POWER_SCALAR(xtable, xname, xprefix, xattr) \
+        xattr static size_t xprefix ## _power( \
+                const bitmap_block_t * src, \
+                size_t blocks_num \
+        ) \
+        { \
+            size_t power = 0; \
+            size_t iblock; \
+            BITMAP_FOREACH_BLOCK(iblock, blocks_num) \
+            { \
+                power += POPCOUNT(src[iblock]); \
+            } \
+            return power; \
+        } \
+        SIMD_DEFINE_POWER_SCALAR_OP(xprefix ## _power_and  , SCALAR_AND  , xattr) \
+        SIMD_DEFINE_POWER_SCALAR_OP(xprefix ## _power_or   , SCALAR_OR   , xattr) \
+        SIMD_DEFINE_POWER_SCALAR_OP(xprefix ## _power_clear, SCALAR_CLEAR, xattr) \
+        SIMD_DEFINE_POWER_SCALAR_OP(xprefix ## _power_xor  , SCALAR_XOR  , xattr) \
+        SIMD_DEFINE_POWER_SCALAR_AND_OR(xprefix ## _power_and_or, xattr) \
+        const struct bitmap_P_simd_power xtable = \
+        { \
+                .name         = xname, \
+                .power        = xprefix ## _power, \
+                .power_and    = xprefix ## _power_and, \
+                .power_or     = xprefix ## _power_or, \
+                .power_and_or = xprefix ## _power_and_or, \
+                .power_clear  = xprefix ## _power_clear, \
+                .power_xor    = xprefix ## _power_xor, \
+        }
+
+/* popcount of the libgcc, or the instruction if enabled by the compiler flags */
+SIMD_DEFINE_POWER_SCALAR(bitmap_P_simd_power_scalar, "scalar", P_scalar, );
+
+#if BITMAP_SIMD_X86
+/* the POPCNT instruction */
+SIMD_DEFINE_POWER_SCALAR(bitmap_P_simd_power_popcnt, "popcnt", P_popcnt, __attribute__((target("popcnt"))));
+#endif
+
+const struct bitmap_P_simd * bitmap_P_simd = &bitmap_P_simd_scalar;
+const struct bitmap_P_simd_power * bitmap_P_simd_power = &bitmap_P_simd_power_scalar;
+size_t (*bitmap_P_select)(bitmap_block_t block, size_t rank) = bitmap_P_select_scalar;
+uint32_t (*bitmap_P_crc32c)(uint32_t crc, const void * data, size_t size) = bitmap_P_crc32c_table;
+
+/**
+ * @brief Get the cardinality kernels of the set, if they are supported by the CPU
+ * @param simd      The kernels set, except BITMAP_SIMD__AUTO
+ * @return The kernels or NULL
+ */
+static const struct bitmap_P_simd_power * P_simd_power_supported(enum bitmap_simd simd)
+{
+    switch(simd)
+    {
+        case BITMAP_SIMD__AUTO:
+        {
+            break;
+        }
+        case BITMAP_SIMD__SCALAR:
+        {
+            return &bitmap_P_simd_power_scalar;
+        }
+#if BITMAP_SIMD_X86
+        case BITMAP_SIMD__SSE2:
+        {
+            return __builtin_cpu_supports("popcnt") ? &bitmap_P_simd_power_popcnt : NULL;
+        }
+        case BITMAP_SIMD__AVX2:
+        {
+            return __builtin_cpu_supports("avx2") ? &bitmap_P_simd_power_avx2 : NULL;
+        }
+        case BITMAP_SIMD__AVX512:
+        {
+            return (
+                    __builtin_cpu_supports("avx512f") &&
+                    __builtin_cpu_supports("avx512vpopcntdq")
+            ) ? &bitmap_P_simd_power_avx512 : NULL;
+        }
+#else
+        case BITMAP_SIMD__SSE2:
+        case BITMAP_SIMD__AVX2:
+        case BITMAP_SIMD__AVX512:
+        {
+            break;
+        }
+#endif
+    }
+    return NULL;
+}
+
+/**
+ * @brief Get the kernels set, if it is supported by the CPU
+ * @param simd      The kernels set, except BITMAP_SIMD__AUTO
+ * @return The kernels or NULL
+ */
+static const struct bitmap_P_simd * P_simd_supported(enum bitmap_simd simd)
+{
+    switch(simd)
+    {
+        case BITMAP_SIMD__AUTO:
+        {
+            break;
+        }
+        case BITMAP_SIMD__SCALAR:
+        {
+            return &bitmap_P_simd_scalar;
+        }
+#if BITMAP_SIMD_X86
+        case BITMAP_SIMD__SSE2:
+        {
+            return __builtin_cpu_supports("sse2") ? &bitmap_P_simd_sse2 : NULL;
+        }
+        case BITMAP_SIMD__AVX2:
+        {
+            return __builtin_cpu_supports("avx2") ? &bitmap_P_simd_avx2 : NULL;
+        }
+        case BITMAP_SIMD__AVX512:
+        {
+            return (
+                    __builtin_cpu_supports("avx512f") &&
+                    __builtin_cpu_supports("avx2") &&
+                    __builtin_cpu_supports("popcnt")
+            ) ? &bitmap_P_simd_avx512 : NULL;
+        }
+#else
+        case BITMAP_SIMD__SSE2:
+        case BITMAP_SIMD__AVX2:
+        case BITMAP_SIMD__AVX512:
+        {
+            break;
+        }
+#endif
+    }
+    return NULL;
+}
+
+enum bitmap_simd bitmap_simd_select1(
+        enum bitmap_simd simd
+)
+{
+    if(simd == BITMAP_SIMD__AUTO || simd > BITMAP_SIMD__AVX512)
+    {
+        simd = BITMAP_SIMD__AVX512;
+    }
+
+#if BITMAP_SIMD_X86
+    __builtin_cpu_init();
+#endif
+
+    /* the best supported, not above requested */
+    enum bitmap_simd ipower;
+    for(ipower = simd; P_simd_power_supported(ipower) == NULL; --ipower);
+    bitmap_P_simd_power = P_simd_power_supported(ipower);
+
+    enum bitmap_simd isimd;
+    for(isimd = simd; P_simd_supported(isimd) == NULL; --isimd);
+    bitmap_P_simd = P_simd_supported(isimd);
+
+    /* PDEP is microcoded on AMD family 17h (Zen, Zen 2): the scalar select is faster there */
+    bitmap_P_select = bitmap_P_select_scalar;
+#if BITMAP_SIMD_X86
+    if(simd != BITMAP_SIMD__SCALAR && __builtin_cpu_supports("bmi2") && !__builtin_cpu_is("amdfam17h"))
+    {
+        bitmap_P_select = bitmap_P_select_bmi2;
+    }
+#endif
+
+    /* the CRC32C instruction does not depend on the vector width */
+    bitmap_P_crc32c = bitmap_P_crc32c_table;
+#if BITMAP_SIMD_X86
+    if(simd != BITMAP_SIMD__SCALAR && __builtin_cpu_supports("sse4.2"))
+    {
+        bitmap_P_crc32c = bitmap_P_crc32c_sse42;
+    }
+#endif
+
+    bitmap_P_version_simd_set2(bitmap_P_simd->name, bitmap_P_simd_power->name);
+    return isimd;
+}
+
+/**
+ * @brief Resolve the kernels once, at load time
+ */
+__attribute__((constructor))
+static void P_simd_resolve(void)
+{
+    bitmap_simd_select1(BITMAP_SIMD__AUTO);
+}
@@ -0,0 +1,239 @@
+/**
+ * @file bitmap_simd.h
+ * @brief Internal: kernels of the bulk operations, selected at load time by the CPU features.
+ */
+
+#ifndef SRC_BITMAP_SIMD_H_
+#define SRC_BITMAP_SIMD_H_
+
+#include <bitmap/bitmap.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#   define BITMAP_SIMD_X86 1
+#else
+#   define BITMAP_SIMD_X86 0
+#endif
+
+/**
+ * @brief Table of the kernels
+ * @note All kernels work on the whole blocks, the tail bits are processed as is.
+ */
+struct bitmap_P_simd
+{
+    const char * name; /**< Name of the kernels set, reported by bitmap_version0() */
+
+    /** @brief dest = ~src */
+    void (*not3)(
+            bitmap_block_t * BITMAP_RESTRICT dest,
+            const bitmap_block_t * BITMAP_RESTRICT src,
+            size_t blocks_num
+    );
+    /** @brief dest = dest | src */
+    void (*or3)(
+            bitmap_block_t * BITMAP_RESTRICT dest,
+            const bitmap_block_t * BITMAP_RESTRICT src,
+            size_t blocks_num
+    );
+    /** @brief dest = a | b */
+    void (*or4)(
+            bitmap_block_t * BITMAP_RESTRICT dest,
+            const bitmap_block_t * BITMAP_RESTRICT a,
+            const bitmap_block_t * BITMAP_RESTRICT b,
+            size_t blocks_num
+    );
+    /** @brief dest = dest & src */
+    void (*and3)(
+            bitmap_block_t * BITMAP_RESTRICT dest,
+            const bitmap_block_t * BITMAP_RESTRICT src,
+            size_t blocks_num
+    );
+    /** @brief dest = a & b */
+    void (*and4)(
+            bitmap_block_t * BITMAP_RESTRICT dest,
+            const bitmap_block_t * BITMAP_RESTRICT a,
+            const bitmap_block_t * BITMAP_RESTRICT b,
+            size_t blocks_num
+    );
+    /** @brief dest = dest & ~src */
+    void (*clear3)(
+            bitmap_block_t * BITMAP_RESTRICT dest,
+            const bitmap_block_t * BITMAP_RESTRICT src,
+            size_t blocks_num
+    );
+    /** @brief dest = a & ~b */
+    void (*clear4)(
+            bitmap_block_t * BITMAP_RESTRICT dest,
+            const bitmap_block_t * BITMAP_RESTRICT a,
+            const bitmap_block_t * BITMAP_RESTRICT b,
+            size_t blocks_num
+    );
+    /** @brief Index of the first non-zero block, or blocks_num if all blocks are zero */
+    size_t (*find_nonzero)(
+            const bitmap_block_t * src,
+            size_t blocks_num
+    );
+    /** @brief Index of the first block with a cleared bit, or blocks_num if all bits are raised */
+    size_t (*find_notfull)(
+            const bitmap_block_t * src,
+            size_t blocks_num
+    );
+    /**
+     * @brief Decode the raised bits to indices: base + block index * BITMAP_BITS_IN_BLOCK() + bit index.
+     * @details Whole blocks are decoded while the destination has room for BITMAP_BITS_IN_BLOCK() indices,
+     *          the kernel may write garbage in this room after the last written index.
+     * @return Amount of the decoded blocks, the amount of written indices is stored into `<written>`.
+     */
+    size_t (*decode_u32)(
+            uint32_t * BITMAP_RESTRICT dest,
+            size_t dest_num,
+            const bitmap_block_t * BITMAP_RESTRICT src,
+            size_t blocks_num,
+            uint32_t base,
+            size_t * BITMAP_RESTRICT written
+    );
+    /** @brief The same as decode_u32, to size_t indices */
+    size_t (*decode_size)(
+            size_t * BITMAP_RESTRICT dest,
+            size_t dest_num,
+            const bitmap_block_t * BITMAP_RESTRICT src,
+            size_t blocks_num,
+            size_t base,
+            size_t * BITMAP_RESTRICT written
+    );
+    /** @brief Amount of the leading decimal digits '0'..'9' of the chars */
+    size_t (*span_digits)(
+            const char * src,
+            size_t size
+    );
+};
+
+/**
+ * @brief Table of the cardinality kernels
+ * @note All kernels count the whole blocks, the tail bits are counted as is.
+ */
+struct bitmap_P_simd_power
+{
+    const char * name; /**< Name of the kernels set, reported by bitmap_version0() */
+
+    /** @brief Power of src */
+    size_t (*power)(
+            const bitmap_block_t * src,
+            size_t blocks_num
+    );
+    /** @brief Power of a & b */
+    size_t (*power_and)(
+            const bitmap_block_t * a,
+            const bitmap_block_t * b,
+            size_t blocks_num
+    );
+    /** @brief Power of a | b */
+    size_t (*power_or)(
+            const bitmap_block_t * a,
+            const bitmap_block_t * b,
+            size_t blocks_num
+    );
+    /** @brief Power of a & b and of a | b, by one pass over the blocks */
+    void (*power_and_or)(
+            const bitmap_block_t * a,
+            const bitmap_block_t * b,
+            size_t blocks_num,
+            size_t * power_and,
+            size_t * power_or
+    );
+    /** @brief Power of a & ~b */
+    size_t (*power_clear)(
+            const bitmap_block_t * a,
+            const bitmap_block_t * b,
+            size_t blocks_num
+    );
+    /** @brief Power of a ^ b */
+    size_t (*power_xor)(
+            const bitmap_block_t * a,
+            const bitmap_block_t * b,
+            size_t blocks_num
+    );
+};
+
+/** @brief The selected kernels */
+extern const struct bitmap_P_simd * bitmap_P_simd BITMAP_VISIBILITY_HIDDEN;
+/** @brief The selected cardinality kernels */
+extern const struct bitmap_P_simd_power * bitmap_P_simd_power BITMAP_VISIBILITY_HIDDEN;
+/** @brief The selected select kernel: index of the raised bit of the rank `<rank>` in the block, rank < power of the block */
+extern size_t (*bitmap_P_select)(
+        bitmap_block_t block,
+        size_t rank
+) BITMAP_VISIBILITY_HIDDEN;
+/** @brief The selected CRC32C kernel: continues the crc of the previous bytes */
+extern uint32_t (*bitmap_P_crc32c)(
+        uint32_t crc,
+        const void * data,
+        size_t size
+) BITMAP_VISIBILITY_HIDDEN;
+
+extern const struct bitmap_P_simd bitmap_P_simd_scalar BITMAP_VISIBILITY_HIDDEN;
+#if BITMAP_SIMD_X86
+extern const struct bitmap_P_simd bitmap_P_simd_sse2 BITMAP_VISIBILITY_HIDDEN;
+extern const struct bitmap_P_simd bitmap_P_simd_avx2 BITMAP_VISIBILITY_HIDDEN;
+extern const struct bitmap_P_simd bitmap_P_simd_avx512 BITMAP_VISIBILITY_HIDDEN;
+#endif
+
+extern const struct bitmap_P_simd_power bitmap_P_simd_power_scalar BITMAP_VISIBILITY_HIDDEN;
+#if BITMAP_SIMD_X86
+extern const struct bitmap_P_simd_power bitmap_P_simd_power_popcnt BITMAP_VISIBILITY_HIDDEN;
+extern const struct bitmap_P_simd_power bitmap_P_simd_power_avx2 BITMAP_VISIBILITY_HIDDEN;
+extern const struct bitmap_P_simd_power bitmap_P_simd_power_avx512 BITMAP_VISIBILITY_HIDDEN;
+#endif
+
+size_t bitmap_P_select_scalar(
+        bitmap_block_t block,
+        size_t rank
+) BITMAP_VISIBILITY_HIDDEN;
+
+#if BITMAP_SIMD_X86 && defined(__x86_64__)
+size_t bitmap_P_select_bmi2(
+        bitmap_block_t block,
+        size_t rank
+) BITMAP_VISIBILITY_HIDDEN;
+#elif BITMAP_SIMD_X86
+/* _pdep_u64() is x86-64 only */
+#   define bitmap_P_select_bmi2  bitmap_P_select_scalar
+#endif
+
+uint32_t bitmap_P_crc32c_table(
+        uint32_t crc,
+        const void * data,
+        size_t size
+) BITMAP_VISIBILITY_HIDDEN;
+
+#if BITMAP_SIMD_X86
+uint32_t bitmap_P_crc32c_sse42(
+        uint32_t crc,
+        const void * data,
+        size_t size
+) BITMAP_VISIBILITY_HIDDEN;
+#endif
+
+#if BITMAP_SIMD_X86
+size_t bitmap_P_span_digits_sse2(
+        const char * src,
+        size_t size
+) BITMAP_VISIBILITY_HIDDEN;
+size_t bitmap_P_span_digits_avx2(
+        const char * src,
+        size_t size
+) BITMAP_VISIBILITY_HIDDEN;
+#endif
+
+/**
+ * @brief Names of the selected kernels in bitmap_version0()
+ * @note Called by bitmap_simd_select1(), not thread-safe as it is.
+ */
+void bitmap_P_version_simd_set2(
+        const char * simd,
+        const char * popcount
+) BITMAP_VISIBILITY_HIDDEN;
+
+extern const uint8_t bitmap_P_decode_table[256][8] BITMAP_VISIBILITY_HIDDEN;
+extern const uint8_t bitmap_P_decode_count[256] BITMAP_VISIBILITY_HIDDEN;
+
+#endif /* SRC_BITMAP_SIMD_H_ */
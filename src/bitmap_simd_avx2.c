@@ -0,0 +1,452 @@
+/**
+ * @file bitmap_simd_avx2.c
+ * @brief AVX2 kernels of the bulk operations.
+ */
+
+#include "bitmap_simd.h"
+
+#if BITMAP_SIMD_X86
+
+#pragma GCC target("avx2")
+
+#include <immintrin.h>
+
+#define SIMD_TABLE          bitmap_P_simd_avx2
+#define SIMD_TABLE_NAME     "avx2"
+#define SIMD_VEC            __m256i
+#define SIMD_BLOCKS         (sizeof(__m256i) / sizeof(bitmap_block_t))
+#define SIMD_LOAD(p)        _mm256_loadu_si256((const __m256i *)(p))
+#define SIMD_STORE(p, v)    _mm256_storeu_si256((__m256i *)(p), (v))
+#define SIMD_NOT(a)         _mm256_xor_si256((a), _mm256_set1_epi32(-1))
+#define SIMD_OR(a, b)       _mm256_or_si256((a), (b))
+#define SIMD_AND(a, b)      _mm256_and_si256((a), (b))
+#define SIMD_CLEAR(a, b)    _mm256_andnot_si256((b), (a))
+#define SIMD_IS_ZERO(a)     _mm256_testz_si256((a), (a))
+
+/**
+ * @brief Table-driven decoding: 8 indices per byte are stored, the pointer is moved by the amount of the raised bits
+ */
+static size_t P_decode_u32(
+        uint32_t * BITMAP_RESTRICT dest,
+        size_t dest_num,
+        const bitmap_block_t * BITMAP_RESTRICT src,
+        size_t blocks_num,
+        uint32_t base,
+        size_t * BITMAP_RESTRICT written
+)
+{
+    size_t iwritten = 0;
+    size_t iblock;
+    for(iblock = 0; iblock < blocks_num && dest_num - iwritten >= BITMAP_BITS_IN_BLOCK(); ++iblock)
+    {
+        bitmap_block_t block = src[iblock];
+        uint32_t block_base = base + (uint32_t)(iblock * BITMAP_BITS_IN_BLOCK());
+        size_t ibyte;
+        for(ibyte = 0; block != 0; ++ibyte, block >>= 8)
+        {
+            uint8_t byte = (uint8_t)block;
+            __m128i positions = _mm_loadl_epi64((const __m128i *)bitmap_P_decode_table[byte]);
+            __m256i indices = _mm256_add_epi32(
+                    _mm256_cvtepu8_epi32(positions),
+                    _mm256_set1_epi32((int)(block_base + ibyte * 8))
+            );
+            _mm256_storeu_si256((__m256i *)&dest[iwritten], indices);
+            iwritten += bitmap_P_decode_count[byte];
+        }
+    }
+    (*written) = iwritten;
+    return iblock;
+}
+
+#if __SIZEOF_SIZE_T__ == 8
+/**
+ * @brief Table-driven decoding: 8 indices per byte are stored, the pointer is moved by the amount of the raised bits
+ */
+static size_t P_decode_size(
+        size_t * BITMAP_RESTRICT dest,
+        size_t dest_num,
+        const bitmap_block_t * BITMAP_RESTRICT src,
+        size_t blocks_num,
+        size_t base,
+        size_t * BITMAP_RESTRICT written
+)
+{
+    size_t iwritten = 0;
+    size_t iblock;
+    for(iblock = 0; iblock < blocks_num && dest_num - iwritten >= BITMAP_BITS_IN_BLOCK(); ++iblock)
+    {
+        bitmap_block_t block = src[iblock];
+        size_t block_base = base + iblock * BITMAP_BITS_IN_BLOCK();
+        size_t ibyte;
+        for(ibyte = 0; block != 0; ++ibyte, block >>= 8)
+        {
+            uint8_t byte = (uint8_t)block;
+            __m128i positions = _mm_loadl_epi64((const __m128i *)bitmap_P_decode_table[byte]);
+            __m256i vbase = _mm256_set1_epi64x((long long)(block_base + ibyte * 8));
+            __m256i indices_lo = _mm256_add_epi64(_mm256_cvtepu8_epi64(positions), vbase);
+            __m256i indices_hi = _mm256_add_epi64(_mm256_cvtepu8_epi64(_mm_srli_si128(positions, 4)), vbase);
+            _mm256_storeu_si256((__m256i *)&dest[iwritten], indices_lo);
+            _mm256_storeu_si256((__m256i *)&dest[iwritten + 4], indices_hi);
+            iwritten += bitmap_P_decode_count[byte];
+        }
+    }
+    (*written) = iwritten;
+    return iblock;
+}
+#   define SIMD_DECODE_SIZE  P_decode_size
+#endif
+
+#define SIMD_DECODE_U32     P_decode_u32
+
+/**
+ * @brief Digits by 32 chars, the rest by the SSE2 kernel
+ * @note The AVX-512 table uses it too: AVX-512F has no byte compares.
+ */
+size_t bitmap_P_span_digits_avx2(
+        const char * src,
+        size_t size
+)
+{
+    const __m256i below = _mm256_set1_epi8('0' - 1);
+    const __m256i above = _mm256_set1_epi8('9' + 1);
+    size_t i = 0;
+    for(; i + sizeof(__m256i) <= size; i += sizeof(__m256i))
+    {
+        __m256i chars = _mm256_loadu_si256((const __m256i *)&src[i]);
+        __m256i digits = _mm256_and_si256(_mm256_cmpgt_epi8(chars, below), _mm256_cmpgt_epi8(above, chars));
+        uint32_t others = ~(uint32_t)_mm256_movemask_epi8(digits);
+        if(others != 0)
+        {
+            return i + (size_t)__builtin_ctz(others);
+        }
+    }
+    return i + bitmap_P_span_digits_sse2(&src[i], size - i);
+}
+
+#define SIMD_SPAN_DIGITS    bitmap_P_span_digits_avx2
+
+#include "bitmap_simd_template.h"
+
+/**
+ * @brief Operations on the sources of the cardinality kernels
+ */
+enum P_power_op
+{
+    P_POWER_OP_SRC,
+    P_POWER_OP_AND,
+    P_POWER_OP_OR,
+    P_POWER_OP_CLEAR,
+    P_POWER_OP_XOR,
+};
+
+/**
+ * @brief Load the vector of the operation result
+ * @param a         The first bitmap
+ * @param b         The second bitmap, unused by P_POWER_OP_SRC
+ * @param iblock    The block index
+ * @param op        The operation, constant after the inlining
+ */
+static inline __attribute__((always_inline)) __m256i P_power_load(
+        const bitmap_block_t * a,
+        const bitmap_block_t * b,
+        size_t iblock,
+        enum P_power_op op
+)
+{
+    __m256i va = SIMD_LOAD(&a[iblock]);
+    switch(op)
+    {
+        case P_POWER_OP_SRC  : return va;
+        case P_POWER_OP_AND  : return SIMD_AND(va, SIMD_LOAD(&b[iblock]));
+        case P_POWER_OP_OR   : return SIMD_OR(va, SIMD_LOAD(&b[iblock]));
+        case P_POWER_OP_CLEAR: return SIMD_CLEAR(va, SIMD_LOAD(&b[iblock]));
+        case P_POWER_OP_XOR  : return _mm256_xor_si256(va, SIMD_LOAD(&b[iblock]));
+    }
+    return va;
+}
+
+/**
+ * @brief Power of each 64-bit lane of the vector (Mula's nibble lookup)
+ */
+static inline __m256i P_popcount256(__m256i v)
+{
+    const __m256i lookup = _mm256_setr_epi8(
+            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+    );
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    __m256i lo = _mm256_and_si256(v, low_mask);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+    __m256i bytes = _mm256_add_epi8(
+            _mm256_shuffle_epi8(lookup, lo),
+            _mm256_shuffle_epi8(lookup, hi)
+    );
+    return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+}
+
+/**
+ * @brief Carry-save adder: (high, low) = a + b + c
+ */
+static inline void P_csa(__m256i * high, __m256i * low, __m256i a, __m256i b, __m256i c)
+{
+    __m256i u = _mm256_xor_si256(a, b);
+    *high = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(u, c));
+    *low = _mm256_xor_si256(u, c);
+}
+
+/**
+ * @brief Accumulators of the Harley-Seal power
+ */
+struct P_harley_seal
+{
+    __m256i total;  /**< Power of the 16s, then the whole power */
+    __m256i ones;
+    __m256i twos;
+    __m256i fours;
+    __m256i eights;
+};
+
+static inline __attribute__((always_inline)) void P_harley_seal_init1(
+        struct P_harley_seal * hs
+)
+{
+    hs->total = _mm256_setzero_si256();
+    hs->ones = _mm256_setzero_si256();
+    hs->twos = _mm256_setzero_si256();
+    hs->fours = _mm256_setzero_si256();
+    hs->eights = _mm256_setzero_si256();
+}
+
+/**
+ * @brief Add 16 vectors of the operation result: they are reduced by carry-save adders to one popcount
+ * @param hs            The accumulators
+ * @param a             The first bitmap
+ * @param b             The second bitmap, unused by P_POWER_OP_SRC
+ * @param iblock        The block index of the first vector
+ * @param op            The operation, constant after the inlining
+ */
+static inline __attribute__((always_inline)) void P_harley_seal_add16(
+        struct P_harley_seal * hs,
+        const bitmap_block_t * a,
+        const bitmap_block_t * b,
+        size_t iblock,
+        enum P_power_op op
+)
+{
+#define LOAD(xivec) P_power_load(a, b, iblock + (xivec) * SIMD_BLOCKS, op)
+    __m256i sixteens;
+    __m256i twos_a, twos_b, fours_a, fours_b, eights_a, eights_b;
+
+    P_csa(&twos_a  , &hs->ones  , hs->ones  , LOAD( 0), LOAD( 1));
+    P_csa(&twos_b  , &hs->ones  , hs->ones  , LOAD( 2), LOAD( 3));
+    P_csa(&fours_a , &hs->twos  , hs->twos  , twos_a  , twos_b  );
+    P_csa(&twos_a  , &hs->ones  , hs->ones  , LOAD( 4), LOAD( 5));
+    P_csa(&twos_b  , &hs->ones  , hs->ones  , LOAD( 6), LOAD( 7));
+    P_csa(&fours_b , &hs->twos  , hs->twos  , twos_a  , twos_b  );
+    P_csa(&eights_a, &hs->fours , hs->fours , fours_a , fours_b );
+    P_csa(&twos_a  , &hs->ones  , hs->ones  , LOAD( 8), LOAD( 9));
+    P_csa(&twos_b  , &hs->ones  , hs->ones  , LOAD(10), LOAD(11));
+    P_csa(&fours_a , &hs->twos  , hs->twos  , twos_a  , twos_b  );
+    P_csa(&twos_a  , &hs->ones  , hs->ones  , LOAD(12), LOAD(13));
+    P_csa(&twos_b  , &hs->ones  , hs->ones  , LOAD(14), LOAD(15));
+    P_csa(&fours_b , &hs->twos  , hs->twos  , twos_a  , twos_b  );
+    P_csa(&eights_b, &hs->fours , hs->fours , fours_a , fours_b );
+    P_csa(&sixteens, &hs->eights, hs->eights, eights_a, eights_b);
+#undef LOAD
+
+    hs->total = _mm256_add_epi64(hs->total, P_popcount256(sixteens));
+}
+
+/**
+ * @brief Weight the accumulators: hs->total becomes the whole power, the vectors are added to it
+ */
+static inline __attribute__((always_inline)) void P_harley_seal_reduce1(
+        struct P_harley_seal * hs
+)
+{
+    __m256i total = _mm256_slli_epi64(hs->total, 4);
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(P_popcount256(hs->eights), 3));
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(P_popcount256(hs->fours), 2));
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(P_popcount256(hs->twos), 1));
+    hs->total = _mm256_add_epi64(total, P_popcount256(hs->ones));
+}
+
+/**
+ * @brief Load the rest blocks of the operation result by masked load, so no POPCNT instruction is required
+ * @param rest          Amount of the rest blocks, < SIMD_BLOCKS
+ */
+static inline __attribute__((always_inline)) __m256i P_power_load_rest(
+        const bitmap_block_t * a,
+        const bitmap_block_t * b,
+        size_t iblock,
+        size_t rest,
+        enum P_power_op op
+)
+{
+    __m256i mask = _mm256_cmpgt_epi64(
+            _mm256_set1_epi64x((long long)rest),
+            _mm256_setr_epi64x(0, 1, 2, 3)
+    );
+    __m256i va = _mm256_maskload_epi64((const long long *)&a[iblock], mask);
+    __m256i vb = (op == P_POWER_OP_SRC) ? va : _mm256_maskload_epi64((const long long *)&b[iblock], mask);
+    return
+            (op == P_POWER_OP_AND  ) ? SIMD_AND(va, vb) :
+            (op == P_POWER_OP_OR   ) ? SIMD_OR(va, vb) :
+            (op == P_POWER_OP_CLEAR) ? SIMD_CLEAR(va, vb) :
+            (op == P_POWER_OP_XOR  ) ? _mm256_xor_si256(va, vb) :
+                                       va;
+}
+
+/** @brief Sum of the 64-bit lanes, by the store: _mm256_extract_epi64() is x86-64 only */
+static inline size_t P_sum256(__m256i v)
+{
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i *)lanes, v);
+    return (size_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+}
+
+/**
+ * @brief Harley-Seal power: 16 vectors are reduced by carry-save adders to one popcount
+ * @param a             The first bitmap
+ * @param b             The second bitmap, unused by P_POWER_OP_SRC
+ * @param blocks_num    Amount of blocks
+ * @param op            The operation, constant after the inlining
+ */
+static inline __attribute__((always_inline)) size_t P_power_harley_seal(
+        const bitmap_block_t * a,
+        const bitmap_block_t * b,
+        size_t blocks_num,
+        enum P_power_op op
+)
+{
+    struct P_harley_seal hs;
+    P_harley_seal_init1(&hs);
+
+    size_t iblock = 0;
+    size_t hsblocks_num = blocks_num - blocks_num % (16 * SIMD_BLOCKS);
+    for(; iblock < hsblocks_num; iblock += 16 * SIMD_BLOCKS)
+    {
+        P_harley_seal_add16(&hs, a, b, iblock, op);
+    }
+    P_harley_seal_reduce1(&hs);
+
+    size_t vblocks_num = blocks_num - blocks_num % SIMD_BLOCKS;
+    for(; iblock < vblocks_num; iblock += SIMD_BLOCKS)
+    {
+        hs.total = _mm256_add_epi64(hs.total, P_popcount256(P_power_load(a, b, iblock, op)));
+    }
+
+    if(iblock < blocks_num)
+    {
+        hs.total = _mm256_add_epi64(hs.total, P_popcount256(P_power_load_rest(a, b, iblock, blocks_num - iblock, op)));
+    }
+
+    return P_sum256(hs.total);
+}
+
+static size_t P_power(
+        const bitmap_block_t * src,
+        size_t blocks_num
+)
+{
+    return P_power_harley_seal(src, NULL, blocks_num, P_POWER_OP_SRC);
+}
+
+static size_t P_power_and(
+        const bitmap_block_t * a,
+        const bitmap_block_t * b,
+        size_t blocks_num
+)
+{
+    return P_power_harley_seal(a, b, blocks_num, P_POWER_OP_AND);
+}
+
+static size_t P_power_or(
+        const bitmap_block_t * a,
+        const bitmap_block_t * b,
+        size_t blocks_num
+)
+{
+    return P_power_harley_seal(a, b, blocks_num, P_POWER_OP_OR);
+}
+
+/**
+ * @brief Harley-Seal powers of a & b and of a | b: both trees take the same vectors, the blocks are read once
+ */
+static void P_power_and_or(
+        const bitmap_block_t * a,
+        const bitmap_block_t * b,
+        size_t blocks_num,
+        size_t * power_and,
+        size_t * power_or
+)
+{
+    struct P_harley_seal hs_and;
+    struct P_harley_seal hs_or;
+    P_harley_seal_init1(&hs_and);
+    P_harley_seal_init1(&hs_or);
+
+    size_t iblock = 0;
+    size_t hsblocks_num = blocks_num - blocks_num % (16 * SIMD_BLOCKS);
+    for(; iblock < hsblocks_num; iblock += 16 * SIMD_BLOCKS)
+    {
+        /* the second tree reloads the vectors from L1 */
+        P_harley_seal_add16(&hs_and, a, b, iblock, P_POWER_OP_AND);
+        P_harley_seal_add16(&hs_or, a, b, iblock, P_POWER_OP_OR);
+    }
+    P_harley_seal_reduce1(&hs_and);
+    P_harley_seal_reduce1(&hs_or);
+
+    for(; iblock < blocks_num; iblock += SIMD_BLOCKS)
+    {
+        size_t rest = blocks_num - iblock;
+        __m256i va;
+        __m256i vb;
+        if(rest >= SIMD_BLOCKS)
+        {
+            va = SIMD_LOAD(&a[iblock]);
+            vb = SIMD_LOAD(&b[iblock]);
+        }
+        else
+        {
+            va = P_power_load_rest(a, NULL, iblock, rest, P_POWER_OP_SRC);
+            vb = P_power_load_rest(b, NULL, iblock, rest, P_POWER_OP_SRC);
+        }
+        hs_and.total = _mm256_add_epi64(hs_and.total, P_popcount256(SIMD_AND(va, vb)));
+        hs_or.total = _mm256_add_epi64(hs_or.total, P_popcount256(SIMD_OR(va, vb)));
+    }
+
+    *power_and = P_sum256(hs_and.total);
+    *power_or = P_sum256(hs_or.total);
+}
+
+static size_t P_power_clear(
+        const bitmap_block_t * a,
+        const bitmap_block_t * b,
+        size_t blocks_num
+)
+{
+    return P_power_harley_seal(a, b, blocks_num, P_POWER_OP_CLEAR);
+}
+
+static size_t P_power_xor(
+        const bitmap_block_t * a,
+        const bitmap_block_t * b,
+        size_t blocks_num
+)
+{
+    return P_power_harley_seal(a, b, blocks_num, P_POWER_OP_XOR);
+}
+
+const struct bitmap_P_simd_power bitmap_P_simd_power_avx2 =
+{
+        .name         = "avx2-harley-seal",
+        .power        = P_power,
+        .power_and    = P_power_and,
+        .power_or     = P_power_or,
+        .power_and_or = P_power_and_or,
+        .power_clear  = P_power_clear,
+        .power_xor    = P_power_xor,
+};
+
+#endif
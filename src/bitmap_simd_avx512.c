@@ -0,0 +1,187 @@
+/**
+ * @file bitmap_simd_avx512.c
+ * @brief AVX-512 kernels of the bulk operations.
+ */
+
+#include "bitmap_simd.h"
+
+#if BITMAP_SIMD_X86
+
+#pragma GCC target("avx512f")
+
+#include <immintrin.h>
+
+#define SIMD_TABLE          bitmap_P_simd_avx512
+#define SIMD_TABLE_NAME     "avx512"
+#define SIMD_VEC            __m512i
+#define SIMD_BLOCKS         (sizeof(__m512i) / sizeof(bitmap_block_t))
+#define SIMD_LOAD(p)        _mm512_loadu_si512((const void *)(p))
+#define SIMD_STORE(p, v)    _mm512_storeu_si512((void *)(p), (v))
+#define SIMD_NOT(a)         _mm512_ternarylogic_epi64((a), (a), (a), 0x55)
+#define SIMD_OR(a, b)       _mm512_or_si512((a), (b))
+#define SIMD_AND(a, b)      _mm512_and_si512((a), (b))
+#define SIMD_CLEAR(a, b)    _mm512_andnot_si512((b), (a))
+#define SIMD_IS_ZERO(a)     (_mm512_test_epi64_mask((a), (a)) == 0)
+
+/**
+ * @brief VPCOMPRESSD decoding: 16 bits of the block per step
+ */
+__attribute__((target("avx512f,popcnt")))
+static size_t P_decode_u32(
+        uint32_t * BITMAP_RESTRICT dest,
+        size_t dest_num,
+        const bitmap_block_t * BITMAP_RESTRICT src,
+        size_t blocks_num,
+        uint32_t base,
+        size_t * BITMAP_RESTRICT written
+)
+{
+    const __m512i iota = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    size_t iwritten = 0;
+    size_t iblock;
+    for(iblock = 0; iblock < blocks_num && dest_num - iwritten >= BITMAP_BITS_IN_BLOCK(); ++iblock)
+    {
+        bitmap_block_t block = src[iblock];
+        uint32_t block_base = base + (uint32_t)(iblock * BITMAP_BITS_IN_BLOCK());
+        size_t ichunk;
+        for(ichunk = 0; block != 0; ++ichunk, block >>= 16)
+        {
+            __mmask16 mask = (__mmask16)block;
+            __m512i indices = _mm512_add_epi32(iota, _mm512_set1_epi32((int)(block_base + ichunk * 16)));
+            _mm512_storeu_si512(&dest[iwritten], _mm512_maskz_compress_epi32(mask, indices));
+            iwritten += (size_t)__builtin_popcount(mask);
+        }
+    }
+    (*written) = iwritten;
+    return iblock;
+}
+
+#if __SIZEOF_SIZE_T__ == 8
+/**
+ * @brief VPCOMPRESSQ decoding: 8 bits of the block per step
+ */
+__attribute__((target("avx512f,popcnt")))
+static size_t P_decode_size(
+        size_t * BITMAP_RESTRICT dest,
+        size_t dest_num,
+        const bitmap_block_t * BITMAP_RESTRICT src,
+        size_t blocks_num,
+        size_t base,
+        size_t * BITMAP_RESTRICT written
+)
+{
+    const __m512i iota = _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7);
+    size_t iwritten = 0;
+    size_t iblock;
+    for(iblock = 0; iblock < blocks_num && dest_num - iwritten >= BITMAP_BITS_IN_BLOCK(); ++iblock)
+    {
+        bitmap_block_t block = src[iblock];
+        size_t block_base = base + iblock * BITMAP_BITS_IN_BLOCK();
+        size_t ichunk;
+        for(ichunk = 0; block != 0; ++ichunk, block >>= 8)
+        {
+            __mmask8 mask = (__mmask8)block;
+            __m512i indices = _mm512_add_epi64(iota, _mm512_set1_epi64((long long)(block_base + ichunk * 8)));
+            _mm512_storeu_si512(&dest[iwritten], _mm512_maskz_compress_epi64(mask, indices));
+            iwritten += (size_t)__builtin_popcount(mask);
+        }
+    }
+    (*written) = iwritten;
+    return iblock;
+}
+#   define SIMD_DECODE_SIZE  P_decode_size
+#endif
+
+#define SIMD_DECODE_U32     P_decode_u32
+/* AVX-512F has no byte compares, each AVX-512 CPU has AVX2 */
+#define SIMD_SPAN_DIGITS    bitmap_P_span_digits_avx2
+
+#include "bitmap_simd_template.h"
+
+/**
+ * @brief Define the cardinality kernel on the VPOPCNTDQ instruction
+ * @param xname     Name of the kernel
+ * @param xparams   Parameters of the kernel, except the amount of blocks
+ * @param xload     Load the vector of the operation result: xload(mask, iblock)
+ */
+#define SIMD_DEFINE_POWER(xname, xparams, xload) \
+        __attribute__((target("avx512f,avx512vpopcntdq"))) \
+        static size_t xname(xparams, size_t blocks_num) \
+        { \
+            __m512i total = _mm512_setzero_si512(); \
+            size_t iblock = 0; \
+            size_t vblocks_num = blocks_num - blocks_num % SIMD_BLOCKS; \
+            for(; iblock < vblocks_num; iblock += SIMD_BLOCKS) \
+            { \
+                total = _mm512_add_epi64(total, _mm512_popcnt_epi64(xload((__mmask8)0xff, iblock))); \
+            } \
+            if(iblock < blocks_num) \
+            { \
+                __mmask8 mask = (__mmask8)((1u << (blocks_num - iblock)) - 1); \
+                total = _mm512_add_epi64(total, _mm512_popcnt_epi64(xload(mask, iblock))); \
+            } \
+            return (size_t)_mm512_reduce_add_epi64(total); \
+        }
+
+#define LOAD_MASKED(xmask, xsrc, xiblock) \
+        _mm512_maskz_loadu_epi64((xmask), &(xsrc)[xiblock])
+#define LOAD_SRC(xmask, xiblock) \
+        LOAD_MASKED(xmask, src, xiblock)
+#define LOAD_AND(xmask, xiblock) \
+        SIMD_AND(LOAD_MASKED(xmask, a, xiblock), LOAD_MASKED(xmask, b, xiblock))
+#define LOAD_OR(xmask, xiblock) \
+        SIMD_OR(LOAD_MASKED(xmask, a, xiblock), LOAD_MASKED(xmask, b, xiblock))
+#define LOAD_CLEAR(xmask, xiblock) \
+        SIMD_CLEAR(LOAD_MASKED(xmask, a, xiblock), LOAD_MASKED(xmask, b, xiblock))
+#define LOAD_XOR(xmask, xiblock) \
+        _mm512_xor_si512(LOAD_MASKED(xmask, a, xiblock), LOAD_MASKED(xmask, b, xiblock))
+
+#define PARAMS_SRC  const bitmap_block_t * src
+#define PARAMS_AB   const bitmap_block_t * a, const bitmap_block_t * b
+
+SIMD_DEFINE_POWER(P_power      , PARAMS_SRC, LOAD_SRC  )
+SIMD_DEFINE_POWER(P_power_and  , PARAMS_AB , LOAD_AND  )
+SIMD_DEFINE_POWER(P_power_or   , PARAMS_AB , LOAD_OR   )
+SIMD_DEFINE_POWER(P_power_clear, PARAMS_AB , LOAD_CLEAR)
+SIMD_DEFINE_POWER(P_power_xor  , PARAMS_AB , LOAD_XOR  )
+
+/**
+ * @brief Powers of a & b and of a | b, the blocks are read once
+ */
+__attribute__((target("avx512f,avx512vpopcntdq")))
+static void P_power_and_or(
+        const bitmap_block_t * a,
+        const bitmap_block_t * b,
+        size_t blocks_num,
+        size_t * power_and,
+        size_t * power_or
+)
+{
+    __m512i total_and = _mm512_setzero_si512();
+    __m512i total_or = _mm512_setzero_si512();
+    size_t iblock;
+    for(iblock = 0; iblock < blocks_num; iblock += SIMD_BLOCKS)
+    {
+        size_t rest = blocks_num - iblock;
+        __mmask8 mask = (rest >= SIMD_BLOCKS) ? (__mmask8)0xff : (__mmask8)((1u << rest) - 1);
+        __m512i va = LOAD_MASKED(mask, a, iblock);
+        __m512i vb = LOAD_MASKED(mask, b, iblock);
+        total_and = _mm512_add_epi64(total_and, _mm512_popcnt_epi64(SIMD_AND(va, vb)));
+        total_or = _mm512_add_epi64(total_or, _mm512_popcnt_epi64(SIMD_OR(va, vb)));
+    }
+    *power_and = (size_t)_mm512_reduce_add_epi64(total_and);
+    *power_or = (size_t)_mm512_reduce_add_epi64(total_or);
+}
+
+const struct bitmap_P_simd_power bitmap_P_simd_power_avx512 =
+{
+        .name         = "avx512-vpopcntdq",
+        .power        = P_power,
+        .power_and    = P_power_and,
+        .power_or     = P_power_or,
+        .power_and_or = P_power_and_or,
+        .power_clear  = P_power_clear,
+        .power_xor    = P_power_xor,
+};
+
+#endif
@@ -0,0 +1,55 @@
+/**
+ * @file bitmap_simd_sse2.c
+ * @brief SSE2 kernels of the bulk operations.
+ */
+
+#include "bitmap_simd.h"
+
+#if BITMAP_SIMD_X86
+
+#pragma GCC target("sse2")
+
+#include <immintrin.h>
+
+#define SIMD_TABLE          bitmap_P_simd_sse2
+#define SIMD_TABLE_NAME     "sse2"
+#define SIMD_VEC            __m128i
+#define SIMD_BLOCKS         (sizeof(__m128i) / sizeof(bitmap_block_t))
+#define SIMD_LOAD(p)        _mm_loadu_si128((const __m128i *)(p))
+#define SIMD_STORE(p, v)    _mm_storeu_si128((__m128i *)(p), (v))
+#define SIMD_NOT(a)         _mm_xor_si128((a), _mm_set1_epi32(-1))
+#define SIMD_OR(a, b)       _mm_or_si128((a), (b))
+#define SIMD_AND(a, b)      _mm_and_si128((a), (b))
+#define SIMD_CLEAR(a, b)    _mm_andnot_si128((b), (a))
+#define SIMD_IS_ZERO(a)     (_mm_movemask_epi8(_mm_cmpeq_epi8((a), _mm_setzero_si128())) == 0xffff)
+
+/**
+ * @brief Digits by the signed compare: the chars above 0x7F are negative, they are not digits
+ */
+size_t bitmap_P_span_digits_sse2(
+        const char * src,
+        size_t size
+)
+{
+    const __m128i below = _mm_set1_epi8('0' - 1);
+    const __m128i above = _mm_set1_epi8('9' + 1);
+    size_t i = 0;
+    for(; i + sizeof(__m128i) <= size; i += sizeof(__m128i))
+    {
+        __m128i chars = _mm_loadu_si128((const __m128i *)&src[i]);
+        __m128i digits = _mm_and_si128(_mm_cmpgt_epi8(chars, below), _mm_cmplt_epi8(chars, above));
+        unsigned others = ~(unsigned)_mm_movemask_epi8(digits) & 0xFFFF;
+        if(others != 0)
+        {
+            return i + (size_t)__builtin_ctz(others);
+        }
+    }
+    for(; i < size && (unsigned char)(src[i] - '0') < 10; ++i);
+    return i;
+}
+
+#define SIMD_SPAN_DIGITS    bitmap_P_span_digits_sse2
+
+#include "bitmap_simd_template.h"
+
+#endif
@@ -0,0 +1,241 @@
+/**
+ * @file bitmap_simd_template.h
+ * @brief Internal: generic kernels, instantiated once per instruction set.
+ * @details Before the inclusion the translation unit defines:
+ *  SIMD_TABLE           Name of the table variable;
+ *  SIMD_TABLE_NAME      Name of the kernels set (string);
+ *  SIMD_VEC             Type of the vector;
+ *  SIMD_BLOCKS          Amount of bitmap blocks in the vector;
+ *  SIMD_LOAD(p)         Load the vector from unaligned address;
+ *  SIMD_STORE(p, v)     Store the vector to unaligned address;
+ *  SIMD_NOT(a)          ~a;
+ *  SIMD_OR(a, b)        a | b;
+ *  SIMD_AND(a, b)       a & b;
+ *  SIMD_CLEAR(a, b)     a & ~b;
+ *  SIMD_IS_ZERO(a)      a == 0, all bits.
+ * Optionally:
+ *  SIMD_DECODE_U32      The decode_u32 kernel, if it is not by count-trailing-zeros;
+ *  SIMD_DECODE_SIZE     The decode_size kernel, if it is not by count-trailing-zeros;
+ *  SIMD_SPAN_DIGITS     The span_digits kernel, if it is not by the chars.
+ */
+
+#ifndef SIMD_TABLE
+#   error "SIMD_TABLE is not defined"
+#endif
+
+#include "bitmap_common.h"
+#include "bitmap_simd.h"
+
+/**
+ * @brief Define the kernel: dest = op(src)
+ * @param xname     Name of the kernel
+ * @param xvop      Vector operation
+ * @param xsop      Scalar operation, for the tail
+ */
+#define SIMD_DEFINE_KERNEL2(xname, xvop, xsop) \
+        static void xname( \
+                bitmap_block_t * BITMAP_RESTRICT dest, \
+                const bitmap_block_t * BITMAP_RESTRICT src, \
+                size_t blocks_num \
+        ) \
+        { \
+            size_t iblock = 0; \
+            size_t vblocks_num = blocks_num - blocks_num % SIMD_BLOCKS; \
+            for(; iblock < vblocks_num; iblock += SIMD_BLOCKS) \
+            { \
+                SIMD_VEC vsrc = SIMD_LOAD(&src[iblock]); \
+                SIMD_STORE(&dest[iblock], xvop(vsrc)); \
+            } \
+            for(; iblock < blocks_num; ++iblock) \
+            { \
+                dest[iblock] = xsop(src[iblock]); \
+            } \
+        }
+
+/**
+ * @brief Define the kernel: dest = op(dest, src)
+ * @param xname     Name of the kernel
+ * @param xvop      Vector operation
+ * @param xsop      Scalar operation, for the tail
+ */
+#define SIMD_DEFINE_KERNEL3(xname, xvop, xsop) \
+        static void xname( \
+                bitmap_block_t * BITMAP_RESTRICT dest, \
+                const bitmap_block_t * BITMAP_RESTRICT src, \
+                size_t blocks_num \
+        ) \
+        { \
+            size_t iblock = 0; \
+            size_t vblocks_num = blocks_num - blocks_num % SIMD_BLOCKS; \
+            for(; iblock < vblocks_num; iblock += SIMD_BLOCKS) \
+            { \
+                SIMD_VEC vdest = SIMD_LOAD(&dest[iblock]); \
+                SIMD_VEC vsrc = SIMD_LOAD(&src[iblock]); \
+                SIMD_STORE(&dest[iblock], xvop(vdest, vsrc)); \
+            } \
+            for(; iblock < blocks_num; ++iblock) \
+            { \
+                dest[iblock] = xsop(dest[iblock], src[iblock]); \
+            } \
+        }
+
+/**
+ * @brief Define the kernel: dest = op(a, b)
+ * @param xname     Name of the kernel
+ * @param xvop      Vector operation
+ * @param xsop      Scalar operation, for the tail
+ */
+#define SIMD_DEFINE_KERNEL4(xname, xvop, xsop) \
+        static void xname( \
+                bitmap_block_t * BITMAP_RESTRICT dest, \
+                const bitmap_block_t * BITMAP_RESTRICT a, \
+                const bitmap_block_t * BITMAP_RESTRICT b, \
+                size_t blocks_num \
+        ) \
+        { \
+            size_t iblock = 0; \
+            size_t vblocks_num = blocks_num - blocks_num % SIMD_BLOCKS; \
+            for(; iblock < vblocks_num; iblock += SIMD_BLOCKS) \
+            { \
+                SIMD_VEC va = SIMD_LOAD(&a[iblock]); \
+                SIMD_VEC vb = SIMD_LOAD(&b[iblock]); \
+                SIMD_STORE(&dest[iblock], xvop(va, vb)); \
+            } \
+            for(; iblock < blocks_num; ++iblock) \
+            { \
+                dest[iblock] = xsop(a[iblock], b[iblock]); \
+            } \
+        }
+
+#define SCALAR_NOT(a)       (~(a))
+#define SCALAR_OR(a, b)     ((a) | (b))
+#define SCALAR_AND(a, b)    ((a) & (b))
+#define SCALAR_CLEAR(a, b)  ((a) & ~(b))
+
+SIMD_DEFINE_KERNEL2(P_not3  , SIMD_NOT  , SCALAR_NOT  )
+SIMD_DEFINE_KERNEL3(P_or3   , SIMD_OR   , SCALAR_OR   )
+SIMD_DEFINE_KERNEL4(P_or4   , SIMD_OR   , SCALAR_OR   )
+SIMD_DEFINE_KERNEL3(P_and3  , SIMD_AND  , SCALAR_AND  )
+SIMD_DEFINE_KERNEL4(P_and4  , SIMD_AND  , SCALAR_AND  )
+SIMD_DEFINE_KERNEL3(P_clear3, SIMD_CLEAR, SCALAR_CLEAR)
+SIMD_DEFINE_KERNEL4(P_clear4, SIMD_CLEAR, SCALAR_CLEAR)
+
+/**
+ * @brief Define the search of the first block, which is non-zero after the operation
+ * @param xname     Name of the kernel
+ * @param xvop      Vector operation
+ * @param xsop      Scalar operation
+ */
+#define SIMD_DEFINE_FIND(xname, xvop, xsop) \
+        static size_t xname( \
+                const bitmap_block_t * src, \
+                size_t blocks_num \
+        ) \
+        { \
+            size_t iblock = 0; \
+            /* skip 4 zero vectors per step, then find the non-zero vector and block */ \
+            size_t ublocks_num = blocks_num - blocks_num % (4 * SIMD_BLOCKS); \
+            for(; iblock < ublocks_num; iblock += 4 * SIMD_BLOCKS) \
+            { \
+                SIMD_VEC v = SIMD_OR( \
+                        SIMD_OR(xvop(SIMD_LOAD(&src[iblock                  ])), xvop(SIMD_LOAD(&src[iblock +     SIMD_BLOCKS]))), \
+                        SIMD_OR(xvop(SIMD_LOAD(&src[iblock + 2 * SIMD_BLOCKS])), xvop(SIMD_LOAD(&src[iblock + 3 * SIMD_BLOCKS]))) \
+                ); \
+                if(!SIMD_IS_ZERO(v)) \
+                { \
+                    break; \
+                } \
+            } \
+            size_t vblocks_num = blocks_num - blocks_num % SIMD_BLOCKS; \
+            for(; iblock < vblocks_num; iblock += SIMD_BLOCKS) \
+            { \
+                if(!SIMD_IS_ZERO(xvop(SIMD_LOAD(&src[iblock])))) \
+                { \
+                    break; \
+                } \
+            } \
+            for(; iblock < blocks_num; ++iblock) \
+            { \
+                if(xsop(src[iblock]) != 0) \
+                { \
+                    break; \
+                } \
+            } \
+            return iblock; \
+        }
+
+#define SIMD_IDENTITY(a)    (a)
+
+SIMD_DEFINE_FIND(P_find_nonzero, SIMD_IDENTITY, SIMD_IDENTITY)
+SIMD_DEFINE_FIND(P_find_notfull, SIMD_NOT     , SCALAR_NOT   )
+
+/**
+ * @brief Define the decoding kernel by count-trailing-zeros
+ * @param xname     Name of the kernel
+ * @param xtype     Type of the index
+ */
+#define SIMD_DEFINE_DECODE_CTZ(xname, xtype) \
+        static size_t xname( \
+                xtype * BITMAP_RESTRICT dest, \
+                size_t dest_num, \
+                const bitmap_block_t * BITMAP_RESTRICT src, \
+                size_t blocks_num, \
+                xtype base, \
+                size_t * BITMAP_RESTRICT written \
+        ) \
+        { \
+            size_t iwritten = 0; \
+            size_t iblock; \
+            for(iblock = 0; iblock < blocks_num && dest_num - iwritten >= BITMAP_BITS_IN_BLOCK(); ++iblock) \
+            { \
+                bitmap_block_t block = src[iblock]; \
+                xtype block_base = base + (xtype)(iblock * BITMAP_BITS_IN_BLOCK()); \
+                while(block != 0) \
+                { \
+                    dest[iwritten++] = block_base + (xtype)CTZ(block); \
+                    block &= block - 1; \
+                } \
+            } \
+            (*written) = iwritten; \
+            return iblock; \
+        }
+
+#ifndef SIMD_DECODE_U32
+SIMD_DEFINE_DECODE_CTZ(P_decode_u32, uint32_t)
+#   define SIMD_DECODE_U32  P_decode_u32
+#endif
+
+#ifndef SIMD_DECODE_SIZE
+SIMD_DEFINE_DECODE_CTZ(P_decode_size, size_t)
+#   define SIMD_DECODE_SIZE  P_decode_size
+#endif
+
+#ifndef SIMD_SPAN_DIGITS
+static size_t P_span_digits(
+        const char * src,
+        size_t size
+)
+{
+    size_t i;
+    for(i = 0; i < size && (unsigned char)(src[i] - '0') < 10; ++i);
+    return i;
+}
+#   define SIMD_SPAN_DIGITS  P_span_digits
+#endif
+
+const struct bitmap_P_simd SIMD_TABLE =
+{
+        .name         = SIMD_TABLE_NAME,
+        .not3         = P_not3,
+        .or3          = P_or3,
+        .or4          = P_or4,
+        .and3         = P_and3,
+        .and4         = P_and4,
+        .clear3       = P_clear3,
+        .clear4       = P_clear4,
+        .find_nonzero = P_find_nonzero,
+        .find_notfull = P_find_notfull,
+        .decode_u32   = SIMD_DECODE_U32,
+        .decode_size  = SIMD_DECODE_SIZE,
+        .span_digits  = SIMD_SPAN_DIGITS,
+};
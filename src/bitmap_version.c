@@ -4,6 +4,8 @@
 
 #include <bitmap/bitmap.h>
 
+#include "bitmap_simd.h"
+
 #include <assert.h>
 
 #ifndef VERSION_HASH
@@ -18,11 +20,13 @@
 #   define CFLAGS  ""
 #endif
 
-static const struct bitmap_version P_version =
+static struct bitmap_version P_version =
 {
         .hash      = VERSION_HASH,
         .date_time = VERSION_DATETIME,
         .cflags    = CFLAGS,
+        .simd      = NULL,
+        .popcount  = NULL,
 };
 
 const struct bitmap_version * bitmap_version0(void)
@@ -34,3 +38,12 @@ const struct bitmap_version * bitmap_version0(void)
 
     return &P_version;
 }
+
+void bitmap_P_version_simd_set2(
+        const char * simd,
+        const char * popcount
+)
+{
+    P_version.simd = simd;
+    P_version.popcount = popcount;
+}
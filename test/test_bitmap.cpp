@@ -8,8 +8,11 @@
 
 #include <catch/catch.hpp>
 
+#include <stdio.h>
 #include <string.h>
 
+#include <string>
+
 #define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
 
 #define BITMAP_SIZE3 (3)
@@ -213,6 +216,136 @@ TEST_CASE(
     }
 }
 
+TEST_CASE(
+        "bitmaps bitmap_bitwise_range test",
+        "[bitmap][bitmap_bitwise_range]"
+)
+{
+#define BITMAP_SIZE1021 (1021)
+    static BITMAP_VAR(bitmap, BITMAP_SIZE1021);
+    static BITMAP_VAR(pattern, BITMAP_SIZE1021);
+
+    static const struct bitmap_range ranges[] =
+    {
+            { 0, 0 },
+            { 5, 4 }, /* empty */
+            { 3, 60 },
+            { 0, 63 },
+            { 63, 64 },
+            { 64, 127 },
+            { 60, 200 },
+            { 1, 1019 },
+            { 0, BITMAP_SIZE1021 - 1 },
+            { 128, 1000 },
+    };
+
+    size_t i;
+    for(i = 0; i < ARRAY_SIZE(ranges); ++i)
+    {
+        const struct bitmap_range * range = &ranges[i];
+        size_t ibit;
+
+        /* raise */
+        P_prepare_fill_55(bitmap, BITMAP_SIZE1021);
+        P_prepare_fill_55(pattern, BITMAP_SIZE1021);
+        for(ibit = range->begin; ibit <= range->end; ++ibit)
+        {
+            bitmap_bit_raise2(pattern, ibit);
+        }
+        bitmap_bitwise_range_raise2(bitmap, range);
+        CHECK( memcmp(bitmap, pattern, sizeof(pattern)) == 0 );
+
+        /* clear */
+        P_prepare_fill_AA(bitmap, BITMAP_SIZE1021);
+        P_prepare_fill_AA(pattern, BITMAP_SIZE1021);
+        for(ibit = range->begin; ibit <= range->end; ++ibit)
+        {
+            bitmap_bit_clear2(pattern, ibit);
+        }
+        bitmap_bitwise_range_clear2(bitmap, range);
+        CHECK( memcmp(bitmap, pattern, sizeof(pattern)) == 0 );
+    }
+#undef BITMAP_SIZE1021
+}
+
+TEST_CASE(
+        "bitmaps bitmap_bitwise_range queries test",
+        "[bitmap][bitmap_bitwise_range]"
+)
+{
+#define BITMAP_SIZE1021 (1021)
+    static const enum bitmap_simd simds[] =
+    {
+            BITMAP_SIMD__SCALAR,
+            BITMAP_SIMD__SSE2,
+            BITMAP_SIMD__AVX2,
+            BITMAP_SIMD__AVX512,
+    };
+    static BITMAP_VAR(bitmap, BITMAP_SIZE1021);
+
+    /* zero blocks, full blocks and sparse bits */
+    bitmap_bitwise_clear2(bitmap, BITMAP_SIZE1021);
+    struct bitmap_range full = { 200, 700 };
+    bitmap_bitwise_range_raise2(bitmap, &full);
+    static const size_t indexes[] = { 3, 64, 130, 199, 701, 900, 1020 };
+    size_t i;
+    for(i = 0; i < ARRAY_SIZE(indexes); ++i)
+    {
+        bitmap_bit_raise2(bitmap, indexes[i]);
+    }
+    bitmap_bit_clear2(bitmap, 450);
+
+    static const size_t edges[] = { 0, 1, 3, 4, 63, 64, 65, 127, 128, 199, 200, 449, 450, 451, 700, 701, 702, 899, 1000, 1020 };
+
+    size_t isimd;
+    for(isimd = 0; isimd < ARRAY_SIZE(simds); ++isimd)
+    {
+        bitmap_simd_select1(simds[isimd]);
+
+        size_t ibegin;
+        size_t iend;
+        for(ibegin = 0; ibegin < ARRAY_SIZE(edges); ++ibegin)
+        {
+            for(iend = 0; iend < ARRAY_SIZE(edges); ++iend)
+            {
+                struct bitmap_range range = { edges[ibegin], edges[iend] };
+                size_t power = 0;
+                bool first_exist = false;
+                size_t first = 0;
+                size_t ibit;
+                for(ibit = range.begin; ibit <= range.end; ++ibit)
+                {
+                    if(bitmap_bit_get2(bitmap, ibit))
+                    {
+                        if(!first_exist)
+                        {
+                            first_exist = true;
+                            first = ibit;
+                        }
+                        ++power;
+                    }
+                }
+                size_t bits_num = range.begin <= range.end ? range.end - range.begin + 1 : 0;
+
+                CHECK( bitmap_bitwise_range_power2(bitmap, &range) == power );
+                CHECK( bitmap_bitwise_range_check_zero2(bitmap, &range) == (power == 0) );
+                CHECK( bitmap_bitwise_range_check_full2(bitmap, &range) == (power == bits_num) );
+
+                bitmap_bit_nearest_get_context_t nearest;
+                bitmap_bit_range_first_raised_get3(bitmap, &range, &nearest);
+                REQUIRE( nearest.exist == first_exist );
+                if(first_exist)
+                {
+                    CHECK( nearest.index == first );
+                }
+            }
+        }
+    }
+
+    bitmap_simd_select1(BITMAP_SIMD__AUTO);
+#undef BITMAP_SIZE1021
+}
+
 TEST_CASE(
         "bitmaps bitmap_bitwise_copy test",
         "[bitmap][bitmap_bitwise_copy]"
@@ -595,6 +728,84 @@ TEST_CASE(
     }
 }
 
+TEST_CASE(
+        "bitmaps bitmap_simd_select test",
+        "[bitmap][bitmap_simd_select]"
+)
+{
+#define BITMAP_SIZE1021 (1021)
+    static const enum bitmap_simd simds[] =
+    {
+            BITMAP_SIMD__SCALAR,
+            BITMAP_SIMD__SSE2,
+            BITMAP_SIMD__AVX2,
+            BITMAP_SIMD__AVX512,
+    };
+    static BITMAP_VAR(bitmap_a, BITMAP_SIZE1021);
+    static BITMAP_VAR(bitmap_b, BITMAP_SIZE1021);
+    static BITMAP_VAR(bitmap_dest, BITMAP_SIZE1021);
+    static BITMAP_VAR(bitmap_pattern, BITMAP_SIZE1021);
+
+    P_prepare_fill_55(bitmap_a, BITMAP_SIZE1021);
+    P_prepare_fill_0(bitmap_b, BITMAP_SIZE1021);
+    P_prepare_fill_111000(bitmap_b, BITMAP_SIZE1021);
+
+    size_t i;
+    for(i = 0; i < ARRAY_SIZE(simds); ++i)
+    {
+        enum bitmap_simd simd = bitmap_simd_select1(simds[i]);
+        CHECK( simd <= simds[i] );
+        CHECK( bitmap_version0()->simd != NULL );
+
+        size_t ibit;
+        bool ok;
+
+        bitmap_bitwise_not3(bitmap_dest, bitmap_a, BITMAP_SIZE1021);
+        ok = true;
+        for(ibit = 0; ibit < BITMAP_SIZE1021; ++ibit)
+        {
+            ok &= ( bitmap_bit_get2(bitmap_dest, ibit) == !bitmap_bit_get2(bitmap_a, ibit) );
+        }
+        CHECK( ok );
+
+        bitmap_bitwise_or4(bitmap_dest, bitmap_a, bitmap_b, BITMAP_SIZE1021);
+        bitmap_bitwise_copy3(bitmap_pattern, bitmap_a, BITMAP_SIZE1021);
+        bitmap_bitwise_or3(bitmap_pattern, bitmap_b, BITMAP_SIZE1021);
+        CHECK( bitmap_bitwise_check_equal3(bitmap_dest, bitmap_pattern, BITMAP_SIZE1021) );
+        ok = true;
+        for(ibit = 0; ibit < BITMAP_SIZE1021; ++ibit)
+        {
+            ok &= ( bitmap_bit_get2(bitmap_dest, ibit) == (bitmap_bit_get2(bitmap_a, ibit) || bitmap_bit_get2(bitmap_b, ibit)) );
+        }
+        CHECK( ok );
+
+        bitmap_bitwise_and4(bitmap_dest, bitmap_a, bitmap_b, BITMAP_SIZE1021);
+        bitmap_bitwise_copy3(bitmap_pattern, bitmap_a, BITMAP_SIZE1021);
+        bitmap_bitwise_and3(bitmap_pattern, bitmap_b, BITMAP_SIZE1021);
+        CHECK( bitmap_bitwise_check_equal3(bitmap_dest, bitmap_pattern, BITMAP_SIZE1021) );
+        ok = true;
+        for(ibit = 0; ibit < BITMAP_SIZE1021; ++ibit)
+        {
+            ok &= ( bitmap_bit_get2(bitmap_dest, ibit) == (bitmap_bit_get2(bitmap_a, ibit) && bitmap_bit_get2(bitmap_b, ibit)) );
+        }
+        CHECK( ok );
+
+        bitmap_bitwise_clear4(bitmap_dest, bitmap_a, bitmap_b, BITMAP_SIZE1021);
+        bitmap_bitwise_copy3(bitmap_pattern, bitmap_a, BITMAP_SIZE1021);
+        bitmap_bitwise_clear3(bitmap_pattern, bitmap_b, BITMAP_SIZE1021);
+        CHECK( bitmap_bitwise_check_equal3(bitmap_dest, bitmap_pattern, BITMAP_SIZE1021) );
+        ok = true;
+        for(ibit = 0; ibit < BITMAP_SIZE1021; ++ibit)
+        {
+            ok &= ( bitmap_bit_get2(bitmap_dest, ibit) == (bitmap_bit_get2(bitmap_a, ibit) && !bitmap_bit_get2(bitmap_b, ibit)) );
+        }
+        CHECK( ok );
+    }
+
+    bitmap_simd_select1(BITMAP_SIMD__AUTO);
+#undef BITMAP_SIZE1021
+}
+
 TEST_CASE(
         "bitmaps bitmap_bitwise_check_zero test",
         "[bitmap][bitmap_bitwise_check_zero]"
@@ -902,6 +1113,239 @@ TEST_CASE(
 
 }
 
+TEST_CASE(
+        "bitmaps bitmap_bit_nearest_forward_raised_get simd test",
+        "[bitmap][bitmap_bit_nearest_forward_set_get]"
+)
+{
+#define BITMAP_SIZE4099 (4099)
+    static const enum bitmap_simd simds[] =
+    {
+            BITMAP_SIMD__SCALAR,
+            BITMAP_SIMD__SSE2,
+            BITMAP_SIMD__AVX2,
+            BITMAP_SIMD__AVX512,
+    };
+    static BITMAP_VAR(bitmap, BITMAP_SIZE4099);
+
+    /* sparse bits with long zero gaps, trashed tail */
+    static const size_t indexes[] = { 1, 63, 64, 700, 701, 2047, 2048, 3000, 4095, 4096, 4098 };
+    P_prepare_bitmap(indexes, ARRAY_SIZE(indexes), bitmap, BITMAP_SIZE4099);
+
+    size_t isimd;
+    for(isimd = 0; isimd < ARRAY_SIZE(simds); ++isimd)
+    {
+        bitmap_simd_select1(simds[isimd]);
+
+        bitmap_foreach_bit_context_t ctx;
+        size_t ibit;
+        size_t i = 0;
+        BITMAP_FOREACH_BIT_IN_BITMAP(&ibit, bitmap, BITMAP_SIZE4099, &ctx)
+        {
+            REQUIRE( i < ARRAY_SIZE(indexes) );
+            CHECK( ibit == indexes[i] );
+            ++i;
+        }
+        CHECK( i == ARRAY_SIZE(indexes) );
+
+        /* the tail bits are not significant */
+        i = 0;
+        BITMAP_FOREACH_BIT_IN_BITMAP(&ibit, bitmap, 4097, &ctx)
+        {
+            ++i;
+        }
+        CHECK( i == ARRAY_SIZE(indexes) - 1 );
+
+        bitmap_bit_nearest_get_context_t nearest;
+        bitmap_bit_nearest_forward_raised_get4(bitmap, BITMAP_SIZE4099, 702, &nearest);
+        CHECK( nearest.exist );
+        CHECK( nearest.index == 2047 );
+        bitmap_bit_nearest_forward_raised_get4(bitmap, BITMAP_SIZE4099, BITMAP_SIZE4099, &nearest);
+        CHECK( !nearest.exist );
+    }
+
+    bitmap_simd_select1(BITMAP_SIMD__AUTO);
+#undef BITMAP_SIZE4099
+}
+
+TEST_CASE(
+        "bitmaps bitmap_bit_nearest backward and cleared test",
+        "[bitmap][bitmap_bit_nearest]"
+)
+{
+#define BITMAP_SIZE4099 (4099)
+    static const enum bitmap_simd simds[] =
+    {
+            BITMAP_SIMD__SCALAR,
+            BITMAP_SIMD__SSE2,
+            BITMAP_SIMD__AVX2,
+            BITMAP_SIMD__AVX512,
+    };
+    static BITMAP_VAR(bitmap, BITMAP_SIZE4099);
+    static BITMAP_VAR(inverted, BITMAP_SIZE4099);
+
+    /* sparse bits with long zero gaps, trashed tail */
+    static const size_t indexes[] = { 1, 63, 64, 700, 701, 2047, 2048, 3000, 4095, 4096, 4098 };
+    P_prepare_bitmap(indexes, ARRAY_SIZE(indexes), bitmap, BITMAP_SIZE4099);
+    bitmap_bitwise_not3(inverted, bitmap, BITMAP_SIZE4099);
+
+    size_t isimd;
+    for(isimd = 0; isimd < ARRAY_SIZE(simds); ++isimd)
+    {
+        bitmap_simd_select1(simds[isimd]);
+
+        bitmap_foreach_bit_context_t ctx;
+        size_t ibit;
+        size_t i = ARRAY_SIZE(indexes);
+        BITMAP_FOREACH_BIT_IN_BITMAP_REVERSE(&ibit, bitmap, BITMAP_SIZE4099, &ctx)
+        {
+            REQUIRE( i > 0 );
+            --i;
+            CHECK( ibit == indexes[i] );
+        }
+        CHECK( i == 0 );
+
+        /* the cleared bits of the inverted bitmap are the raised bits of the bitmap */
+        i = 0;
+        BITMAP_FOREACH_CLEARED_BIT_IN_BITMAP(&ibit, inverted, BITMAP_SIZE4099, &ctx)
+        {
+            REQUIRE( i < ARRAY_SIZE(indexes) );
+            CHECK( ibit == indexes[i] );
+            ++i;
+        }
+        CHECK( i == ARRAY_SIZE(indexes) );
+
+        bitmap_bit_nearest_get_context_t nearest;
+        size_t from;
+        for(from = 0; from < BITMAP_SIZE4099; from += 7)
+        {
+            size_t expected;
+            bool exist;
+
+            for(exist = false, expected = from; expected < BITMAP_SIZE4099; ++expected)
+            {
+                if(!bitmap_bit_get2(bitmap, expected)) { exist = true; break; }
+            }
+            bitmap_bit_nearest_forward_cleared_get4(bitmap, BITMAP_SIZE4099, from, &nearest);
+            REQUIRE( nearest.exist == exist );
+            if(exist) CHECK( nearest.index == expected );
+
+            for(exist = false, expected = from + 1; expected-- > 0; )
+            {
+                if(bitmap_bit_get2(bitmap, expected)) { exist = true; break; }
+            }
+            bitmap_bit_nearest_backward_raised_get4(bitmap, BITMAP_SIZE4099, from, &nearest);
+            REQUIRE( nearest.exist == exist );
+            if(exist) CHECK( nearest.index == expected );
+
+            for(exist = false, expected = from + 1; expected-- > 0; )
+            {
+                if(!bitmap_bit_get2(bitmap, expected)) { exist = true; break; }
+            }
+            bitmap_bit_nearest_backward_cleared_get4(bitmap, BITMAP_SIZE4099, from, &nearest);
+            REQUIRE( nearest.exist == exist );
+            if(exist) CHECK( nearest.index == expected );
+        }
+
+        /* the tail bits are not significant */
+        bitmap_bit_last_raised_get3(bitmap, BITMAP_SIZE4099, &nearest);
+        CHECK( nearest.exist );
+        CHECK( nearest.index == 4098 );
+        bitmap_bit_last_raised_get3(bitmap, 4098, &nearest);
+        CHECK( nearest.exist );
+        CHECK( nearest.index == 4096 );
+        bitmap_bit_last_raised_get3(bitmap, 0, &nearest);
+        CHECK( !nearest.exist );
+        bitmap_bit_nearest_forward_cleared_get4(inverted, 4098, 4097, &nearest);
+        CHECK( !nearest.exist );
+        bitmap_bit_nearest_backward_raised_get4(bitmap, BITMAP_SIZE4099, 0, &nearest);
+        CHECK( !nearest.exist );
+        bitmap_bit_nearest_backward_cleared_get4(inverted, BITMAP_SIZE4099, 0, &nearest);
+        CHECK( !nearest.exist );
+    }
+
+    {
+        static bitmap4096_t bitmap4096;
+        bitmap4096_raise1(&bitmap4096);
+        bitmap4096_bit_clear2(&bitmap4096, 5);
+        bitmap4096_bit_clear2(&bitmap4096, 4095);
+
+        bitmap4096_foreach_bit_context_t ctx4096;
+        size_t ibit;
+        size_t i = 0;
+        BITMAP4096_FOREACH_CLEARED_BIT_IN_BITMAP(&ibit, bitmap4096.data, &ctx4096)
+        {
+            CHECK( ibit == (i == 0 ? 5 : 4095) );
+            ++i;
+        }
+        CHECK( i == 2 );
+
+        i = 0;
+        BITMAP4096_FOREACH_BIT_IN_BITMAP_REVERSE(&ibit, bitmap4096.data, &ctx4096)
+        {
+            CHECK( ibit == 4094 - i - (i >= 4089 ? 1 : 0) );
+            ++i;
+        }
+        CHECK( i == 4094 );
+    }
+
+    bitmap_simd_select1(BITMAP_SIMD__AUTO);
+#undef BITMAP_SIZE4099
+}
+
+TEST_CASE(
+        "bitmaps bitmap_iterator test",
+        "[bitmap][bitmap_iterator]"
+)
+{
+#define BITMAP_SIZE1021 (1021)
+    static BITMAP_VAR(bitmap, BITMAP_SIZE1021);
+
+    /* pseudo-random content, trashed tail */
+    bitmap_bitwise_raise1(bitmap, BITMAP_SIZE1021);
+    uint32_t seed = 3;
+    size_t ibit;
+    for(ibit = 0; ibit < BITMAP_SIZE1021; ++ibit)
+    {
+        seed = seed * 1103515245 + 12345;
+        if((seed >> 16) % 5 != 0) bitmap_bit_clear2(bitmap, ibit);
+    }
+
+    static const size_t froms[] = { 0, 1, 63, 64, 65, 500, 1019, 1020, BITMAP_SIZE1021, BITMAP_SIZE1021 + 100 };
+    size_t ifrom;
+    for(ifrom = 0; ifrom < ARRAY_SIZE(froms); ++ifrom)
+    {
+        bitmap_iterator_t iterator;
+        bitmap_iterator_init4(&iterator, bitmap, BITMAP_SIZE1021, froms[ifrom]);
+
+        bitmap_bit_nearest_get_context_t nearest;
+        size_t from = froms[ifrom];
+        bool ok = true;
+        for(;;)
+        {
+            bitmap_bit_nearest_forward_raised_get4(bitmap, BITMAP_SIZE1021, from, &nearest);
+            bool exist = bitmap_iterator_next2(&iterator, &ibit);
+            ok &= (exist == nearest.exist);
+            if(!exist || !nearest.exist) break;
+            ok &= (ibit == nearest.index);
+            from = nearest.index + 1;
+        }
+        CHECK( ok );
+
+        /* the finished iterator stays finished */
+        CHECK( !bitmap_iterator_next2(&iterator, &ibit) );
+    }
+
+    {
+        /* empty bitmap */
+        bitmap_iterator_t iterator;
+        bitmap_iterator_init4(&iterator, bitmap, 0, 0);
+        CHECK( !bitmap_iterator_next2(&iterator, &ibit) );
+    }
+
+#undef BITMAP_SIZE1021
+}
+
 TEST_CASE(
         "bitmaps bitmap_snprintf_ranged test",
         "[bitmap][bitmap_snprintf_ranged]"
@@ -1001,6 +1445,113 @@ TEST_CASE(
 #undef STR_SIZE_6
 }
 
+/** @brief The sink to the std::string, counts the chunks, fails after `fail_after` chunks */
+struct P_sink_ctx
+{
+    std::string out;
+    size_t chunks;
+    size_t fail_after;
+};
+
+static int P_sink3(
+        void * ctx,
+        const char * data,
+        size_t size
+)
+{
+    struct P_sink_ctx * sink = (struct P_sink_ctx *)ctx;
+    if(sink->chunks == sink->fail_after)
+    {
+        return -1;
+    }
+    ++sink->chunks;
+    sink->out.append(data, size);
+    return 0;
+}
+
+TEST_CASE(
+        "bitmaps bitmap_print_ranged test",
+        "[bitmap][bitmap_print_ranged]"
+)
+{
+#define BITMAP_SIZE_BIG (64 * 1024 + 13)
+    static const char * enum_marker = ", ";
+    static const char * range_marker = " - ";
+    static BITMAP_VAR(bitmap, BITMAP_SIZE_BIG);
+    static char str[BITMAP_SIZE_BIG * 8];
+    size_t length;
+    size_t ibit;
+
+    /* the runs of each length */
+    P_prepare_fill_0_trashed(bitmap, BITMAP_SIZE_BIG);
+    std::string expected;
+    size_t run = 1;
+    for(ibit = 7; ibit < BITMAP_SIZE_BIG; ibit += run + 2, run = run % 70 + 1)
+    {
+        size_t end = (ibit + run - 1 < BITMAP_SIZE_BIG) ? (ibit + run - 1) : (BITMAP_SIZE_BIG - 1);
+        size_t i;
+        for(i = ibit; i <= end; ++i)
+        {
+            bitmap_bit_raise2(bitmap, i);
+        }
+        if(!expected.empty())
+        {
+            expected += enum_marker;
+        }
+        expected += std::to_string(ibit);
+        if(end != ibit)
+        {
+            expected += (ibit + 1 == end) ? enum_marker : range_marker;
+            expected += std::to_string(end);
+        }
+    }
+    REQUIRE( expected.size() > 4096 * 3 );
+
+    struct P_sink_ctx sink = { std::string(), 0, SIZE_MAX };
+    CHECK( bitmap_print_ranged7(P_sink3, &sink, bitmap, BITMAP_SIZE_BIG, enum_marker, range_marker, &length) == 0 );
+    CHECK( length == expected.size() );
+    CHECK( sink.out == expected );
+    CHECK( sink.chunks == (expected.size() + 4095) / 4096 );
+
+    /* the dry run */
+    CHECK( bitmap_print_ranged7(NULL, NULL, bitmap, BITMAP_SIZE_BIG, enum_marker, range_marker, &length) == 0 );
+    CHECK( length == expected.size() );
+    CHECK( bitmap_print_ranged_length4(bitmap, BITMAP_SIZE_BIG, enum_marker, range_marker) == expected.size() );
+
+    /* the same string by snprintf */
+    CHECK( bitmap_snprintf_ranged6(str, sizeof(str), bitmap, BITMAP_SIZE_BIG, enum_marker, range_marker) == 0 );
+    CHECK( expected == str );
+    CHECK( bitmap_snprintf_ranged6(str, 4096 + 11, bitmap, BITMAP_SIZE_BIG, enum_marker, range_marker) < 0 );
+    CHECK( expected.compare(0, 4096 + 10, str) == 0 );
+
+    /* the sink error stops the output */
+    sink.out.clear();
+    sink.chunks = 0;
+    sink.fail_after = 1;
+    CHECK( bitmap_print_ranged7(P_sink3, &sink, bitmap, BITMAP_SIZE_BIG, enum_marker, range_marker, NULL) == -1 );
+    CHECK( sink.out == expected.substr(0, 4096) );
+
+    /* the stream */
+    FILE * stream = tmpfile();
+    REQUIRE( stream != NULL );
+    CHECK( bitmap_fprint_ranged5(stream, bitmap, BITMAP_SIZE_BIG, enum_marker, range_marker) == 0 );
+    CHECK( (size_t)ftell(stream) == expected.size() );
+    rewind(stream);
+    CHECK( fread(str, 1, sizeof(str), stream) == expected.size() );
+    CHECK( expected.compare(0, expected.size(), str, expected.size()) == 0 );
+    fclose(stream);
+
+    /* the empty bitmap, the full bitmap */
+    P_prepare_fill_0_trashed(bitmap, BITMAP_SIZE_BIG);
+    CHECK( bitmap_print_ranged_length4(bitmap, BITMAP_SIZE_BIG, enum_marker, range_marker) == 0 );
+    CHECK( bitmap_print_ranged_length4(bitmap, 0, enum_marker, range_marker) == 0 );
+    bitmap_bitwise_raise1(bitmap, BITMAP_SIZE_BIG);
+    CHECK( bitmap_snprintf_ranged6(str, sizeof(str), bitmap, BITMAP_SIZE_BIG, "/", ":") == 0 );
+    CHECK( std::string(str) == "0:" + std::to_string(BITMAP_SIZE_BIG - 1) );
+
+#undef BITMAP_SIZE_BIG
+}
+
 TEST_CASE(
         "bitmaps bitmap_bitwise_power test",
         "[bitmap][bitmap_bitwise_power]"
@@ -1067,6 +1618,285 @@ TEST_CASE(
 
 }
 
+TEST_CASE(
+        "bitmaps bitmap_bitwise_power simd test",
+        "[bitmap][bitmap_bitwise_power]"
+)
+{
+#define BITMAP_SIZE10007 (10007)
+    static const enum bitmap_simd simds[] =
+    {
+            BITMAP_SIMD__SCALAR,
+            BITMAP_SIMD__SSE2,
+            BITMAP_SIMD__AVX2,
+            BITMAP_SIMD__AVX512,
+    };
+    static BITMAP_VAR(bitmap_a, BITMAP_SIZE10007);
+    static BITMAP_VAR(bitmap_b, BITMAP_SIZE10007);
+
+    /* pseudo-random content, trashed tails */
+    bitmap_bitwise_raise1(bitmap_a, BITMAP_SIZE10007);
+    bitmap_bitwise_raise1(bitmap_b, BITMAP_SIZE10007);
+    uint32_t seed = 1;
+    size_t ibit;
+    for(ibit = 0; ibit < BITMAP_SIZE10007; ++ibit)
+    {
+        seed = seed * 1103515245 + 12345;
+        if((seed >> 16) & 1) bitmap_bit_clear2(bitmap_a, ibit);
+        if((seed >> 17) & 3) bitmap_bit_clear2(bitmap_b, ibit);
+    }
+
+    size_t sizes[] = { 0, 1, 64, 67, 1021, 4096, 4099, 8191, BITMAP_SIZE10007 };
+
+    size_t i;
+    for(i = 0; i < ARRAY_SIZE(simds); ++i)
+    {
+        bitmap_simd_select1(simds[i]);
+        CHECK( bitmap_version0()->popcount != NULL );
+
+        size_t isize;
+        for(isize = 0; isize < ARRAY_SIZE(sizes); ++isize)
+        {
+            size_t size = sizes[isize];
+            size_t sizeB = sizes[ARRAY_SIZE(sizes) - 1 - isize];
+
+            size_t power_a = 0;
+            for(ibit = 0; ibit < size; ++ibit)
+            {
+                power_a += bitmap_bit_get2(bitmap_a, ibit);
+            }
+            CHECK( bitmap_bitwise_power2(bitmap_a, size) == power_a );
+
+            size_t power_isect = 0;
+            size_t power_union = 0;
+            for(ibit = 0; ibit < (size > sizeB ? size : sizeB); ++ibit)
+            {
+                bool a = (ibit < size && bitmap_bit_get2(bitmap_a, ibit));
+                bool b = (ibit < sizeB && bitmap_bit_get2(bitmap_b, ibit));
+                power_isect += (a && b);
+                power_union += (a || b);
+            }
+            size_t power_intersection;
+            size_t power_union6;
+            bitmap_bitwise_power6(bitmap_a, size, bitmap_b, sizeB, &power_intersection, &power_union6);
+            CHECK( power_intersection == power_isect );
+            CHECK( power_union6 == power_union );
+        }
+    }
+
+    bitmap_simd_select1(BITMAP_SIMD__AUTO);
+#undef BITMAP_SIZE10007
+}
+
+TEST_CASE(
+        "bitmaps bitmap_bitwise_operation_power test",
+        "[bitmap][bitmap_bitwise_operation_power]"
+)
+{
+#define BITMAP_SIZE_BIG (64 * 1024 * 2 + 77)
+    static const enum bitmap_simd simds[] =
+    {
+            BITMAP_SIMD__SCALAR,
+            BITMAP_SIMD__AVX2,
+            BITMAP_SIMD__AUTO,
+    };
+    static const enum bitmap_operation operations[] =
+    {
+            BITMAP_OPERATION__AND,
+            BITMAP_OPERATION__OR,
+            BITMAP_OPERATION__CLEAR,
+            BITMAP_OPERATION__XOR,
+    };
+    static BITMAP_VAR(bitmap_a, BITMAP_SIZE_BIG);
+    static BITMAP_VAR(bitmap_b, BITMAP_SIZE_BIG);
+
+    /* pseudo-random content, trashed tails */
+    bitmap_bitwise_raise1(bitmap_a, BITMAP_SIZE_BIG);
+    bitmap_bitwise_raise1(bitmap_b, BITMAP_SIZE_BIG);
+    uint32_t seed = 7;
+    size_t ibit;
+    for(ibit = 0; ibit < BITMAP_SIZE_BIG; ++ibit)
+    {
+        seed = seed * 1103515245 + 12345;
+        if((seed >> 16) & 1) bitmap_bit_clear2(bitmap_a, ibit);
+        if((seed >> 17) & 3) bitmap_bit_clear2(bitmap_b, ibit);
+    }
+
+    static const size_t sizes[][2] =
+    {
+            { 0, 0 },
+            { 0, 67 },
+            { 67, 0 },
+            { 67, 133 },
+            { 133, 67 },
+            { 128, 64 },
+            { 64, 128 },
+            { BITMAP_SIZE_BIG, 1021 },
+            { 1021, BITMAP_SIZE_BIG },
+            { BITMAP_SIZE_BIG, BITMAP_SIZE_BIG },
+    };
+
+    size_t isimd;
+    for(isimd = 0; isimd < ARRAY_SIZE(simds); ++isimd)
+    {
+        bitmap_simd_select1(simds[isimd]);
+
+        size_t isize;
+        for(isize = 0; isize < ARRAY_SIZE(sizes); ++isize)
+        {
+            size_t sizeA = sizes[isize][0];
+            size_t sizeB = sizes[isize][1];
+
+            size_t iop;
+            for(iop = 0; iop < ARRAY_SIZE(operations); ++iop)
+            {
+                enum bitmap_operation operation = operations[iop];
+                size_t power = 0;
+                for(ibit = 0; ibit < (sizeA > sizeB ? sizeA : sizeB); ++ibit)
+                {
+                    bool a = (ibit < sizeA && bitmap_bit_get2(bitmap_a, ibit));
+                    bool b = (ibit < sizeB && bitmap_bit_get2(bitmap_b, ibit));
+                    switch(operation)
+                    {
+                        case BITMAP_OPERATION__AND  : power += (a && b); break;
+                        case BITMAP_OPERATION__OR   : power += (a || b); break;
+                        case BITMAP_OPERATION__CLEAR: power += (a && !b); break;
+                        case BITMAP_OPERATION__XOR  : power += (a != b); break;
+                    }
+                }
+
+                CHECK( bitmap_bitwise_operation_power6(operation, bitmap_a, sizeA, bitmap_b, sizeB, SIZE_MAX) == power );
+                /* threshold early-exit */
+                CHECK( bitmap_bitwise_operation_power6(operation, bitmap_a, sizeA, bitmap_b, sizeB, power) >= power );
+                CHECK( bitmap_bitwise_operation_power6(operation, bitmap_a, sizeA, bitmap_b, sizeB, power + 1) == power );
+                if(power > 0)
+                {
+                    size_t limited = bitmap_bitwise_operation_power6(operation, bitmap_a, sizeA, bitmap_b, sizeB, power / 2);
+                    CHECK( limited >= power / 2 );
+                    CHECK( limited <= power );
+                }
+            }
+
+            size_t power_intersection;
+            size_t power_union;
+            bitmap_bitwise_power6(bitmap_a, sizeA, bitmap_b, sizeB, &power_intersection, &power_union);
+            CHECK( bitmap_bitwise_and_power4(bitmap_a, sizeA, bitmap_b, sizeB) == power_intersection );
+            CHECK( bitmap_bitwise_or_power4(bitmap_a, sizeA, bitmap_b, sizeB) == power_union );
+            CHECK( bitmap_bitwise_clear_power4(bitmap_a, sizeA, bitmap_b, sizeB) + power_intersection == bitmap_bitwise_power2(bitmap_a, sizeA) );
+            CHECK( bitmap_bitwise_xor_power4(bitmap_a, sizeA, bitmap_b, sizeB) + power_intersection == power_union );
+        }
+    }
+
+    bitmap_simd_select1(BITMAP_SIMD__AUTO);
+#undef BITMAP_SIZE_BIG
+}
+
+TEST_CASE(
+        "bitmaps bitmap_to_indices test",
+        "[bitmap][bitmap_to_indices]"
+)
+{
+#define BITMAP_SIZE_BIG (64 * 64 + 61)
+    static const enum bitmap_simd simds[] =
+    {
+            BITMAP_SIMD__SCALAR,
+            BITMAP_SIMD__SSE2,
+            BITMAP_SIMD__AVX2,
+            BITMAP_SIMD__AUTO,
+    };
+    static const size_t chunks[] = { 1, 7, 64, 65, 1000, BITMAP_SIZE_BIG };
+    static BITMAP_VAR(bitmap_big, BITMAP_SIZE_BIG);
+    static size_t expected[BITMAP_SIZE_BIG];
+    static size_t indices[BITMAP_SIZE_BIG];
+    static uint32_t indices32[BITMAP_SIZE_BIG];
+
+    /* sparse and dense blocks, zero blocks, trashed tail */
+    bitmap_bitwise_raise1(bitmap_big, BITMAP_SIZE_BIG);
+    uint32_t seed = 7;
+    size_t ibit;
+    for(ibit = 0; ibit < BITMAP_SIZE_BIG; ++ibit)
+    {
+        seed = seed * 1103515245 + 12345;
+        size_t iblock = ibit / BITMAP_BITS_IN_BLOCK();
+        bool raised = (iblock % 4 == 0) ? ((seed >> 16) % 8 != 0) : (iblock % 4 == 1) ? ((seed >> 16) % 16 == 0) : false;
+        if(!raised) bitmap_bit_clear2(bitmap_big, ibit);
+    }
+    bitmap_bit_raise2(bitmap_big, BITMAP_SIZE_BIG - 1);
+
+    static const size_t froms[] = { 0, 3, 64, 1000, BITMAP_SIZE_BIG - 1, BITMAP_SIZE_BIG };
+
+    size_t isimd;
+    for(isimd = 0; isimd < ARRAY_SIZE(simds); ++isimd)
+    {
+        bitmap_simd_select1(simds[isimd]);
+
+        size_t ifrom;
+        for(ifrom = 0; ifrom < ARRAY_SIZE(froms); ++ifrom)
+        {
+            size_t expected_num = 0;
+            bitmap_iterator_t iterator;
+            bitmap_iterator_init4(&iterator, bitmap_big, BITMAP_SIZE_BIG, froms[ifrom]);
+            while(bitmap_iterator_next2(&iterator, &expected[expected_num]))
+            {
+                ++expected_num;
+            }
+
+            size_t ichunk;
+            for(ichunk = 0; ichunk < ARRAY_SIZE(chunks); ++ichunk)
+            {
+                size_t indices_num = 0;
+                size_t bit_index_from = froms[ifrom];
+                while(bit_index_from < BITMAP_SIZE_BIG)
+                {
+                    size_t written = bitmap_to_indices5(
+                            &indices[indices_num],
+                            chunks[ichunk] < BITMAP_SIZE_BIG - indices_num ? chunks[ichunk] : BITMAP_SIZE_BIG - indices_num,
+                            bitmap_big,
+                            BITMAP_SIZE_BIG,
+                            &bit_index_from
+                    );
+                    indices_num += written;
+                    REQUIRE( (written > 0 || bit_index_from == BITMAP_SIZE_BIG) );
+                }
+                CHECK( bit_index_from == BITMAP_SIZE_BIG );
+                REQUIRE( indices_num == expected_num );
+                CHECK( memcmp(indices, expected, expected_num * sizeof(size_t)) == 0 );
+
+                size_t indices32_num = 0;
+                bit_index_from = froms[ifrom];
+                while(bit_index_from < BITMAP_SIZE_BIG)
+                {
+                    size_t written = bitmap_to_indices32_5(
+                            &indices32[indices32_num],
+                            chunks[ichunk] < BITMAP_SIZE_BIG - indices32_num ? chunks[ichunk] : BITMAP_SIZE_BIG - indices32_num,
+                            bitmap_big,
+                            BITMAP_SIZE_BIG,
+                            &bit_index_from
+                    );
+                    indices32_num += written;
+                    REQUIRE( (written > 0 || bit_index_from == BITMAP_SIZE_BIG) );
+                }
+                REQUIRE( indices32_num == expected_num );
+                size_t i;
+                for(i = 0; i < expected_num; ++i)
+                {
+                    CHECK( indices32[i] == expected[i] );
+                }
+            }
+        }
+
+        /* the empty array: the first raised bit is reported */
+        size_t bit_index_from = 65;
+        CHECK( bitmap_to_indices5(indices, 0, bitmap_big, BITMAP_SIZE_BIG, &bit_index_from) == 0 );
+        bitmap_bit_nearest_get_context_t nearest;
+        bitmap_bit_nearest_forward_raised_get4(bitmap_big, BITMAP_SIZE_BIG, 65, &nearest);
+        CHECK( bit_index_from == nearest.index );
+    }
+
+    bitmap_simd_select1(BITMAP_SIMD__AUTO);
+#undef BITMAP_SIZE_BIG
+}
+
 TEST_CASE(
         "bitmaps bitmap_sscanf_append_ranged test",
         "[bitmap][bitmap_sscanf_append_ranged]"
@@ -1301,3 +2131,104 @@ TEST_CASE(
         CHECK( memcmp(bitmap67, pattern67, sizeof(pattern67) ) == 0 );
     }
 }
+
+TEST_CASE(
+        "bitmaps bitmap_parse_append_ranged test",
+        "[bitmap][bitmap_parse_append_ranged]"
+)
+{
+#define BITMAP_SIZE_BIG (64 * 1024 + 13)
+    static const enum bitmap_simd simds[] =
+    {
+            BITMAP_SIMD__SCALAR,
+            BITMAP_SIMD__SSE2,
+            BITMAP_SIMD__AVX2,
+            BITMAP_SIMD__AVX512,
+    };
+    static BITMAP_VAR(bitmap, BITMAP_SIZE_BIG);
+    static BITMAP_VAR(pattern, BITMAP_SIZE_BIG);
+    static char str[BITMAP_SIZE_BIG * 8];
+    size_t error_offset;
+
+    /* the runs of each length, printed with the spaces */
+    P_prepare_fill_0_trashed(pattern, BITMAP_SIZE_BIG);
+    size_t run = 1;
+    size_t ibit;
+    for(ibit = 5; ibit < BITMAP_SIZE_BIG; ibit += run + 3, run = run % 100 + 1)
+    {
+        size_t end = (ibit + run - 1 < BITMAP_SIZE_BIG) ? (ibit + run - 1) : (BITMAP_SIZE_BIG - 1);
+        size_t i;
+        for(i = ibit; i <= end; ++i)
+        {
+            bitmap_bit_raise2(pattern, i);
+        }
+    }
+    REQUIRE( bitmap_snprintf_ranged6(str, sizeof(str), pattern, BITMAP_SIZE_BIG, " ,\t", " - ") == 0 );
+    size_t len = strlen(str);
+
+    size_t isimd;
+    for(isimd = 0; isimd < ARRAY_SIZE(simds); ++isimd)
+    {
+        bitmap_simd_select1(simds[isimd]);
+
+        P_prepare_fill_0_trashed(bitmap, BITMAP_SIZE_BIG);
+        CHECK( bitmap_parse_append_ranged7(bitmap, BITMAP_SIZE_BIG, ',', '-', str, len, &error_offset) == 0 );
+        CHECK( bitmap_bitwise_check_equal3(bitmap, pattern, BITMAP_SIZE_BIG) );
+
+        /* the same result as of the old parser */
+        P_prepare_fill_0_trashed(bitmap, BITMAP_SIZE_BIG);
+        CHECK( bitmap_sscanf_append_ranged5(bitmap, BITMAP_SIZE_BIG, ',', '-', str) == 0 );
+        CHECK( bitmap_bitwise_check_equal3(bitmap, pattern, BITMAP_SIZE_BIG) );
+
+        /* the long numbers, the chars after the size are not read */
+        static const char * leading_zeros = "000000000000000000000000000000000000000000000000000000000000000000067, 3";
+        P_prepare_fill_0_trashed(bitmap, BITMAP_SIZE_BIG);
+        CHECK( bitmap_parse_append_ranged7(bitmap, BITMAP_SIZE_BIG, ',', '-', leading_zeros, strlen(leading_zeros) - 3, NULL) == 0 );
+        CHECK( bitmap_bitwise_power2(bitmap, BITMAP_SIZE_BIG) == 1 );
+        CHECK( bitmap_bit_get2(bitmap, 67) );
+        P_prepare_fill_0_trashed(bitmap, BITMAP_SIZE_BIG);
+        CHECK( bitmap_parse_append_ranged7(bitmap, BITMAP_SIZE_BIG, ',', '-', "123", 2, NULL) == 0 );
+        CHECK( bitmap_bitwise_power2(bitmap, BITMAP_SIZE_BIG) == 1 );
+        CHECK( bitmap_bit_get2(bitmap, 12) );
+    }
+    bitmap_simd_select1(BITMAP_SIMD__AUTO);
+
+    static const struct
+    {
+        const char * src;
+        int res;
+        size_t error_offset;
+    } cases[] =
+    {
+            { ""                               ,  0, 0  },
+            { " \t\n"                          ,  0, 0  },
+            { "1, 2,"                          ,  0, 0  },
+            { "x123"                           , -1, 0  },
+            { "1x"                             , -1, 1  },
+            { " 1 2"                           , -1, 3  },
+            { "1,,2"                           , -1, 2  },
+            { "1 - "                           , -1, 4  },
+            { "1 - 3 - 5"                      , -1, 6  },
+            { "5 - 3"                          , -1, 4  },
+            { "0, 65536, 65549"                , -1, 10 },
+            { "99999999999999999999999999"     , -1, 0  },
+            { "1, 200000000000000000000"       , -1, 3  },
+            { "-1"                             , -1, 0  },
+            { "1,\xff"                         , -1, 2  },
+    };
+    size_t icase;
+    for(icase = 0; icase < ARRAY_SIZE(cases); ++icase)
+    {
+        error_offset = SIZE_MAX;
+        CHECK( bitmap_parse_append_ranged7(bitmap, BITMAP_SIZE_BIG, ',', '-', cases[icase].src, strlen(cases[icase].src), &error_offset) == cases[icase].res );
+        if(cases[icase].res != 0)
+        {
+            CHECK( error_offset == cases[icase].error_offset );
+        }
+    }
+
+    CHECK( bitmap_parse_append_ranged7(bitmap, 0, ',', '-', "0", 1, NULL) == -1 );
+    CHECK( bitmap_parse_append_ranged7(bitmap, 0, ',', '-', "", 0, NULL) == 0 );
+
+#undef BITMAP_SIZE_BIG
+}
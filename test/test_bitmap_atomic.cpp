@@ -0,0 +1,140 @@
+/**
+ * @file test_bitmap_atomic.cpp
+ *
+ */
+
+#include <bitmap/bitmap.h>
+#include <bitmap/bitmap_atomic.h>
+
+#include <catch/catch.hpp>
+
+#include <thread>
+#include <vector>
+
+#define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
+
+#define BITMAP_SIZE_BIG (64 * 100 + 13)
+#define THREADS_NUM 8
+
+/**
+ * @brief Raise all bits, count the bits cleared before
+ */
+static void P_thread_raise(
+        bitmap_block_t * bitmap,
+        size_t bits_num,
+        size_t * won
+)
+{
+    size_t ibit;
+    for(ibit = 0; ibit < bits_num; ++ibit)
+    {
+        if(!bitmap_atomic_bit_test_and_raise3(bitmap, ibit, BITMAP_MEMORY_ORDER__ACQ_REL))
+        {
+            ++(*won);
+        }
+    }
+}
+
+/**
+ * @brief Clear own bits: each bit of the thread is the ith bit modulo threads_num
+ */
+static void P_thread_clear(
+        bitmap_block_t * bitmap,
+        size_t bits_num,
+        size_t ithread
+)
+{
+    size_t ibit;
+    for(ibit = ithread; ibit < bits_num; ibit += THREADS_NUM)
+    {
+        bitmap_atomic_bit_clear3(bitmap, ibit, BITMAP_MEMORY_ORDER__RELAXED);
+    }
+}
+
+TEST_CASE(
+        "bitmaps bitmap_atomic test",
+        "[bitmap][bitmap_atomic]"
+)
+{
+    static BITMAP_VAR(bitmap, BITMAP_SIZE_BIG);
+    static BITMAP_VAR(src, BITMAP_SIZE_BIG);
+    static BITMAP_VAR(reference, BITMAP_SIZE_BIG);
+
+    /* single thread: the same as the plain operations */
+    bitmap_bitwise_clear2(bitmap, BITMAP_SIZE_BIG);
+    CHECK( bitmap_atomic_bit_test_and_raise3(bitmap, 70, BITMAP_MEMORY_ORDER__SEQ_CST) == false );
+    CHECK( bitmap_atomic_bit_test_and_raise3(bitmap, 70, BITMAP_MEMORY_ORDER__SEQ_CST) == true );
+    CHECK( bitmap_atomic_bit_get3(bitmap, 70, BITMAP_MEMORY_ORDER__RELAXED) == true );
+    CHECK( bitmap_atomic_bit_get3(bitmap, 71, BITMAP_MEMORY_ORDER__ACQUIRE) == false );
+    CHECK( bitmap_bit_get2(bitmap, 70) == true );
+    CHECK( bitmap_atomic_bit_test_and_clear3(bitmap, 70, BITMAP_MEMORY_ORDER__SEQ_CST) == true );
+    CHECK( bitmap_atomic_bit_test_and_clear3(bitmap, 70, BITMAP_MEMORY_ORDER__SEQ_CST) == false );
+    CHECK( bitmap_bitwise_check_zero2(bitmap, BITMAP_SIZE_BIG) );
+
+    bitmap_atomic_bit_raise3(bitmap, BITMAP_SIZE_BIG - 1, BITMAP_MEMORY_ORDER__RELEASE);
+    CHECK( bitmap_bit_get2(bitmap, BITMAP_SIZE_BIG - 1) == true );
+    bitmap_atomic_bit_clear3(bitmap, BITMAP_SIZE_BIG - 1, BITMAP_MEMORY_ORDER__RELEASE);
+    CHECK( bitmap_bit_get2(bitmap, BITMAP_SIZE_BIG - 1) == false );
+
+    CHECK( bitmap_atomic_block_or4(bitmap, 1, 0xF0, BITMAP_MEMORY_ORDER__ACQ_REL) == 0 );
+    CHECK( bitmap_atomic_block_clear4(bitmap, 1, 0x30, BITMAP_MEMORY_ORDER__ACQ_REL) == 0xF0 );
+    CHECK( bitmap_atomic_block_get3(bitmap, 1, BITMAP_MEMORY_ORDER__ACQUIRE) == 0xC0 );
+
+    bitmap_block_t expected = 0xFF;
+    CHECK( bitmap_atomic_block_compare_exchange5(bitmap, 1, &expected, 0x01, BITMAP_MEMORY_ORDER__ACQ_REL) == false );
+    CHECK( expected == 0xC0 );
+    CHECK( bitmap_atomic_block_compare_exchange5(bitmap, 1, &expected, 0x01, BITMAP_MEMORY_ORDER__ACQ_REL) == true );
+    CHECK( bitmap_atomic_block_get3(bitmap, 1, BITMAP_MEMORY_ORDER__RELAXED) == 0x01 );
+
+    /* bulk operations, the tail is not changed */
+    size_t ibit;
+    bitmap_bitwise_clear2(bitmap, BITMAP_SIZE_BIG);
+    bitmap_bitwise_raise1(src, BITMAP_SIZE_BIG);
+    for(ibit = 0; ibit < BITMAP_SIZE_BIG; ibit += 3)
+    {
+        bitmap_bit_clear2(src, ibit);
+    }
+    bitmap_bitwise_copy3(reference, src, BITMAP_SIZE_BIG);
+    bitmap_atomic_bitwise_or4(bitmap, src, BITMAP_SIZE_BIG - 5, BITMAP_MEMORY_ORDER__RELEASE);
+    CHECK( bitmap_bitwise_check_equal3(bitmap, reference, BITMAP_SIZE_BIG - 5) );
+    CHECK( bitmap_bitwise_power2(bitmap, BITMAP_SIZE_BIG) == bitmap_bitwise_power2(reference, BITMAP_SIZE_BIG - 5) );
+    bitmap_atomic_bitwise_clear4(bitmap, src, BITMAP_SIZE_BIG, BITMAP_MEMORY_ORDER__RELEASE);
+    CHECK( bitmap_bitwise_check_zero2(bitmap, BITMAP_SIZE_BIG) );
+
+    /* concurrent test-and-raise: each bit is won by exactly one thread */
+    std::vector<std::thread> threads;
+    size_t won[THREADS_NUM] = {};
+    size_t ithread;
+
+    bitmap_bitwise_clear2(bitmap, BITMAP_SIZE_BIG);
+    for(ithread = 0; ithread < THREADS_NUM; ++ithread)
+    {
+        threads.push_back(std::thread(P_thread_raise, bitmap, (size_t)BITMAP_SIZE_BIG, &won[ithread]));
+    }
+    for(ithread = 0; ithread < THREADS_NUM; ++ithread)
+    {
+        threads[ithread].join();
+    }
+    threads.clear();
+    size_t won_total = 0;
+    for(ithread = 0; ithread < ARRAY_SIZE(won); ++ithread)
+    {
+        won_total += won[ithread];
+    }
+    CHECK( won_total == BITMAP_SIZE_BIG );
+    CHECK( bitmap_bitwise_power2(bitmap, BITMAP_SIZE_BIG) == BITMAP_SIZE_BIG );
+
+    /* concurrent clear of the bits in the shared blocks */
+    for(ithread = 0; ithread < THREADS_NUM; ++ithread)
+    {
+        threads.push_back(std::thread(P_thread_clear, bitmap, (size_t)BITMAP_SIZE_BIG, ithread));
+    }
+    for(ithread = 0; ithread < THREADS_NUM; ++ithread)
+    {
+        threads[ithread].join();
+    }
+    CHECK( bitmap_bitwise_check_zero2(bitmap, BITMAP_SIZE_BIG) );
+}
+
+#undef THREADS_NUM
+#undef BITMAP_SIZE_BIG
@@ -0,0 +1,169 @@
+/**
+ * @file test_bitmap_dynamic.cpp
+ *
+ */
+
+#include <bitmap/bitmap.h>
+#include <bitmap/bitmap_dynamic.h>
+#include <bitmap/bitmap_dynamic.hpp>
+
+#include <catch/catch.hpp>
+
+#include <stdint.h>
+#include <utility>
+
+#define BITMAP_SIZE_BIG (64 * 1000 + 13)
+
+static bool P_aligned(const bitmap_block_t * blocks)
+{
+    return (uintptr_t)blocks % BITMAP_DYNAMIC_ALIGNMENT == 0;
+}
+
+TEST_CASE(
+        "bitmaps bitmap_dynamic test",
+        "[bitmap][bitmap_dynamic]"
+)
+{
+    bitmap_dynamic_t d;
+    size_t ibit;
+
+    REQUIRE( bitmap_dynamic_create2(&d, 0) == 0 );
+    CHECK( bitmap_dynamic_blocks1(&d) == NULL );
+    CHECK( bitmap_dynamic_bits_num1(&d) == 0 );
+    CHECK( bitmap_dynamic_capacity1(&d) == 0 );
+
+    REQUIRE( bitmap_dynamic_resize2(&d, 67) == 0 );
+    CHECK( P_aligned(bitmap_dynamic_blocks1(&d)) );
+    CHECK( bitmap_dynamic_bits_num1(&d) == 67 );
+    CHECK( bitmap_dynamic_capacity1(&d) == BITMAP_DYNAMIC_ALIGNMENT * BITMAP_BITS_IN_BYTE() );
+    CHECK( bitmap_bitwise_check_zero2(bitmap_dynamic_blocks1(&d), 67) );
+
+    /* the tail bits are raised, the grown bits are cleared */
+    bitmap_bitwise_raise1(bitmap_dynamic_blocks1(&d), 67);
+    REQUIRE( bitmap_dynamic_resize2(&d, 70) == 0 );
+    CHECK( bitmap_bitwise_power2(bitmap_dynamic_blocks1(&d), 70) == 67 );
+    REQUIRE( bitmap_dynamic_resize2(&d, 10) == 0 );
+    REQUIRE( bitmap_dynamic_resize2(&d, 200) == 0 );
+    CHECK( bitmap_bitwise_power2(bitmap_dynamic_blocks1(&d), 200) == 10 );
+
+    /* the amortized growth, the bits are kept */
+    size_t reallocs_num = 0;
+    for(ibit = 200; ibit < BITMAP_SIZE_BIG; ++ibit)
+    {
+        const bitmap_block_t * blocks = bitmap_dynamic_blocks1(&d);
+        REQUIRE( bitmap_dynamic_resize2(&d, ibit + 1) == 0 );
+        if(bitmap_dynamic_blocks1(&d) != blocks)
+        {
+            ++reallocs_num;
+            CHECK( P_aligned(bitmap_dynamic_blocks1(&d)) );
+        }
+        CHECK( !bitmap_bit_get2(bitmap_dynamic_blocks1(&d), ibit) );
+        if(ibit % 3 == 0)
+        {
+            bitmap_bit_raise2(bitmap_dynamic_blocks1(&d), ibit);
+        }
+    }
+    CHECK( reallocs_num <= 10 );
+    CHECK( bitmap_dynamic_capacity1(&d) >= BITMAP_SIZE_BIG );
+    CHECK( bitmap_bitwise_power2(bitmap_dynamic_blocks1(&d), BITMAP_SIZE_BIG) == 10 + (BITMAP_SIZE_BIG - 200 + 1) / 3 );
+
+    /* the shrink clears the bits after the size */
+    REQUIRE( bitmap_dynamic_resize2(&d, 300) == 0 );
+    size_t power = bitmap_bitwise_power2(bitmap_dynamic_blocks1(&d), 300);
+    REQUIRE( bitmap_dynamic_shrink_to_fit1(&d) == 0 );
+    CHECK( P_aligned(bitmap_dynamic_blocks1(&d)) );
+    CHECK( bitmap_dynamic_capacity1(&d) == BITMAP_DYNAMIC_ALIGNMENT * BITMAP_BITS_IN_BYTE() );
+    CHECK( bitmap_bitwise_power2(bitmap_dynamic_blocks1(&d), 300) == power );
+    REQUIRE( bitmap_dynamic_resize2(&d, 512) == 0 );
+    CHECK( bitmap_bitwise_power2(bitmap_dynamic_blocks1(&d), 512) == power );
+
+    /* the reserve does not change the bits */
+    REQUIRE( bitmap_dynamic_reserve2(&d, BITMAP_SIZE_BIG) == 0 );
+    CHECK( bitmap_dynamic_bits_num1(&d) == 512 );
+    CHECK( bitmap_dynamic_capacity1(&d) >= BITMAP_SIZE_BIG );
+    CHECK( bitmap_bitwise_power2(bitmap_dynamic_blocks1(&d), 512) == power );
+    const bitmap_block_t * reserved = bitmap_dynamic_blocks1(&d);
+    REQUIRE( bitmap_dynamic_resize2(&d, BITMAP_SIZE_BIG) == 0 );
+    CHECK( bitmap_dynamic_blocks1(&d) == reserved );
+
+    REQUIRE( bitmap_dynamic_resize2(&d, 0) == 0 );
+    REQUIRE( bitmap_dynamic_shrink_to_fit1(&d) == 0 );
+    CHECK( bitmap_dynamic_blocks1(&d) == NULL );
+    bitmap_dynamic_destroy1(&d);
+    CHECK( bitmap_dynamic_bits_num1(&d) == 0 );
+
+    /* C++: the small bitmap is inline */
+    bitmap::dynamic a(200);
+    CHECK( a.is_inline() );
+    CHECK( a.bits_num() == 200 );
+    CHECK( a.check_zero() );
+    for(ibit = 0; ibit < 200; ibit += 3)
+    {
+        a.bit_raise(ibit);
+    }
+    CHECK( a.power() == 67 );
+    a.bit_clear(0);
+    CHECK( !a.bit_get(0) );
+    CHECK( a.power() == 66 );
+
+    /* the tail bits are raised, the grown bits are cleared */
+    bitmap::dynamic t(67);
+    bitmap_bitwise_raise1(t.data(), 67);
+    t.resize(100);
+    CHECK( t.is_inline() );
+    CHECK( t.power() == 67 );
+
+    /* the big bitmap is on the heap, the bits are kept */
+    a.resize(BITMAP_SIZE_BIG);
+    CHECK( !a.is_inline() );
+    CHECK( P_aligned(a.data()) );
+    CHECK( a.power() == 66 );
+    a.bit_raise(BITMAP_SIZE_BIG - 1);
+
+    bitmap::dynamic b(a);
+    CHECK( b == a );
+    CHECK( !b.is_inline() );
+    CHECK( b.data() != a.data() );
+
+    const bitmap_block_t * blocks = a.data();
+    bitmap::dynamic c(std::move(a));
+    CHECK( c.data() == blocks );
+    CHECK( c == b );
+    CHECK( a.bits_num() == 0 );
+    CHECK( a.is_inline() );
+
+    /* the shrink moves the small bitmap into the object */
+    c.resize(150);
+    CHECK( !c.is_inline() );
+    c.shrink_to_fit();
+    CHECK( c.is_inline() );
+    CHECK( c.bits_num() == 150 );
+    CHECK( c.power() == 49 );
+    c.resize(200);
+    CHECK( c.power() == 49 );
+    CHECK( c != b );
+
+    /* the copy and the move of the inline bitmap */
+    a = c;
+    CHECK( a.is_inline() );
+    CHECK( a == c );
+    b = std::move(c);
+    CHECK( b.is_inline() );
+    CHECK( b == a );
+    CHECK( c.bits_num() == 0 );
+    CHECK( c.check_zero() );
+    c.resize(64);
+    CHECK( c.check_zero() );
+
+    /* the sizes are different */
+    a.resize(201);
+    CHECK( a != b );
+    a.clear();
+    CHECK( a.check_zero() );
+    a.reserve(BITMAP_SIZE_BIG);
+    CHECK( !a.is_inline() );
+    CHECK( a.capacity() >= BITMAP_SIZE_BIG );
+    CHECK( a.bits_num() == 201 );
+}
+
+#undef BITMAP_SIZE_BIG
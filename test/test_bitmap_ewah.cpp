@@ -0,0 +1,161 @@
+/**
+ * @file test_bitmap_ewah.cpp
+ *
+ */
+
+#include <bitmap/bitmap.h>
+#include <bitmap/bitmap_ewah.h>
+
+#include <catch/catch.hpp>
+
+#include <string.h>
+
+#define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
+
+#define BITMAP_SIZE_BIG (64 * 1000 + 13)
+
+/**
+ * @brief Clustered bitmap: long runs of the cleared and raised blocks, sparse literals, trashed tail
+ */
+static void P_prepare_clustered(
+        bitmap_block_t * bitmap,
+        size_t bits_num,
+        uint32_t seed
+)
+{
+    bitmap_bitwise_raise1(bitmap, bits_num);
+    size_t ibit;
+    bool raised = false;
+    for(ibit = 0; ibit < bits_num; ++ibit)
+    {
+        seed = seed * 1103515245 + 12345;
+        uint32_t random = seed >> 16;
+        if(random % 3000 == 0)
+        {
+            raised = !raised;
+        }
+        if(!(raised || random % 500 == 0))
+        {
+            bitmap_bit_clear2(bitmap, ibit);
+        }
+    }
+}
+
+static void P_check_decoded(
+        const bitmap_ewah_t * ewah,
+        const bitmap_block_t * reference,
+        size_t bits_num
+)
+{
+    static BITMAP_VAR(decoded, BITMAP_SIZE_BIG);
+    REQUIRE( bitmap_ewah_bits_num1(ewah) == bits_num );
+    bitmap_ewah_decode2(decoded, ewah);
+    CHECK( bitmap_bitwise_check_equal3(decoded, reference, bits_num) );
+    CHECK( bitmap_ewah_power1(ewah) == bitmap_bitwise_power2(reference, bits_num) );
+}
+
+TEST_CASE(
+        "bitmaps bitmap_ewah test",
+        "[bitmap][bitmap_ewah]"
+)
+{
+    static const enum bitmap_operation operations[] =
+    {
+            BITMAP_OPERATION__AND,
+            BITMAP_OPERATION__OR,
+            BITMAP_OPERATION__CLEAR,
+            BITMAP_OPERATION__XOR,
+    };
+    static const size_t sizes[][2] =
+    {
+            { 0, 0 },
+            { 67, 0 },
+            { 0, 67 },
+            { 1021, 4099 },
+            { BITMAP_SIZE_BIG, BITMAP_SIZE_BIG },
+            { BITMAP_SIZE_BIG, 40000 },
+            { 40000, BITMAP_SIZE_BIG },
+    };
+    static BITMAP_VAR(bitmap_a, BITMAP_SIZE_BIG);
+    static BITMAP_VAR(bitmap_b, BITMAP_SIZE_BIG);
+    static BITMAP_VAR(reference, BITMAP_SIZE_BIG);
+
+    P_prepare_clustered(bitmap_a, BITMAP_SIZE_BIG, 7);
+    P_prepare_clustered(bitmap_b, BITMAP_SIZE_BIG, 11);
+
+    bitmap_ewah_t a;
+    bitmap_ewah_t b;
+    bitmap_ewah_t result;
+    bitmap_ewah_init1(&a);
+    bitmap_ewah_init1(&b);
+    bitmap_ewah_init1(&result);
+
+    size_t isize;
+    for(isize = 0; isize < ARRAY_SIZE(sizes); ++isize)
+    {
+        size_t sizeA = sizes[isize][0];
+        size_t sizeB = sizes[isize][1];
+        size_t size = (sizeA > sizeB) ? sizeA : sizeB;
+
+        REQUIRE( bitmap_ewah_encode3(&a, bitmap_a, sizeA) == 0 );
+        REQUIRE( bitmap_ewah_encode3(&b, bitmap_b, sizeB) == 0 );
+        P_check_decoded(&a, bitmap_a, sizeA);
+        P_check_decoded(&b, bitmap_b, sizeB);
+
+        size_t iop;
+        for(iop = 0; iop < ARRAY_SIZE(operations); ++iop)
+        {
+            enum bitmap_operation operation = operations[iop];
+            size_t ibit;
+            for(ibit = 0; ibit < size; ++ibit)
+            {
+                bool bit_a = (ibit < sizeA && bitmap_bit_get2(bitmap_a, ibit));
+                bool bit_b = (ibit < sizeB && bitmap_bit_get2(bitmap_b, ibit));
+                bool bit = false;
+                switch(operation)
+                {
+                    case BITMAP_OPERATION__AND  : bit = (bit_a && bit_b); break;
+                    case BITMAP_OPERATION__OR   : bit = (bit_a || bit_b); break;
+                    case BITMAP_OPERATION__CLEAR: bit = (bit_a && !bit_b); break;
+                    case BITMAP_OPERATION__XOR  : bit = (bit_a != bit_b); break;
+                }
+                if(bit) bitmap_bit_raise2(reference, ibit);
+                else bitmap_bit_clear2(reference, ibit);
+            }
+
+            REQUIRE( bitmap_ewah_operation4(&result, operation, &a, &b) == 0 );
+            P_check_decoded(&result, reference, size);
+            CHECK( bitmap_ewah_operation_power3(operation, &a, &b) == bitmap_bitwise_power2(reference, size) );
+        }
+
+        CHECK( bitmap_ewah_and3(&result, &a, &b) == 0 );
+        CHECK( bitmap_ewah_power1(&result) == bitmap_bitwise_and_power4(bitmap_a, sizeA, bitmap_b, sizeB) );
+        CHECK( bitmap_ewah_or3(&result, &a, &b) == 0 );
+        CHECK( bitmap_ewah_power1(&result) == bitmap_bitwise_or_power4(bitmap_a, sizeA, bitmap_b, sizeB) );
+        CHECK( bitmap_ewah_clear3(&result, &a, &b) == 0 );
+        CHECK( bitmap_ewah_power1(&result) == bitmap_bitwise_clear_power4(bitmap_a, sizeA, bitmap_b, sizeB) );
+        CHECK( bitmap_ewah_xor3(&result, &a, &b) == 0 );
+        CHECK( bitmap_ewah_power1(&result) == bitmap_bitwise_xor_power4(bitmap_a, sizeA, bitmap_b, sizeB) );
+
+        /* the destination is the operand */
+        CHECK( bitmap_ewah_or3(&a, &a, &b) == 0 );
+        CHECK( bitmap_ewah_power1(&a) == bitmap_bitwise_or_power4(bitmap_a, sizeA, bitmap_b, sizeB) );
+    }
+
+    /* the clustered bitmap is compressed */
+    REQUIRE( bitmap_ewah_encode3(&a, bitmap_a, BITMAP_SIZE_BIG) == 0 );
+    CHECK( bitmap_ewah_blocks_num1(&a) < BITMAP_BITS_TO_BLOCKS_ALIGNED(BITMAP_SIZE_BIG) );
+
+    /* runs of the clean blocks only */
+    static BITMAP_VAR(clean, BITMAP_SIZE_BIG);
+    bitmap_bitwise_clear2(clean, BITMAP_SIZE_BIG);
+    struct bitmap_range range = { 640, 64 * 900 - 1 };
+    bitmap_bitwise_range_raise2(clean, &range);
+    REQUIRE( bitmap_ewah_encode3(&b, clean, BITMAP_SIZE_BIG) == 0 );
+    CHECK( bitmap_ewah_blocks_num1(&b) == 3 );
+    P_check_decoded(&b, clean, BITMAP_SIZE_BIG);
+
+    bitmap_ewah_destroy1(&a);
+    bitmap_ewah_destroy1(&b);
+    bitmap_ewah_destroy1(&result);
+}
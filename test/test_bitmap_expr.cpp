@@ -0,0 +1,92 @@
+/**
+ * @file test_bitmap_expr.cpp
+ *
+ */
+
+#include <bitmap/bitmap.h>
+#include <bitmap/bitmap_expr.hpp>
+
+#include <catch/catch.hpp>
+
+#define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
+
+#define BITMAP_SIZE_BIG (64 * 100 + 13)
+
+TEST_CASE(
+        "bitmaps bitmap_expr test",
+        "[bitmap][bitmap_expr]"
+)
+{
+    using namespace bitmap::expr;
+
+    static const size_t sizes[] = { 0, 1, 64, 67, 64 * 8, 64 * 8 + 1, 64 * 17 + 5, BITMAP_SIZE_BIG };
+    static BITMAP_VAR(a, BITMAP_SIZE_BIG);
+    static BITMAP_VAR(b, BITMAP_SIZE_BIG);
+    static BITMAP_VAR(c, BITMAP_SIZE_BIG);
+    static BITMAP_VAR(d, BITMAP_SIZE_BIG);
+    static BITMAP_VAR(dest, BITMAP_SIZE_BIG);
+    static BITMAP_VAR(expected, BITMAP_SIZE_BIG);
+    static BITMAP_VAR(tmp, BITMAP_SIZE_BIG);
+
+    bitmap_bitwise_clear2(a, BITMAP_SIZE_BIG);
+    bitmap_bitwise_clear2(b, BITMAP_SIZE_BIG);
+    bitmap_bitwise_clear2(c, BITMAP_SIZE_BIG);
+    bitmap_bitwise_clear2(d, BITMAP_SIZE_BIG);
+    size_t ibit;
+    for(ibit = 0; ibit < BITMAP_SIZE_BIG; ++ibit)
+    {
+        if(ibit % 2 == 0)
+        {
+            bitmap_bit_raise2(a, ibit);
+        }
+        if(ibit % 3 == 0)
+        {
+            bitmap_bit_raise2(b, ibit);
+        }
+        if(ibit % 5 == 0)
+        {
+            bitmap_bit_raise2(c, ibit);
+        }
+        if(ibit % 7 == 0)
+        {
+            bitmap_bit_raise2(d, ibit);
+        }
+    }
+
+    size_t isize;
+    for(isize = 0; isize < ARRAY_SIZE(sizes); ++isize)
+    {
+        size_t bits_num = sizes[isize];
+
+        /* (a & b) | (c & ~d) by the calls and the temporary */
+        bitmap_bitwise_and4(expected, a, b, bits_num);
+        bitmap_bitwise_clear4(tmp, c, d, bits_num);
+        bitmap_bitwise_or3(expected, tmp, bits_num);
+
+        bitmap_bitwise_raise1(dest, BITMAP_SIZE_BIG);
+        assign(dest, bits_num, (wrap(a) & wrap(b)) | (wrap(c) & ~wrap(d)));
+        CHECK( bitmap_bitwise_check_equal3(dest, expected, bits_num) );
+        CHECK( power(bits_num, (wrap(a) & wrap(b)) | (wrap(c) & ~wrap(d))) == bitmap_bitwise_power2(expected, bits_num) );
+        CHECK( check_zero(bits_num, wrap(c) & ~wrap(c)) );
+        CHECK( check_zero(bits_num, wrap(a) & wrap(b)) == (bits_num == 0) );
+        CHECK( check_zero(bits_num, wrap(dest) ^ wrap(expected)) );
+
+        /* the destination is the source */
+        bitmap_bitwise_copy3(dest, a, bits_num);
+        assign(dest, bits_num, ~(wrap(dest) | wrap(b)));
+        bitmap_bitwise_or4(tmp, a, b, bits_num);
+        bitmap_bitwise_not3(expected, tmp, bits_num);
+        CHECK( bitmap_bitwise_check_equal3(dest, expected, bits_num) );
+    }
+
+    /* the fixed bitmaps */
+    bitmap::fixed<512> fa { 1, 2, 3, 300, 511 };
+    bitmap::fixed<512> fb { 2, 3, 4, 511 };
+    bitmap::fixed<512> fc { 100, 300 };
+    bitmap::fixed<512> fdest;
+    assign(fdest, (wrap(fa) & wrap(fb)) | (wrap(fc) & ~wrap(fb)));
+    CHECK( fdest == (bitmap::fixed<512>{ 2, 3, 100, 300, 511 }) );
+    CHECK( power(512, wrap(fa) ^ wrap(fb)) == 3 );
+}
+
+#undef BITMAP_SIZE_BIG
@@ -0,0 +1,135 @@
+/**
+ * @file test_bitmap_file.cpp
+ *
+ */
+
+#include <bitmap/bitmap.h>
+#include <bitmap/bitmap_file.h>
+
+#include <catch/catch.hpp>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
+
+#define BITMAP_SIZE_BIG (64 * 1000 + 13)
+
+TEST_CASE(
+        "bitmaps bitmap_file test",
+        "[bitmap][bitmap_file]"
+)
+{
+    static const enum bitmap_simd simds[] =
+    {
+            BITMAP_SIMD__SCALAR,
+            BITMAP_SIMD__SSE2,
+            BITMAP_SIMD__AVX2,
+            BITMAP_SIMD__AVX512,
+    };
+    static uint8_t data[1000];
+    size_t i;
+    for(i = 0; i < ARRAY_SIZE(data); ++i)
+    {
+        data[i] = (uint8_t)(i * 7 + i / 13);
+    }
+
+    /* CRC32C by each kernel: the check value, the continuation */
+    uint32_t crc_data = 0;
+    size_t isimd;
+    for(isimd = 0; isimd < ARRAY_SIZE(simds); ++isimd)
+    {
+        bitmap_simd_select1(simds[isimd]);
+        CHECK( bitmap_crc32c3(0, "123456789", 9) == 0xE3069283 );
+        CHECK( bitmap_crc32c3(0, "", 0) == 0 );
+        uint32_t crc = bitmap_crc32c3(0, data, ARRAY_SIZE(data));
+        if(isimd == 0)
+        {
+            crc_data = crc;
+        }
+        CHECK( crc == crc_data );
+        CHECK( bitmap_crc32c3(bitmap_crc32c3(0, data, 333), &data[333], ARRAY_SIZE(data) - 333) == crc_data );
+        CHECK( bitmap_crc32c3(0, &data[1], 13) == bitmap_crc32c3(bitmap_crc32c3(0, &data[1], 5), &data[6], 8) );
+    }
+    bitmap_simd_select1(BITMAP_SIMD__AUTO);
+
+    char path[] = "/tmp/test_bitmap_file.XXXXXX";
+    int fd = mkstemp(path);
+    REQUIRE( fd >= 0 );
+    close(fd);
+
+    /* create, fill, close */
+    static BITMAP_VAR(reference, BITMAP_SIZE_BIG);
+    bitmap_bitwise_clear2(reference, BITMAP_SIZE_BIG);
+    for(i = 0; i < BITMAP_SIZE_BIG; i += 17)
+    {
+        bitmap_bit_raise2(reference, i);
+    }
+
+    bitmap_file_t file;
+    REQUIRE( bitmap_file_create3(&file, path, BITMAP_SIZE_BIG) == 0 );
+    CHECK( bitmap_file_bits_num1(&file) == BITMAP_SIZE_BIG );
+    CHECK( ((uintptr_t)bitmap_file_bitmap1(&file) % 64) == 0 );
+    CHECK( bitmap_bitwise_check_zero2(bitmap_file_bitmap1(&file), BITMAP_SIZE_BIG) );
+    bitmap_bitwise_copy3(bitmap_file_bitmap1(&file), reference, BITMAP_SIZE_BIG);
+    CHECK( bitmap_file_close1(&file) == 0 );
+
+    /* the mapped bitmap is used as is */
+    REQUIRE( bitmap_file_open3(&file, path, BITMAP_FILE_MODE__READ) == 0 );
+    CHECK( bitmap_file_bits_num1(&file) == BITMAP_SIZE_BIG );
+    CHECK( bitmap_file_check_crc1(&file) );
+    CHECK( bitmap_bitwise_check_equal3(bitmap_file_bitmap1(&file), reference, BITMAP_SIZE_BIG) );
+    CHECK( bitmap_bitwise_power2(bitmap_file_bitmap1(&file), BITMAP_SIZE_BIG) == bitmap_bitwise_power2(reference, BITMAP_SIZE_BIG) );
+    CHECK( bitmap_file_close1(&file) == 0 );
+
+    /* the changes of the writable mapping */
+    REQUIRE( bitmap_file_open3(&file, path, BITMAP_FILE_MODE__WRITE) == 0 );
+    bitmap_bit_raise2(bitmap_file_bitmap1(&file), 1);
+    bitmap_bit_raise2(reference, 1);
+    CHECK( bitmap_file_check_crc1(&file) == false );
+    CHECK( bitmap_file_sync1(&file) == 0 );
+    CHECK( bitmap_file_check_crc1(&file) );
+    CHECK( bitmap_file_close1(&file) == 0 );
+    REQUIRE( bitmap_file_open3(&file, path, BITMAP_FILE_MODE__READ) == 0 );
+    CHECK( bitmap_bitwise_check_equal3(bitmap_file_bitmap1(&file), reference, BITMAP_SIZE_BIG) );
+    CHECK( bitmap_file_close1(&file) == 0 );
+
+    /* the damaged block */
+    fd = open(path, O_RDWR);
+    REQUIRE( fd >= 0 );
+    uint8_t byte = 0xFF;
+    CHECK( pwrite(fd, &byte, 1, sizeof(struct bitmap_file_header) + 100) == 1 );
+    REQUIRE( bitmap_file_open3(&file, path, BITMAP_FILE_MODE__READ) == 0 );
+    CHECK( bitmap_file_check_crc1(&file) == false );
+    CHECK( bitmap_file_close1(&file) == 0 );
+
+    /* the wrong header and size */
+    uint32_t block_size = 3;
+    CHECK( pwrite(fd, &block_size, sizeof(block_size), offsetof(struct bitmap_file_header, block_size)) == sizeof(block_size) );
+    errno = 0;
+    CHECK( bitmap_file_open3(&file, path, BITMAP_FILE_MODE__READ) == -1 );
+    CHECK( errno == EINVAL );
+    CHECK( ftruncate(fd, 10) == 0 );
+    errno = 0;
+    CHECK( bitmap_file_open3(&file, path, BITMAP_FILE_MODE__READ) == -1 );
+    CHECK( errno == EINVAL );
+    close(fd);
+
+    /* the empty bitmap */
+    REQUIRE( bitmap_file_create3(&file, path, 0) == 0 );
+    CHECK( bitmap_file_close1(&file) == 0 );
+    REQUIRE( bitmap_file_open3(&file, path, BITMAP_FILE_MODE__READ) == 0 );
+    CHECK( bitmap_file_bits_num1(&file) == 0 );
+    CHECK( bitmap_file_check_crc1(&file) );
+    CHECK( bitmap_file_close1(&file) == 0 );
+
+    unlink(path);
+    errno = 0;
+    CHECK( bitmap_file_open3(&file, path, BITMAP_FILE_MODE__READ) == -1 );
+    CHECK( errno == ENOENT );
+}
+
+#undef BITMAP_SIZE_BIG
@@ -0,0 +1,107 @@
+/**
+ * @file test_bitmap_fixed.cpp
+ *
+ */
+
+#include <bitmap/bitmap.h>
+#include <bitmap/bitmap_fixed.hpp>
+
+#include <catch/catch.hpp>
+
+#include <vector>
+
+/* the masks are built by the compiler */
+static constexpr bitmap::fixed<256> P_mask256 { 0, 5, 64, 255 };
+static_assert(P_mask256.bit_get(5), "the raised bit");
+static_assert(!P_mask256.bit_get(6), "the cleared bit");
+static_assert(P_mask256.power() == 4, "the power");
+static_assert((P_mask256 | bitmap::fixed<256>{ 6 }).power() == 5, "the union");
+static_assert((~P_mask256).power() == 256 - 4, "the negation");
+static_assert(bitmap::fixed<67>::blocks_num == 2 && bitmap::fixed<67>::tail_mask == 0x7, "the tail");
+
+/**
+ * @brief Compare the template with the bitmap_*() functions
+ */
+template<size_t N>
+static void P_fixed_test()
+{
+    bitmap::fixed<N> a;
+    bitmap::fixed<N> b;
+    size_t ibit;
+
+    CHECK( a.check_zero() );
+    CHECK( bitmap_bitwise_check_zero2(a.data(), N) );
+    for(ibit = 0; ibit < N; ibit += 3)
+    {
+        a.bit_raise(ibit);
+    }
+    for(ibit = 0; ibit < N; ibit += 5)
+    {
+        b.bit_raise(ibit);
+    }
+    CHECK( a.power() == bitmap_bitwise_power2(a.data(), N) );
+    CHECK( a.power() == (N + 2) / 3 );
+    CHECK( !a.check_zero() );
+
+    /* the operations and the same operations of the library */
+    static BITMAP_VAR(expected, N);
+    bitmap::fixed<N> c = a | b;
+    bitmap_bitwise_or4(expected, a.data(), b.data(), N);
+    CHECK( bitmap_bitwise_check_equal3(c.data(), expected, N) );
+    c = a & b;
+    bitmap_bitwise_and4(expected, a.data(), b.data(), N);
+    CHECK( bitmap_bitwise_check_equal3(c.data(), expected, N) );
+    CHECK( c.power() == (N + 14) / 15 );
+    c = a;
+    c.bitwise_clear(b);
+    bitmap_bitwise_clear4(expected, a.data(), b.data(), N);
+    CHECK( bitmap_bitwise_check_equal3(c.data(), expected, N) );
+    c = a ^ b;
+    CHECK( c.power() == a.power() + b.power() - 2 * (a & b).power() );
+    c = ~a;
+    CHECK( c.power() == N - a.power() );
+    CHECK( (c & a).check_zero() );
+
+    /* the tail bits are not significant */
+    c = a;
+    c.data()[c.blocks_num - 1] |= ~c.tail_mask;
+    CHECK( c == a );
+    CHECK( c.power() == a.power() );
+    CHECK( (a | b).check_inclusion(a) );
+    CHECK( a.check_inclusion(a & b) );
+    c.raise();
+    CHECK( c.power() == N );
+    c.bit_clear(N - 1);
+    CHECK( c.power() == N - 1 );
+    CHECK( !c.bit_get(N - 1) );
+    c.clear();
+    CHECK( c.check_zero() );
+    CHECK( c != a );
+
+    std::vector<size_t> indices;
+    a.foreach_bit([&indices](size_t index) { indices.push_back(index); });
+    REQUIRE( indices.size() == a.power() );
+    for(ibit = 0; ibit < indices.size(); ++ibit)
+    {
+        CHECK( indices[ibit] == ibit * 3 );
+    }
+}
+
+TEST_CASE(
+        "bitmaps bitmap_fixed test",
+        "[bitmap][bitmap_fixed]"
+)
+{
+    P_fixed_test<1>();
+    P_fixed_test<63>();
+    P_fixed_test<64>();
+    P_fixed_test<67>();
+    P_fixed_test<256>();
+    P_fixed_test<512>();
+    P_fixed_test<4099>();
+    P_fixed_test<8192>();
+
+    CHECK( P_mask256.bit_get(255) );
+    CHECK( bitmap_bitwise_power2(P_mask256.data(), 256) == 4 );
+    CHECK_THROWS_AS( bitmap::fixed<67>({ 1, 67 }), std::out_of_range );
+}
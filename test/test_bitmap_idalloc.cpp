@@ -0,0 +1,145 @@
+/**
+ * @file test_bitmap_idalloc.cpp
+ *
+ */
+
+#include <bitmap/bitmap.h>
+#include <bitmap/bitmap_idalloc.h>
+
+#include <catch/catch.hpp>
+
+#include <thread>
+#include <vector>
+
+#define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
+
+#define IDS_NUM (64 * 200 + 13)
+/* the summary of 3 levels */
+#define IDS_NUM_BIG (64 * 64 * 64 + 5)
+#define THREADS_NUM 8
+
+/**
+ * @brief Allocate and free the IDs, then allocate own share of IDs and keep them
+ */
+static void P_thread_alloc(
+        bitmap_idalloc_t * alloc,
+        size_t ithread,
+        std::vector<size_t> * ids
+)
+{
+    size_t hint = ithread * IDS_NUM / THREADS_NUM;
+    size_t id;
+    size_t i;
+    for(i = 0; i < 10000; ++i)
+    {
+        if(bitmap_idalloc_alloc3(alloc, &hint, &id) == 0)
+        {
+            bitmap_idalloc_free2(alloc, id);
+        }
+    }
+    while(bitmap_idalloc_alloc3(alloc, &hint, &id) == 0)
+    {
+        ids->push_back(id);
+    }
+}
+
+TEST_CASE(
+        "bitmaps bitmap_idalloc test",
+        "[bitmap][bitmap_idalloc]"
+)
+{
+    static const size_t sizes[] = { 0, 1, 63, 64, 65, 4096, 4097, IDS_NUM, IDS_NUM_BIG };
+    static BITMAP_VAR(allocated, IDS_NUM_BIG);
+
+    bitmap_idalloc_t alloc;
+    size_t isize;
+    for(isize = 0; isize < ARRAY_SIZE(sizes); ++isize)
+    {
+        size_t ids_num = sizes[isize];
+        REQUIRE( bitmap_idalloc_create2(&alloc, ids_num) == 0 );
+        CHECK( bitmap_idalloc_ids_num1(&alloc) == ids_num );
+
+        /* all IDs once, from the different hints */
+        bitmap_bitwise_clear2(allocated, IDS_NUM_BIG);
+        size_t hint = ids_num / 2 + 1;
+        size_t id;
+        size_t i;
+        for(i = 0; i < ids_num; ++i)
+        {
+            REQUIRE( bitmap_idalloc_alloc3(&alloc, &hint, &id) == 0 );
+            REQUIRE( id < ids_num );
+            CHECK( bitmap_bit_get2(allocated, id) == false );
+            CHECK( bitmap_idalloc_check2(&alloc, id) == true );
+            bitmap_bit_raise2(allocated, id);
+            if(i % 7 == 0)
+            {
+                hint = (i * 31) % (ids_num + 10);
+            }
+        }
+        CHECK( bitmap_idalloc_alloc3(&alloc, &hint, &id) == -1 );
+
+        /* the freed ID of the full region is found */
+        if(ids_num > 0)
+        {
+            size_t freed = ids_num * 2 / 3;
+            bitmap_idalloc_free2(&alloc, freed);
+            CHECK( bitmap_idalloc_check2(&alloc, freed) == false );
+            hint = 0;
+            REQUIRE( bitmap_idalloc_alloc3(&alloc, &hint, &id) == 0 );
+            CHECK( id == freed );
+            CHECK( bitmap_idalloc_alloc3(&alloc, &hint, &id) == -1 );
+
+            /* the scattered free IDs of the full allocator are found in order, from the hint to the end */
+            size_t step = ids_num / 5 + 1;
+            for(i = 0; i < ids_num; i += step)
+            {
+                bitmap_idalloc_free2(&alloc, i);
+            }
+            hint = 0;
+            for(i = 0; i < ids_num; i += step)
+            {
+                REQUIRE( bitmap_idalloc_alloc3(&alloc, &hint, &id) == 0 );
+                CHECK( id == i );
+            }
+            CHECK( bitmap_idalloc_alloc3(&alloc, &hint, &id) == -1 );
+        }
+
+        bitmap_idalloc_destroy1(&alloc);
+    }
+
+    /* concurrent: each ID is allocated by exactly one thread */
+    REQUIRE( bitmap_idalloc_create2(&alloc, IDS_NUM) == 0 );
+    std::vector<std::thread> threads;
+    std::vector<size_t> ids[THREADS_NUM];
+    size_t ithread;
+    for(ithread = 0; ithread < THREADS_NUM; ++ithread)
+    {
+        threads.push_back(std::thread(P_thread_alloc, &alloc, ithread, &ids[ithread]));
+    }
+    for(ithread = 0; ithread < THREADS_NUM; ++ithread)
+    {
+        threads[ithread].join();
+    }
+
+    bitmap_bitwise_clear2(allocated, IDS_NUM);
+    size_t total = 0;
+    bool unique = true;
+    for(ithread = 0; ithread < THREADS_NUM; ++ithread)
+    {
+        size_t i;
+        for(i = 0; i < ids[ithread].size(); ++i)
+        {
+            size_t id = ids[ithread][i];
+            unique = unique && id < IDS_NUM && !bitmap_bit_get2(allocated, id);
+            bitmap_bit_raise2(allocated, id);
+        }
+        total += ids[ithread].size();
+    }
+    CHECK( unique );
+    CHECK( total == IDS_NUM );
+    bitmap_idalloc_destroy1(&alloc);
+}
+
+#undef THREADS_NUM
+#undef IDS_NUM_BIG
+#undef IDS_NUM
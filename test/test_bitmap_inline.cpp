@@ -0,0 +1,94 @@
+/**
+ * @file test_bitmap_inline.cpp
+ *
+ */
+
+#include <bitmap/bitmap.h>
+#include <bitmap/bitmap_inline.h>
+
+#include <catch/catch.hpp>
+
+#define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
+
+#define BITMAP_SIZE_MAX (64 * 4 + 13)
+
+TEST_CASE(
+        "bitmaps bitmap_inline test",
+        "[bitmap][bitmap_inline]"
+)
+{
+    static const size_t sizes[] = { 0, 1, 63, 64, 67, 64 * 4, BITMAP_SIZE_MAX };
+    static BITMAP_VAR(a, BITMAP_SIZE_MAX);
+    static BITMAP_VAR(b, BITMAP_SIZE_MAX);
+    static BITMAP_VAR(dest, BITMAP_SIZE_MAX);
+    static BITMAP_VAR(expected, BITMAP_SIZE_MAX);
+
+    CHECK( bitmap_inline_tailblock_mask1(1) == 0x1 );
+    CHECK( bitmap_inline_tailblock_mask1(67) == 0x7 );
+    CHECK( bitmap_inline_tailblock_mask1(BITMAP_BITS_IN_BLOCK()) == ~(bitmap_block_t)0 );
+
+    size_t isize;
+    for(isize = 0; isize < ARRAY_SIZE(sizes); ++isize)
+    {
+        size_t bits_num = sizes[isize];
+        size_t ibit;
+
+        /* the tail bits are trashed */
+        bitmap_bitwise_raise1(a, BITMAP_SIZE_MAX);
+        bitmap_bitwise_raise1(b, BITMAP_SIZE_MAX);
+        bitmap_inline_bitwise_clear2(a, bits_num);
+        bitmap_inline_bitwise_clear2(b, bits_num);
+        CHECK( bitmap_inline_bitwise_check_zero2(a, bits_num) );
+        CHECK( bitmap_inline_bitwise_power2(a, bits_num) == 0 );
+        for(ibit = 0; ibit < bits_num; ++ibit)
+        {
+            if(ibit % 3 == 0)
+            {
+                bitmap_inline_bit_raise2(a, ibit);
+            }
+            if(ibit % 5 == 0)
+            {
+                bitmap_bit_raise2(b, ibit);
+            }
+        }
+        for(ibit = 0; ibit < bits_num; ++ibit)
+        {
+            CHECK( bitmap_inline_bit_get2(a, ibit) == bitmap_bit_get2(a, ibit) );
+            CHECK( bitmap_inline_bit_get2(a, ibit) == (ibit % 3 == 0) );
+        }
+        CHECK( bitmap_inline_bitwise_power2(a, bits_num) == bitmap_bitwise_power2(a, bits_num) );
+        CHECK( bitmap_inline_bitwise_power2(a, bits_num) == (bits_num + 2) / 3 );
+        CHECK( bitmap_inline_bitwise_check_zero2(a, bits_num) == bitmap_bitwise_check_zero2(a, bits_num) );
+
+        bitmap_inline_bitwise_copy3(dest, a, bits_num);
+        CHECK( bitmap_inline_bitwise_check_equal3(dest, a, bits_num) );
+        CHECK( bitmap_bitwise_check_equal3(dest, a, bits_num) );
+
+        bitmap_inline_bitwise_or3(dest, b, bits_num);
+        bitmap_bitwise_or4(expected, a, b, bits_num);
+        CHECK( bitmap_inline_bitwise_check_equal3(dest, expected, bits_num) );
+        CHECK( bitmap_bitwise_check_equal3(dest, expected, bits_num) );
+
+        bitmap_inline_bitwise_copy3(dest, a, bits_num);
+        bitmap_inline_bitwise_and3(dest, b, bits_num);
+        bitmap_bitwise_and4(expected, a, b, bits_num);
+        CHECK( bitmap_inline_bitwise_check_equal3(dest, expected, bits_num) );
+        CHECK( bitmap_inline_bitwise_power2(dest, bits_num) == (bits_num + 14) / 15 );
+
+        bitmap_inline_bitwise_copy3(dest, a, bits_num);
+        bitmap_inline_bitwise_clear3(dest, b, bits_num);
+        bitmap_bitwise_clear4(expected, a, b, bits_num);
+        CHECK( bitmap_inline_bitwise_check_equal3(dest, expected, bits_num) );
+        CHECK( bitmap_inline_bitwise_check_equal3(dest, a, bits_num) == bitmap_bitwise_check_equal3(dest, a, bits_num) );
+
+        if(bits_num > 0)
+        {
+            bitmap_inline_bit_clear2(a, 0);
+            CHECK( !bitmap_bit_get2(a, 0) );
+            CHECK( bitmap_inline_bitwise_power2(a, bits_num) == (bits_num + 2) / 3 - 1 );
+            CHECK( !bitmap_inline_bitwise_check_equal3(dest, b, bits_num) );
+        }
+    }
+}
+
+#undef BITMAP_SIZE_MAX
@@ -0,0 +1,189 @@
+/**
+ * @file test_bitmap_kernel.cpp
+ *
+ */
+
+#include <bitmap/bitmap.h>
+#include <bitmap/bitmap_kernel.h>
+
+#include <catch/catch.hpp>
+
+#include <string.h>
+
+#include <string>
+
+#define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
+
+#define BITMAP_SIZE_BIG (64 * 100 + 13)
+
+TEST_CASE(
+        "bitmaps bitmap_kernel test",
+        "[bitmap][bitmap_kernel]"
+)
+{
+    static BITMAP_VAR(bitmap, BITMAP_SIZE_BIG);
+    static BITMAP_VAR(result, BITMAP_SIZE_BIG);
+    static char str[BITMAP_SIZE_BIG * 8];
+    size_t error_offset;
+    size_t ibit;
+
+    /* cpulist: the pairs are the ranges too */
+    bitmap_bitwise_raise1(bitmap, 100);
+    bitmap_bitwise_clear2(bitmap, 100);
+    for(ibit = 0; ibit <= 3; ++ibit)
+    {
+        bitmap_bit_raise2(bitmap, ibit);
+    }
+    bitmap_bit_raise2(bitmap, 8);
+    bitmap_bit_raise2(bitmap, 10);
+    bitmap_bit_raise2(bitmap, 11);
+    for(ibit = 64; ibit < 100; ++ibit)
+    {
+        bitmap_bit_raise2(bitmap, ibit);
+    }
+    CHECK( bitmap_cpulist_format4(str, sizeof(str), bitmap, 100) == strlen("0-3,8,10-11,64-99") );
+    CHECK( std::string(str) == "0-3,8,10-11,64-99" );
+    CHECK( bitmap_cpulist_format4(str, 5, bitmap, 100) == strlen("0-3,8,10-11,64-99") );
+    CHECK( std::string(str) == "0-3," );
+    CHECK( bitmap_cpulist_format4(NULL, 0, bitmap, 100) == strlen("0-3,8,10-11,64-99") );
+
+    bitmap_bitwise_raise1(result, 100);
+    REQUIRE( bitmap_cpulist_parse5(result, 100, "0-3,8,10-11,64-N\n", strlen("0-3,8,10-11,64-N\n"), NULL) == 0 );
+    CHECK( bitmap_bitwise_check_equal3(result, bitmap, 100) );
+    REQUIRE( bitmap_cpulist_parse5(result, 100, " 10-11 , ,8\t0-3,64-99", strlen(" 10-11 , ,8\t0-3,64-99"), NULL) == 0 );
+    CHECK( bitmap_bitwise_check_equal3(result, bitmap, 100) );
+
+    /* the strides */
+    REQUIRE( bitmap_cpulist_parse5(result, 128, "0-63:2/8,100-N:1/10", strlen("0-63:2/8,100-N:1/10"), NULL) == 0 );
+    bitmap_cpulist_format4(str, sizeof(str), result, 128);
+    CHECK( std::string(str) == "0-1,8-9,16-17,24-25,32-33,40-41,48-49,56-57,100,110,120" );
+    REQUIRE( bitmap_cpulist_parse5(result, 128, "3-5:2/2,10-20:0/3,31-32:4/5", strlen("3-5:2/2,10-20:0/3,31-32:4/5"), NULL) == 0 );
+    bitmap_cpulist_format4(str, sizeof(str), result, 128);
+    CHECK( std::string(str) == "3-5,31-32" );
+
+    /* the input is not null-terminated */
+    REQUIRE( bitmap_cpulist_parse5(result, 128, "1,27", 3, NULL) == 0 );
+    bitmap_cpulist_format4(str, sizeof(str), result, 128);
+    CHECK( std::string(str) == "1-2" );
+    REQUIRE( bitmap_cpulist_parse5(result, 128, "", 0, NULL) == 0 );
+    CHECK( bitmap_bitwise_check_zero2(result, 128) );
+
+    static const struct
+    {
+        const char * src;
+        size_t error_offset;
+    } list_errors[] =
+    {
+            { "x"            , 0 },
+            { "1,2x"         , 2 },
+            { "1,5-3"        , 2 },
+            { "1-"           , 0 },
+            { "0-7:3/0"      , 0 },
+            { "0-7:5/4"      , 0 },
+            { "0-7:2"        , 0 },
+            { "4:1/2"        , 0 },
+            { "1,2,128"      , 4 },
+            { "0-128"        , 0 },
+            { "-1"           , 0 },
+    };
+    size_t icase;
+    for(icase = 0; icase < ARRAY_SIZE(list_errors); ++icase)
+    {
+        error_offset = SIZE_MAX;
+        CHECK( bitmap_cpulist_parse5(result, 128, list_errors[icase].src, strlen(list_errors[icase].src), &error_offset) == -1 );
+        CHECK( error_offset == list_errors[icase].error_offset );
+    }
+
+    /* cpumask: the highest chunk has the digits of its bits */
+    bitmap_bitwise_raise1(bitmap, 36);
+    CHECK( bitmap_cpumask_format4(str, sizeof(str), bitmap, 36) == strlen("f,ffffffff") );
+    CHECK( std::string(str) == "f,ffffffff" );
+    bitmap_bitwise_clear2(bitmap, 64);
+    for(ibit = 0; ibit < 32; ++ibit)
+    {
+        bitmap_bit_raise2(bitmap, ibit);
+    }
+    CHECK( bitmap_cpumask_format4(str, sizeof(str), bitmap, 64) == strlen("00000000,ffffffff") );
+    CHECK( std::string(str) == "00000000,ffffffff" );
+    bitmap_bitwise_clear2(bitmap, 8);
+    bitmap_bit_raise2(bitmap, 0);
+    bitmap_bit_raise2(bitmap, 5);
+    bitmap_bit_raise2(bitmap, 7);
+    CHECK( bitmap_cpumask_format4(str, sizeof(str), bitmap, 8) == 2 );
+    CHECK( std::string(str) == "a1" );
+    CHECK( bitmap_cpumask_format4(str, sizeof(str), bitmap, 0) == 0 );
+    CHECK( std::string(str) == "" );
+
+    bitmap_bitwise_clear2(bitmap, 72);
+    bitmap_bit_raise2(bitmap, 4);
+    bitmap_bit_raise2(bitmap, 39);
+    bitmap_bit_raise2(bitmap, 70);
+    CHECK( bitmap_cpumask_format4(str, sizeof(str), bitmap, 72) == strlen("40,00000080,00000010") );
+    CHECK( std::string(str) == "40,00000080,00000010" );
+    CHECK( bitmap_cpumask_format4(str, 4, bitmap, 72) == strlen("40,00000080,00000010") );
+    CHECK( std::string(str) == "40," );
+
+    bitmap_bitwise_raise1(result, 72);
+    REQUIRE( bitmap_cpumask_parse5(result, 72, "40,00000080,00000010\n", strlen("40,00000080,00000010\n"), NULL) == 0 );
+    CHECK( bitmap_bitwise_check_equal3(result, bitmap, 72) );
+    REQUIRE( bitmap_cpumask_parse5(result, 72, " 0,00000040,80,10", strlen(" 0,00000040,80,10"), NULL) == 0 );
+    CHECK( bitmap_bitwise_check_equal3(result, bitmap, 72) );
+    REQUIRE( bitmap_cpumask_parse5(result, 36, "F,FfFfFfFf", strlen("F,FfFfFfFf"), NULL) == 0 );
+    CHECK( bitmap_bitwise_power2(result, 36) == 36 );
+    REQUIRE( bitmap_cpumask_parse5(result, 36, "00000000,0000000f,ffffffff", strlen("00000000,0000000f,ffffffff"), NULL) == 0 );
+    CHECK( bitmap_bitwise_power2(result, 36) == 36 );
+    REQUIRE( bitmap_cpumask_parse5(result, 36, "ffff", 2, NULL) == 0 );
+    CHECK( bitmap_bitwise_power2(result, 36) == 8 );
+    REQUIRE( bitmap_cpumask_parse5(result, 36, "", 0, NULL) == 0 );
+    CHECK( bitmap_bitwise_check_zero2(result, 36) );
+
+    static const struct
+    {
+        const char * src;
+        size_t error_offset;
+    } mask_errors[] =
+    {
+            { "g"                       , 0 },
+            { "1,123456789"             , 2 },
+            { "0,,2"                    , 2 },
+            { "1,"                      , 2 },
+            { "1f,ffffffff"             , 0 },
+            { "1,00000000,ffffffff"     , 0 },
+            { "0,fffffff:"              , 2 },
+            { "ff ff"                   , 0 },
+    };
+    for(icase = 0; icase < ARRAY_SIZE(mask_errors); ++icase)
+    {
+        error_offset = SIZE_MAX;
+        CHECK( bitmap_cpumask_parse5(result, 36, mask_errors[icase].src, strlen(mask_errors[icase].src), &error_offset) == -1 );
+        CHECK( error_offset == mask_errors[icase].error_offset );
+    }
+
+    /* round trip of both formats, each size */
+    static const size_t sizes[] = { 1, 31, 32, 33, 63, 64, 65, 100, BITMAP_SIZE_BIG };
+    size_t isize;
+    for(isize = 0; isize < ARRAY_SIZE(sizes); ++isize)
+    {
+        size_t bits_num = sizes[isize];
+        bitmap_bitwise_raise1(bitmap, BITMAP_SIZE_BIG);
+        bitmap_bitwise_clear2(bitmap, bits_num);
+        for(ibit = 0; ibit < bits_num; ibit += (ibit % 7) + 1)
+        {
+            bitmap_bit_raise2(bitmap, ibit);
+        }
+        bitmap_bit_raise2(bitmap, bits_num - 1);
+
+        size_t len = bitmap_cpumask_format4(str, sizeof(str), bitmap, bits_num);
+        CHECK( len == strlen(str) );
+        CHECK( len == (bits_num + 3) / 4 + (bits_num - 1) / 32 );
+        REQUIRE( bitmap_cpumask_parse5(result, bits_num, str, len, NULL) == 0 );
+        CHECK( bitmap_bitwise_check_equal3(result, bitmap, bits_num) );
+
+        len = bitmap_cpulist_format4(str, sizeof(str), bitmap, bits_num);
+        CHECK( len == strlen(str) );
+        REQUIRE( bitmap_cpulist_parse5(result, bits_num, str, len, NULL) == 0 );
+        CHECK( bitmap_bitwise_check_equal3(result, bitmap, bits_num) );
+    }
+}
+
+#undef BITMAP_SIZE_BIG
@@ -0,0 +1,132 @@
+/**
+ * @file test_bitmap_layered.cpp
+ *
+ */
+
+#include <bitmap/bitmap.h>
+#include <bitmap/bitmap_layered.h>
+
+#include <catch/catch.hpp>
+
+#define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
+
+#define BITMAP_SIZE_BIG (64 * 64 * 64 + 64 * 3 + 7)
+
+/**
+ * @brief Compare the search with the plain bitmap search from each bit
+ */
+static void P_check_search(
+        const bitmap_layered_t * layered,
+        const bitmap_block_t * reference,
+        size_t bits_num
+)
+{
+    bool equal = true;
+    size_t from;
+    for(from = 0; from <= bits_num; from += (from < 300 || bits_num - from < 300) ? 1 : 97)
+    {
+        bitmap_bit_nearest_get_context_t expected;
+        bitmap_bit_nearest_get_context_t actual;
+
+        bitmap_bit_nearest_forward_raised_get4(reference, bits_num, from, &expected);
+        bitmap_layered_nearest_forward_raised_get3(layered, from, &actual);
+        equal = equal && expected.exist == actual.exist && (!expected.exist || expected.index == actual.index);
+
+        bitmap_bit_nearest_forward_cleared_get4(reference, bits_num, from, &expected);
+        bitmap_layered_nearest_forward_cleared_get3(layered, from, &actual);
+        equal = equal && expected.exist == actual.exist && (!expected.exist || expected.index == actual.index);
+    }
+    CHECK( equal );
+    CHECK( bitmap_bitwise_check_equal3(bitmap_layered_bitmap1(layered), reference, bits_num) );
+}
+
+TEST_CASE(
+        "bitmaps bitmap_layered test",
+        "[bitmap][bitmap_layered]"
+)
+{
+    static const size_t sizes[] = { 0, 1, 63, 64, 65, 4096, 4097, 64 * 64 * 64, BITMAP_SIZE_BIG };
+    static BITMAP_VAR(reference, BITMAP_SIZE_BIG);
+
+    bitmap_layered_t layered;
+    size_t isize;
+    for(isize = 0; isize < ARRAY_SIZE(sizes); ++isize)
+    {
+        size_t bits_num = sizes[isize];
+        REQUIRE( bitmap_layered_create2(&layered, bits_num) == 0 );
+        CHECK( bitmap_layered_bits_num1(&layered) == bits_num );
+        bitmap_bitwise_clear2(reference, bits_num);
+        P_check_search(&layered, reference, bits_num);
+
+        /* sparse bits */
+        size_t ibit;
+        for(ibit = 5; ibit < bits_num; ibit += 4999)
+        {
+            bitmap_layered_bit_raise2(&layered, ibit);
+            bitmap_bit_raise2(reference, ibit);
+        }
+        if(bits_num > 0)
+        {
+            bitmap_layered_bit_raise2(&layered, bits_num - 1);
+            bitmap_bit_raise2(reference, bits_num - 1);
+            CHECK( bitmap_layered_bit_get2(&layered, bits_num - 1) == true );
+        }
+        P_check_search(&layered, reference, bits_num);
+
+        /* full regions with the holes */
+        bitmap_bitwise_raise1(reference, bits_num);
+        bitmap_layered_assign2(&layered, reference);
+        P_check_search(&layered, reference, bits_num);
+        for(ibit = 3; ibit < bits_num; ibit += 7001)
+        {
+            bitmap_layered_bit_clear2(&layered, ibit);
+            bitmap_bit_clear2(reference, ibit);
+        }
+        P_check_search(&layered, reference, bits_num);
+
+        /* the holes are filled, the sparse bits are cleared */
+        for(ibit = 3; ibit < bits_num; ibit += 7001)
+        {
+            bitmap_layered_bit_raise2(&layered, ibit);
+            bitmap_bit_raise2(reference, ibit);
+        }
+        P_check_search(&layered, reference, bits_num);
+        bitmap_bitwise_clear2(reference, bits_num);
+        bitmap_layered_assign2(&layered, reference);
+        for(ibit = 0; ibit < bits_num; ibit += 1013)
+        {
+            bitmap_layered_bit_raise2(&layered, ibit);
+            bitmap_layered_bit_clear2(&layered, ibit);
+        }
+        P_check_search(&layered, reference, bits_num);
+
+        bitmap_layered_destroy1(&layered);
+    }
+
+    /* iterators */
+    REQUIRE( bitmap_layered_create2(&layered, BITMAP_SIZE_BIG) == 0 );
+    bitmap_layered_bit_raise2(&layered, 7);
+    bitmap_layered_bit_raise2(&layered, 100000);
+    bitmap_layered_bit_raise2(&layered, BITMAP_SIZE_BIG - 1);
+    static const size_t expected[] = { 7, 100000, BITMAP_SIZE_BIG - 1 };
+    bitmap_bit_nearest_get_context_t bit_nearest;
+    size_t bit_index;
+    size_t num = 0;
+    BITMAP_LAYERED_FOREACH_BIT_IN_BITMAP(&bit_index, &layered, &bit_nearest)
+    {
+        REQUIRE( num < ARRAY_SIZE(expected) );
+        CHECK( bit_index == expected[num] );
+        ++num;
+    }
+    CHECK( num == ARRAY_SIZE(expected) );
+
+    num = 0;
+    BITMAP_LAYERED_FOREACH_CLEARED_BIT_IN_BITMAP(&bit_index, &layered, &bit_nearest)
+    {
+        ++num;
+    }
+    CHECK( num == BITMAP_SIZE_BIG - ARRAY_SIZE(expected) );
+    bitmap_layered_destroy1(&layered);
+}
+
+#undef BITMAP_SIZE_BIG
@@ -0,0 +1,122 @@
+/**
+ * @file test_bitmap_parallel.cpp
+ *
+ */
+
+#include <bitmap/bitmap.h>
+#include <bitmap/bitmap_parallel.h>
+
+#include <catch/catch.hpp>
+
+#define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
+
+#define BITMAP_SIZE_BIG (64 * 10000 + 13)
+
+/**
+ * @brief The executor of the caller: runs the parts backward in the calling thread
+ */
+static void P_executor_backward_run(
+        void * ctx,
+        bitmap_parallel_task_t task,
+        void * arg,
+        size_t parts_num
+)
+{
+    ++(*(size_t *)ctx);
+    while(parts_num > 0)
+    {
+        --parts_num;
+        task(arg, parts_num);
+    }
+}
+
+static void P_prepare(
+        bitmap_block_t * bitmap,
+        size_t bits_num,
+        uint32_t seed
+)
+{
+    size_t ibit;
+    bitmap_bitwise_clear2(bitmap, bits_num);
+    for(ibit = 0; ibit < bits_num; ++ibit)
+    {
+        seed = seed * 1103515245 + 12345;
+        if((seed >> 16) % 3 == 0)
+        {
+            bitmap_bit_raise2(bitmap, ibit);
+        }
+    }
+}
+
+TEST_CASE(
+        "bitmaps bitmap_parallel test",
+        "[bitmap][bitmap_parallel]"
+)
+{
+    static const size_t sizes[] = { 0, 1, 64 * 8 - 1, 64 * 8 * 3 + 5, 64 * 1000, BITMAP_SIZE_BIG - 64 * 5 };
+    static BITMAP_VAR(a, BITMAP_SIZE_BIG);
+    static BITMAP_VAR(b, BITMAP_SIZE_BIG);
+    static BITMAP_VAR(result, BITMAP_SIZE_BIG);
+    static BITMAP_VAR(reference, BITMAP_SIZE_BIG);
+
+    P_prepare(a, BITMAP_SIZE_BIG, 3);
+    P_prepare(b, BITMAP_SIZE_BIG, 5);
+
+    size_t runs = 0;
+    bitmap_parallel_executor_t backward = { P_executor_backward_run, &runs, 7, 0 };
+    bitmap_parallel_executor_t pool;
+    REQUIRE( bitmap_parallel_pool_create2(&pool, 4) == 0 );
+    CHECK( pool.bits_min == BITMAP_PARALLEL_BITS_MIN );
+    pool.bits_min = 0;
+
+    const bitmap_parallel_executor_t * executors[] = { NULL, &backward, &pool };
+    size_t iexecutor;
+    for(iexecutor = 0; iexecutor < ARRAY_SIZE(executors); ++iexecutor)
+    {
+        const bitmap_parallel_executor_t * executor = executors[iexecutor];
+        size_t isize;
+        for(isize = 0; isize < ARRAY_SIZE(sizes); ++isize)
+        {
+            size_t bits_num = sizes[isize];
+            /* the destination is not aligned to the cache line */
+            size_t ioffset;
+            for(ioffset = 0; ioffset < 3; ++ioffset)
+            {
+                bitmap_block_t * dest = &result[ioffset];
+                const bitmap_block_t * srcA = &a[ioffset];
+                const bitmap_block_t * srcB = &b[ioffset * 2];
+
+                bitmap_bitwise_or4(reference, srcA, srcB, bits_num);
+                bitmap_parallel_bitwise_or5(executor, dest, srcA, srcB, bits_num);
+                CHECK( bitmap_bitwise_check_equal3(dest, reference, bits_num) );
+
+                bitmap_bitwise_and4(reference, srcA, srcB, bits_num);
+                bitmap_parallel_bitwise_and5(executor, dest, srcA, srcB, bits_num);
+                CHECK( bitmap_bitwise_check_equal3(dest, reference, bits_num) );
+
+                bitmap_bitwise_clear4(reference, srcA, srcB, bits_num);
+                bitmap_parallel_bitwise_clear5(executor, dest, srcA, srcB, bits_num);
+                CHECK( bitmap_bitwise_check_equal3(dest, reference, bits_num) );
+
+                bitmap_bitwise_not3(reference, srcA, bits_num);
+                bitmap_parallel_bitwise_not4(executor, dest, srcA, bits_num);
+                CHECK( bitmap_bitwise_check_equal3(dest, reference, bits_num) );
+
+                CHECK( bitmap_parallel_bitwise_power3(executor, srcA, bits_num) == bitmap_bitwise_power2(srcA, bits_num) );
+            }
+        }
+    }
+    CHECK( runs > 0 );
+
+    /* less than the threshold: the executor is not used */
+    runs = 0;
+    backward.bits_min = BITMAP_SIZE_BIG;
+    bitmap_parallel_bitwise_or5(&backward, result, a, b, BITMAP_SIZE_BIG - 1);
+    CHECK( runs == 0 );
+    bitmap_parallel_bitwise_or5(&backward, result, a, b, BITMAP_SIZE_BIG);
+    CHECK( runs == 1 );
+
+    bitmap_parallel_pool_destroy1(&pool);
+}
+
+#undef BITMAP_SIZE_BIG
@@ -0,0 +1,104 @@
+/**
+ * @file test_bitmap_rank.cpp
+ *
+ */
+
+#include <bitmap/bitmap.h>
+#include <bitmap/bitmap_rank.h>
+
+#include <catch/catch.hpp>
+
+#define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
+
+TEST_CASE(
+        "bitmaps bitmap_rank test",
+        "[bitmap][bitmap_rank]"
+)
+{
+#define BITMAP_SIZE_BIG (65536 * 3 + 77)
+    static const enum bitmap_simd simds[] =
+    {
+            BITMAP_SIMD__SCALAR,
+            BITMAP_SIMD__AVX2,
+            BITMAP_SIMD__AUTO,
+    };
+    static const size_t sizes[] = { 0, 1, 67, 512, 513, 65536, BITMAP_SIZE_BIG };
+    static BITMAP_VAR(bitmap, BITMAP_SIZE_BIG);
+    static size_t indexes[BITMAP_SIZE_BIG];
+
+    /* dense and sparse superblocks, the empty superblock, trashed tail */
+    bitmap_bitwise_raise1(bitmap, BITMAP_SIZE_BIG);
+    uint32_t seed = 7;
+    size_t ibit;
+    for(ibit = 0; ibit < BITMAP_SIZE_BIG; ++ibit)
+    {
+        seed = seed * 1103515245 + 12345;
+        size_t isuperblock = ibit / 65536;
+        bool raised =
+                (isuperblock == 0) ? ((seed >> 16) % 4 != 0) :
+                (isuperblock == 1) ? false :
+                ((seed >> 16) % 64 == 0);
+        if(!raised) bitmap_bit_clear2(bitmap, ibit);
+    }
+
+    size_t isimd;
+    for(isimd = 0; isimd < ARRAY_SIZE(simds); ++isimd)
+    {
+        bitmap_simd_select1(simds[isimd]);
+
+        size_t isize;
+        for(isize = 0; isize < ARRAY_SIZE(sizes); ++isize)
+        {
+            size_t bits_num = sizes[isize];
+            bitmap_rank_t rank;
+            REQUIRE( bitmap_rank_create3(&rank, bitmap, bits_num) == 0 );
+
+            size_t power = 0;
+            for(ibit = 0; ibit < bits_num; ++ibit)
+            {
+                if(ibit % 61 == 0 || ibit % 65536 < 3)
+                {
+                    REQUIRE( bitmap_rank_rank2(&rank, ibit) == power );
+                }
+                if(bitmap_bit_get2(bitmap, ibit))
+                {
+                    indexes[power++] = ibit;
+                }
+            }
+            CHECK( bitmap_rank_power1(&rank) == power );
+            CHECK( bitmap_rank_rank2(&rank, bits_num) == power );
+
+            size_t irank;
+            for(irank = 0; irank < power; ++irank)
+            {
+                size_t index = SIZE_MAX;
+                REQUIRE( bitmap_rank_select3(&rank, irank, &index) == 0 );
+                REQUIRE( index == indexes[irank] );
+            }
+            size_t index;
+            CHECK( bitmap_rank_select3(&rank, power, &index) == -1 );
+
+            bitmap_rank_destroy1(&rank);
+        }
+    }
+
+    /* the index follows the bitmap after the update */
+    {
+        static BITMAP_VAR(bitmap1021, 1021);
+        bitmap_bitwise_clear2(bitmap1021, 1021);
+        bitmap_rank_t rank;
+        REQUIRE( bitmap_rank_create3(&rank, bitmap1021, 1021) == 0 );
+        CHECK( bitmap_rank_power1(&rank) == 0 );
+
+        bitmap_bit_raise2(bitmap1021, 1000);
+        bitmap_rank_update1(&rank);
+        size_t index;
+        CHECK( bitmap_rank_rank2(&rank, 1001) == 1 );
+        CHECK( bitmap_rank_select3(&rank, 0, &index) == 0 );
+        CHECK( index == 1000 );
+        bitmap_rank_destroy1(&rank);
+    }
+
+    bitmap_simd_select1(BITMAP_SIMD__AUTO);
+#undef BITMAP_SIZE_BIG
+}
@@ -0,0 +1,286 @@
+/**
+ * @file test_bitmap_roaring.cpp
+ *
+ */
+
+#include <bitmap/bitmap.h>
+#include <bitmap/bitmap_roaring.h>
+
+#include <catch/catch.hpp>
+
+#define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
+
+/* the reference bitmap: chunks 0 .. 7 of the compressed bitmap */
+#define BITMAP_SIZE_REF (4096 * 8)
+
+/**
+ * @brief Fill both bitmaps by the pattern of the chunks: empty, sparse, runs, dense
+ */
+static void P_prepare_roaring(
+        bitmap_roaring_t * roaring,
+        bitmap_block_t * reference,
+        uint32_t seed
+)
+{
+    bitmap_bitwise_clear2(reference, BITMAP_SIZE_REF);
+    uint32_t ibit;
+    for(ibit = 0; ibit < BITMAP_SIZE_REF; ++ibit)
+    {
+        seed = seed * 1103515245 + 12345;
+        uint32_t random = seed >> 16;
+        bool raised;
+        switch((ibit / 4096 + seed / 0x40000000) % 4)
+        {
+            case 0 : raised = false; break;
+            case 1 : raised = (random % 64 == 0); break;
+            case 2 : raised = ((ibit / 200) % 2 == 0); break;
+            default: raised = (random % 3 != 0); break;
+        }
+        if(raised)
+        {
+            bitmap_bit_raise2(reference, ibit);
+            REQUIRE( bitmap_roaring_bit_raise2(roaring, ibit) == 0 );
+        }
+    }
+}
+
+/**
+ * @brief Fill both bitmaps by the chunks of the pattern (ichunk + shift) % 4: empty, sparse, runs, dense
+ */
+static void P_prepare_roaring_patterns(
+        bitmap_roaring_t * roaring,
+        bitmap_block_t * reference,
+        uint32_t shift,
+        uint32_t period
+)
+{
+    bitmap_bitwise_clear2(reference, BITMAP_SIZE_REF);
+    uint32_t seed = period;
+    uint32_t ibit;
+    for(ibit = 0; ibit < BITMAP_SIZE_REF; ++ibit)
+    {
+        seed = seed * 1103515245 + 12345;
+        uint32_t value = ibit % 4096;
+        bool raised;
+        switch((ibit / 4096 + shift) % 4)
+        {
+            case 0 : raised = false; break;
+            case 1 : raised = (value % period == 0 || value % period == 1); break;
+            case 2 : raised = ((value / period) % 3 != 1); break;
+            default: raised = ((seed >> 16) % 3 != 0); break;
+        }
+        if(raised)
+        {
+            bitmap_bit_raise2(reference, ibit);
+            REQUIRE( bitmap_roaring_bit_raise2(roaring, ibit) == 0 );
+        }
+    }
+    /* the runs */
+    REQUIRE( bitmap_roaring_optimize1(roaring) == 0 );
+}
+
+static void P_check_roaring(
+        const bitmap_roaring_t * roaring,
+        const bitmap_block_t * reference
+)
+{
+    CHECK( bitmap_roaring_power1(roaring) == bitmap_bitwise_power2(reference, BITMAP_SIZE_REF) );
+
+    bitmap_roaring_iterator_t iterator;
+    bitmap_iterator_t reference_iterator;
+    bitmap_iterator_init4(&reference_iterator, reference, BITMAP_SIZE_REF, 0);
+    uint32_t ibit;
+    size_t reference_ibit;
+    BITMAP_ROARING_FOREACH_BIT_IN_BITMAP(&ibit, roaring, &iterator)
+    {
+        REQUIRE( bitmap_iterator_next2(&reference_iterator, &reference_ibit) );
+        REQUIRE( ibit == reference_ibit );
+    }
+    CHECK( !bitmap_iterator_next2(&reference_iterator, &reference_ibit) );
+
+    for(ibit = 0; ibit < BITMAP_SIZE_REF; ibit += 13)
+    {
+        REQUIRE( bitmap_roaring_bit_get2(roaring, ibit) == bitmap_bit_get2(reference, ibit) );
+    }
+}
+
+TEST_CASE(
+        "bitmaps bitmap_roaring test",
+        "[bitmap][bitmap_roaring]"
+)
+{
+    static BITMAP_VAR(reference_a, BITMAP_SIZE_REF);
+    static BITMAP_VAR(reference_b, BITMAP_SIZE_REF);
+    static BITMAP_VAR(reference, BITMAP_SIZE_REF);
+
+    bitmap_roaring_t a;
+    bitmap_roaring_t b;
+    bitmap_roaring_t result;
+    bitmap_roaring_init1(&a);
+    bitmap_roaring_init1(&b);
+    bitmap_roaring_init1(&result);
+
+    P_prepare_roaring(&a, reference_a, 7);
+    P_prepare_roaring(&b, reference_b, 11);
+    P_check_roaring(&a, reference_a);
+    P_check_roaring(&b, reference_b);
+
+    size_t ipass;
+    for(ipass = 0; ipass < 2; ++ipass)
+    {
+        REQUIRE( bitmap_roaring_and3(&result, &a, &b) == 0 );
+        bitmap_bitwise_and4(reference, reference_a, reference_b, BITMAP_SIZE_REF);
+        P_check_roaring(&result, reference);
+
+        REQUIRE( bitmap_roaring_or3(&result, &a, &b) == 0 );
+        bitmap_bitwise_or4(reference, reference_a, reference_b, BITMAP_SIZE_REF);
+        P_check_roaring(&result, reference);
+
+        REQUIRE( bitmap_roaring_clear3(&result, &a, &b) == 0 );
+        bitmap_bitwise_clear4(reference, reference_a, reference_b, BITMAP_SIZE_REF);
+        P_check_roaring(&result, reference);
+
+        REQUIRE( bitmap_roaring_clear3(&result, &b, &a) == 0 );
+        bitmap_bitwise_clear4(reference, reference_b, reference_a, BITMAP_SIZE_REF);
+        P_check_roaring(&result, reference);
+
+        REQUIRE( bitmap_roaring_xor3(&result, &a, &b) == 0 );
+        size_t iblock;
+        for(iblock = 0; iblock < BITMAP_BITS_TO_BLOCKS_ALIGNED(BITMAP_SIZE_REF); ++iblock)
+        {
+            reference[iblock] = reference_a[iblock] ^ reference_b[iblock];
+        }
+        P_check_roaring(&result, reference);
+
+        /* the second pass: the runs */
+        REQUIRE( bitmap_roaring_optimize1(&a) == 0 );
+        REQUIRE( bitmap_roaring_optimize1(&b) == 0 );
+        P_check_roaring(&a, reference_a);
+        P_check_roaring(&b, reference_b);
+    }
+
+    /* the destination is the operand */
+    REQUIRE( bitmap_roaring_copy2(&result, &a) == 0 );
+    REQUIRE( bitmap_roaring_or3(&result, &result, &b) == 0 );
+    bitmap_bitwise_or4(reference, reference_a, reference_b, BITMAP_SIZE_REF);
+    P_check_roaring(&result, reference);
+
+    /* the changes of the run and dense chunks */
+    static const uint32_t indexes[] = { 0, 1, 4095, 4096, 4097, 8191, 8192, 8400, 8599, 12288, 12290, 20000, 32767 };
+    size_t i;
+    for(i = 0; i < ARRAY_SIZE(indexes); ++i)
+    {
+        REQUIRE( bitmap_roaring_bit_clear2(&a, indexes[i]) == 0 );
+        bitmap_bit_clear2(reference_a, indexes[i]);
+    }
+    P_check_roaring(&a, reference_a);
+    for(i = 0; i < ARRAY_SIZE(indexes); ++i)
+    {
+        REQUIRE( bitmap_roaring_bit_raise2(&a, indexes[i]) == 0 );
+        bitmap_bit_raise2(reference_a, indexes[i]);
+    }
+    P_check_roaring(&a, reference_a);
+
+    /* the whole chunk is cleared */
+    uint32_t ibit;
+    for(ibit = 4096; ibit < 8192; ++ibit)
+    {
+        REQUIRE( bitmap_roaring_bit_clear2(&a, ibit) == 0 );
+        bitmap_bit_clear2(reference_a, ibit);
+    }
+    P_check_roaring(&a, reference_a);
+
+    /* the far index */
+    REQUIRE( bitmap_roaring_bit_raise2(&a, UINT32_MAX) == 0 );
+    CHECK( bitmap_roaring_bit_get2(&a, UINT32_MAX) );
+    CHECK( bitmap_roaring_power1(&a) == bitmap_bitwise_power2(reference_a, BITMAP_SIZE_REF) + 1 );
+
+    bitmap_roaring_destroy1(&a);
+    bitmap_roaring_destroy1(&b);
+    bitmap_roaring_destroy1(&result);
+    CHECK( bitmap_roaring_power1(&a) == 0 );
+}
+
+TEST_CASE(
+        "bitmaps bitmap_roaring runs test",
+        "[bitmap][bitmap_roaring]"
+)
+{
+    static BITMAP_VAR(reference_a, BITMAP_SIZE_REF);
+    static BITMAP_VAR(reference_b, BITMAP_SIZE_REF);
+    static BITMAP_VAR(reference, BITMAP_SIZE_REF);
+
+    bitmap_roaring_t a;
+    bitmap_roaring_t b;
+    bitmap_roaring_t result;
+    bitmap_roaring_init1(&a);
+    bitmap_roaring_init1(&b);
+    bitmap_roaring_init1(&result);
+
+    /* each pair of the containers: the array, the runs and the dense chunks */
+    uint32_t shift;
+    for(shift = 0; shift < 4; ++shift)
+    {
+        P_prepare_roaring_patterns(&a, reference_a, 0, 37);
+        P_prepare_roaring_patterns(&b, reference_b, shift, 53);
+        P_check_roaring(&a, reference_a);
+        P_check_roaring(&b, reference_b);
+
+        REQUIRE( bitmap_roaring_and3(&result, &a, &b) == 0 );
+        bitmap_bitwise_and4(reference, reference_a, reference_b, BITMAP_SIZE_REF);
+        P_check_roaring(&result, reference);
+
+        REQUIRE( bitmap_roaring_or3(&result, &a, &b) == 0 );
+        bitmap_bitwise_or4(reference, reference_a, reference_b, BITMAP_SIZE_REF);
+        P_check_roaring(&result, reference);
+
+        REQUIRE( bitmap_roaring_clear3(&result, &a, &b) == 0 );
+        bitmap_bitwise_clear4(reference, reference_a, reference_b, BITMAP_SIZE_REF);
+        P_check_roaring(&result, reference);
+
+        REQUIRE( bitmap_roaring_clear3(&result, &b, &a) == 0 );
+        bitmap_bitwise_clear4(reference, reference_b, reference_a, BITMAP_SIZE_REF);
+        P_check_roaring(&result, reference);
+
+        REQUIRE( bitmap_roaring_xor3(&result, &a, &b) == 0 );
+        size_t iblock;
+        for(iblock = 0; iblock < BITMAP_BITS_TO_BLOCKS_ALIGNED(BITMAP_SIZE_REF); ++iblock)
+        {
+            reference[iblock] = reference_a[iblock] ^ reference_b[iblock];
+        }
+        P_check_roaring(&result, reference);
+
+        /* the same runs */
+        REQUIRE( bitmap_roaring_xor3(&result, &a, &a) == 0 );
+        CHECK( bitmap_roaring_power1(&result) == 0 );
+        REQUIRE( bitmap_roaring_and3(&result, &a, &a) == 0 );
+        P_check_roaring(&result, reference_a);
+
+        /* the raise into the run chunk: extend, insert, join, then too many runs */
+        static const uint32_t indexes[] = { 37, 73, 50, 52, 51, 4095 };
+        size_t i;
+        for(i = 0; i < ARRAY_SIZE(indexes); ++i)
+        {
+            REQUIRE( bitmap_roaring_bit_raise2(&a, 4096 * 2 + indexes[i]) == 0 );
+            bitmap_bit_raise2(reference_a, 4096 * 2 + indexes[i]);
+            P_check_roaring(&a, reference_a);
+        }
+        uint32_t ibit;
+        for(ibit = 4096 * 2 + 38; ibit < 4096 * 2 + 73; ++ibit)
+        {
+            REQUIRE( bitmap_roaring_bit_raise2(&a, ibit) == 0 );
+            bitmap_bit_raise2(reference_a, ibit);
+        }
+        P_check_roaring(&a, reference_a);
+        for(ibit = 4096 * 6; ibit < 4096 * 7; ibit += 3)
+        {
+            REQUIRE( bitmap_roaring_bit_raise2(&a, ibit) == 0 );
+            bitmap_bit_raise2(reference_a, ibit);
+        }
+        P_check_roaring(&a, reference_a);
+
+        bitmap_roaring_destroy1(&a);
+        bitmap_roaring_destroy1(&b);
+    }
+    bitmap_roaring_destroy1(&result);
+}
@@ -0,0 +1,130 @@
+/**
+ * @file test_bitmap_serialize.cpp
+ *
+ */
+
+#include <bitmap/bitmap.h>
+#include <bitmap/bitmap_serialize.h>
+
+#include <catch/catch.hpp>
+
+#include <string.h>
+
+#define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
+
+#define BITMAP_SIZE_BIG (64 * 1000 + 13)
+
+TEST_CASE(
+        "bitmaps bitmap_serialize test",
+        "[bitmap][bitmap_serialize]"
+)
+{
+    static const size_t sizes[] = { 0, 1, 63, 64, 65, 64 * 64, 64 * 64 + 1, BITMAP_SIZE_BIG };
+    static const enum bitmap_serialize_format formats[] =
+    {
+            BITMAP_SERIALIZE_FORMAT__DENSE,
+            BITMAP_SERIALIZE_FORMAT__SPARSE,
+    };
+    static BITMAP_VAR(bitmap, BITMAP_SIZE_BIG);
+    static BITMAP_VAR(result, BITMAP_SIZE_BIG);
+    /* 8 bytes more to shift the buffer */
+    static bitmap_block_t buffer[BITMAP_BITS_TO_BLOCKS_ALIGNED(BITMAP_SIZE_BIG) * 2 + 16];
+    static uint8_t * const buf = (uint8_t *)buffer;
+    const size_t buf_size = sizeof(buffer) - 8;
+
+    size_t isize;
+    for(isize = 0; isize < ARRAY_SIZE(sizes); ++isize)
+    {
+        size_t bits_num = sizes[isize];
+        size_t ibit;
+
+        /* sparse bits and the trashed tail */
+        bitmap_bitwise_raise1(bitmap, BITMAP_SIZE_BIG);
+        bitmap_bitwise_clear2(bitmap, bits_num);
+        for(ibit = 3; ibit < bits_num; ibit += 977)
+        {
+            bitmap_bit_raise2(bitmap, ibit);
+        }
+
+        size_t iformat;
+        for(iformat = 0; iformat < ARRAY_SIZE(formats); ++iformat)
+        {
+            enum bitmap_serialize_format format = formats[iformat];
+            size_t size = bitmap_serialize5(NULL, 0, bitmap, bits_num, format);
+            CHECK( size >= BITMAP_SERIALIZE_HEADER_SIZE );
+            CHECK( bitmap_serialize5(buf, size - 1, bitmap, bits_num, format) == size );
+
+            size_t offset;
+            for(offset = 0; offset < 8; offset += 3)
+            {
+                uint8_t * src = &buf[offset];
+                REQUIRE( bitmap_serialize5(src, buf_size, bitmap, bits_num, format) == size );
+
+                size_t bits_num_read;
+                size_t size_read;
+                REQUIRE( bitmap_deserialize_info4(src, size, &bits_num_read, &size_read) == 0 );
+                CHECK( bits_num_read == bits_num );
+                CHECK( size_read == size );
+
+                bitmap_bitwise_raise1(result, BITMAP_SIZE_BIG);
+                REQUIRE( bitmap_deserialize4(result, BITMAP_SIZE_BIG, src, size) == 0 );
+                CHECK( bitmap_bitwise_check_equal3(result, bitmap, bits_num) );
+                CHECK( bitmap_bitwise_power2(result, BITMAP_BITS_TO_BLOCKS_ALIGNED(bits_num) * BITMAP_BITS_IN_BLOCK()) == bitmap_bitwise_power2(bitmap, bits_num) );
+
+                const bitmap_block_t * view = NULL;
+                int ret = bitmap_deserialize_view4(&view, &bits_num_read, src, size);
+                if(format == BITMAP_SERIALIZE_FORMAT__DENSE && offset == 0)
+                {
+                    REQUIRE( ret == 0 );
+                    CHECK( bits_num_read == bits_num );
+                    CHECK( (const uint8_t *)view == &src[BITMAP_SERIALIZE_HEADER_SIZE] );
+                    CHECK( bitmap_bitwise_check_equal3(view, bitmap, bits_num) );
+                }
+                else
+                {
+                    CHECK( ret == -1 );
+                }
+
+                /* incomplete, damaged, too small destination */
+                CHECK( bitmap_deserialize4(result, BITMAP_SIZE_BIG, src, size - 1) == -1 );
+                if(bits_num > 0)
+                {
+                    CHECK( bitmap_deserialize4(result, bits_num - 1, src, size) == -1 );
+                    src[size - 1] ^= 0x01;
+                    CHECK( bitmap_deserialize4(result, BITMAP_SIZE_BIG, src, size) == -1 );
+                    src[size - 1] ^= 0x01;
+                }
+                src[0] = 'X';
+                CHECK( bitmap_deserialize_info4(src, size, &bits_num_read, &size_read) == -1 );
+            }
+        }
+
+        /* the sparse format skips the zero words */
+        size_t dense = bitmap_serialize5(NULL, 0, bitmap, bits_num, BITMAP_SERIALIZE_FORMAT__DENSE);
+        size_t sparse = bitmap_serialize5(NULL, 0, bitmap, bits_num, BITMAP_SERIALIZE_FORMAT__SPARSE);
+        if(bits_num > 64 * 64)
+        {
+            CHECK( sparse < dense / 4 );
+        }
+    }
+
+    /* the layout does not depend on the host */
+    bitmap_bitwise_clear2(bitmap, 80);
+    bitmap_bit_raise2(bitmap, 0);
+    bitmap_bit_raise2(bitmap, 9);
+    bitmap_bit_raise2(bitmap, 79);
+    REQUIRE( bitmap_serialize5(buf, buf_size, bitmap, 80, BITMAP_SERIALIZE_FORMAT__DENSE) == BITMAP_SERIALIZE_HEADER_SIZE + 16 );
+    static const uint8_t expected[BITMAP_SERIALIZE_HEADER_SIZE - 8 + 16] =
+    {
+            'B', 'M', 'A', 'P', 1, 0, 0, 0,
+            80, 0, 0, 0, 0, 0, 0, 0,
+            2, 0, 0, 0, 0, 0, 0, 0,
+            /* CRC32C, zero */
+            0x01, 0x02, 0, 0, 0, 0, 0, 0,
+            0, 0x80, 0, 0, 0, 0, 0, 0,
+    };
+    CHECK( memcmp(buf, expected, 24) == 0 );
+    CHECK( memcmp(&buf[BITMAP_SERIALIZE_HEADER_SIZE], &expected[24], 16) == 0 );
+}
+
+#undef BITMAP_SIZE_BIG